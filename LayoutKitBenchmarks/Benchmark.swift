@@ -0,0 +1,150 @@
+// Copyright 2019 LinkedIn Corp.
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+
+import Foundation
+import LayoutKit
+#if os(Linux)
+import Glibc
+#else
+import Darwin
+#endif
+
+/// The results of one suite at one width and depth.
+struct BenchmarkResult: Codable {
+
+    let suite: String
+    let width: Double
+    let depth: Int
+
+    /// The number of sublayouts of the container that the suite lays out, for suites that vary it.
+    let children: Int?
+
+    let operations: Int
+
+    /// Latencies of a single operation, in microseconds.
+    let medianMicroseconds: Double
+    let p95Microseconds: Double
+    let p99Microseconds: Double
+    let meanMicroseconds: Double
+    let operationsPerSecond: Double
+
+    /// The number of scratch buffers that layout passes had to allocate, per operation (see `LayoutScratchBufferPool`).
+    let scratchBufferAllocationsPerOperation: Double
+
+    /// The growth of the heap over the timed operations, per operation.
+    /// It only counts memory that was still allocated when the suite ended (e.g. cached measurements), not temporary allocations.
+    let retainedHeapBytesPerOperation: Double
+
+    /// The peak resident memory of the process when the suite ended.
+    let peakResidentBytes: Int
+}
+
+/// Runs an operation over each item of a fixture and collects the latency of every call.
+struct Benchmark {
+
+    let suite: String
+    let width: CGFloat
+    let depth: Int
+    let children: Int?
+    let rounds: Int
+
+    init(suite: String, width: CGFloat, depth: Int = 0, children: Int? = nil, rounds: Int) {
+        self.suite = suite
+        self.width = width
+        self.depth = depth
+        self.children = children
+        self.rounds = rounds
+    }
+
+    /**
+     Calls `operation` for each index in `0..<count`, `rounds` times, after an untimed warm up round.
+     The value that `operation` returns is kept alive until the call has been timed, so releasing it isn't measured.
+     */
+    func run<Result>(count: Int, operation: (Int) -> Result) -> BenchmarkResult {
+        for index in 0..<count {
+            blackHole(operation(index))
+        }
+
+        var samples = [UInt64]()
+        samples.reserveCapacity(count * rounds)
+        let pool = LayoutScratchBufferPool.current
+        pool.resetCounters()
+        let heapBytesBefore = heapBytesInUse()
+
+        for _ in 0..<rounds {
+            for index in 0..<count {
+                let start = DispatchTime.now().uptimeNanoseconds
+                let result = operation(index)
+                let end = DispatchTime.now().uptimeNanoseconds
+                blackHole(result)
+                samples.append(end - start)
+            }
+        }
+
+        let operations = Double(samples.count)
+        let heapGrowth = heapBytesInUse() - heapBytesBefore
+        samples.sort()
+        let totalNanoseconds = samples.reduce(0, +)
+        return BenchmarkResult(
+            suite: suite,
+            width: Double(width),
+            depth: depth,
+            children: children,
+            operations: samples.count,
+            medianMicroseconds: Benchmark.microseconds(Benchmark.percentile(0.5, of: samples)),
+            p95Microseconds: Benchmark.microseconds(Benchmark.percentile(0.95, of: samples)),
+            p99Microseconds: Benchmark.microseconds(Benchmark.percentile(0.99, of: samples)),
+            meanMicroseconds: Benchmark.microseconds(totalNanoseconds) / operations,
+            operationsPerSecond: operations / (Double(totalNanoseconds) / 1e9),
+            scratchBufferAllocationsPerOperation: Double(pool.allocationCount) / operations,
+            retainedHeapBytesPerOperation: Double(max(heapGrowth, 0)) / operations,
+            peakResidentBytes: peakResidentBytes())
+    }
+
+    /// The nearest-rank percentile of sorted samples.
+    private static func percentile(_ fraction: Double, of sortedSamples: [UInt64]) -> UInt64 {
+        guard !sortedSamples.isEmpty else {
+            return 0
+        }
+        let rank = Int((fraction * Double(sortedSamples.count)).rounded(.up))
+        return sortedSamples[min(max(rank - 1, 0), sortedSamples.count - 1)]
+    }
+
+    private static func microseconds(_ nanoseconds: UInt64) -> Double {
+        return Double(nanoseconds) / 1000
+    }
+}
+
+/// Keeps the optimizer from removing work whose result is unused.
+@inline(never)
+func blackHole<T>(_ value: T) {
+    withExtendedLifetime(value) {}
+}
+
+/// The number of bytes that are currently allocated on the heap.
+func heapBytesInUse() -> Int {
+    #if os(Linux)
+        return Int(mallinfo().uordblks)
+    #else
+        var statistics = malloc_statistics_t()
+        malloc_zone_statistics(nil, &statistics)
+        return Int(statistics.size_in_use)
+    #endif
+}
+
+/// The peak resident memory of the process, in bytes.
+func peakResidentBytes() -> Int {
+    var usage = rusage()
+    getrusage(RUSAGE_SELF, &usage)
+    #if os(Linux)
+        // Linux reports kilobytes.
+        return Int(usage.ru_maxrss) * 1024
+    #else
+        return Int(usage.ru_maxrss)
+    #endif
+}
@@ -0,0 +1,156 @@
+// Copyright 2019 LinkedIn Corp.
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+
+import Foundation
+import LayoutKit
+
+/// The data of a feed item. The same fields as `FeedItemData` in the sample app.
+struct FeedItemFixture: Codable {
+
+    let actionText: String
+    let posterName: String
+    let posterHeadline: String
+    let posterTimestamp: String
+    let posterComment: String
+    let contentTitle: String
+    let contentDomain: String
+    let actorComment: String
+
+    /// Generates the same items as `FeedItemData.generate(count:)`, so results are reproducible.
+    static func generate(count: Int) -> [FeedItemFixture] {
+        return (0..<count).map { i in
+            return FeedItemFixture(
+                actionText: "action text \(i)",
+                posterName: "poster name \(i)",
+                posterHeadline: "poster title \(i) with some longer stuff",
+                posterTimestamp: "poster timestamp \(i)",
+                posterComment: "poster comment \(i)",
+                contentTitle: "content title \(i)",
+                contentDomain: "content domain \(i)",
+                actorComment: "actor comment \(i)"
+            )
+        }
+    }
+
+    /// Loads items from a JSON array of objects with the same fields.
+    static func load(from url: URL) throws -> [FeedItemFixture] {
+        return try JSONDecoder().decode([FeedItemFixture].self, from: Data(contentsOf: url))
+    }
+}
+
+/**
+ Measures text with fixed glyph metrics and wraps it at word boundaries.
+ It doesn't depend on a text engine, so measurements are identical on every platform.
+ */
+struct FixtureTextMeasurer: TextMeasuring {
+
+    /// The width of a character as a fraction of the font size.
+    private static let advance: CGFloat = 0.55
+
+    /// The height of a line as a fraction of the font size.
+    private static let lineHeight: CGFloat = 1.2
+
+    func size(of text: String, font: CGFloat, within maxSize: CGSize) -> CGSize {
+        let characterWidth = font * FixtureTextMeasurer.advance
+        var lineCount = 1
+        var lineWidth: CGFloat = 0
+        var maxLineWidth: CGFloat = 0
+        for word in text.split(separator: " ") {
+            let wordWidth = CGFloat(word.count) * characterWidth
+            let spacedWidth = lineWidth == 0 ? wordWidth : lineWidth + characterWidth + wordWidth
+            if spacedWidth > maxSize.width && lineWidth > 0 {
+                lineCount += 1
+                lineWidth = wordWidth
+            } else {
+                lineWidth = spacedWidth
+            }
+            maxLineWidth = max(maxLineWidth, min(lineWidth, maxSize.width))
+        }
+        return CGSize(width: maxLineWidth, height: CGFloat(lineCount) * font * FixtureTextMeasurer.lineHeight)
+    }
+}
+
+/// Builds layouts with the same structure as `FeedItemLayout` in ExampleLayouts out of core layouts.
+enum FeedLayoutFactory {
+
+    private typealias Label = TextLayout<FixtureTextMeasurer, View>
+
+    private static let measurer = FixtureTextMeasurer()
+    private static let fontSize: CGFloat = 17
+
+    /**
+     Returns the layout of a feed item.
+     - parameter depth: The number of stacks that the feed item is nested in (e.g. by the layouts of a screen).
+     */
+    static func layout(for item: FeedItemFixture, depth: Int) -> Layout {
+        var layout: Layout = feedItemLayout(for: item)
+        for level in 0..<depth {
+            let axis: Axis = level % 2 == 0 ? .vertical : .horizontal
+            layout = StackLayout<View>(axis: axis, spacing: 1, sublayouts: [
+                SizeLayout<View>(width: 1, height: 1),
+                layout
+            ])
+        }
+        return layout
+    }
+
+    private static func label(_ text: String, alignment: Alignment = .topLeading, flexibility: Flexibility = .flexible) -> Label {
+        return Label(text: text, font: fontSize, measurer: measurer, alignment: alignment, flexibility: flexibility)
+    }
+
+    private static func feedItemLayout(for item: FeedItemFixture) -> Layout {
+        let actionStack = StackLayout<View>(axis: .horizontal, sublayouts: [
+            label(item.actionText),
+            label("...", alignment: .topTrailing, flexibility: .inflexible)
+        ])
+
+        let socialActions = StackLayout<View>(axis: .horizontal, distribution: .fillEqualSize, sublayouts: [
+            label("Like", alignment: .centerLeading),
+            label("Comment", alignment: .center),
+            label("Share", alignment: .centerTrailing)
+        ])
+
+        let actorComment = StackLayout<View>(axis: .horizontal, sublayouts: [
+            SizeLayout<View>(width: 50, height: 50),
+            label(item.actorComment, alignment: .centerLeading)
+        ])
+
+        let content = StackLayout<View>(axis: .vertical, sublayouts: [
+            SizeLayout<View>(size: CGSize(width: 350, height: 200), alignment: Alignment(vertical: .top, horizontal: .fill)),
+            label(item.contentTitle),
+            label(item.contentDomain)
+        ])
+
+        let feedItem = StackLayout<View>(axis: .vertical, spacing: 4, sublayouts: [
+            actionStack,
+            profileCardLayout(for: item),
+            label(item.posterComment),
+            content,
+            socialActions,
+            actorComment
+        ])
+        return InsetLayout<View>(insets: EdgeInsets(top: 8, left: 8, bottom: 8, right: 8), sublayout: feedItem)
+    }
+
+    private static func profileCardLayout(for item: FeedItemFixture) -> Layout {
+        let nameAndConnectionDegree = StackLayout<View>(axis: .horizontal, spacing: 4, sublayouts: [
+            label(item.posterName),
+            label("2nd")
+        ])
+        let labels = StackLayout<View>(
+            axis: .vertical,
+            spacing: 2,
+            alignment: Alignment(vertical: .center, horizontal: .leading),
+            sublayouts: [nameAndConnectionDegree, label(item.posterHeadline), label(item.posterTimestamp)]
+        )
+        return StackLayout<View>(axis: .horizontal, spacing: 4, sublayouts: [
+            SizeLayout<View>(size: CGSize(width: 50, height: 50)),
+            labels
+        ])
+    }
+}
@@ -0,0 +1,49 @@
+// Copyright 2019 LinkedIn Corp.
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+
+import Foundation
+import LayoutKit
+
+/// Builds a tag cloud as a `FlowLayout` and as the equivalent vertical stack of horizontal stacks.
+enum FlowLayoutFactory {
+
+    private static let spacing: CGFloat = 8
+
+    /// The sizes of `count` tags of varying widths. They are the same on every run.
+    static func tagSizes(count: Int) -> [CGSize] {
+        return (0..<count).map { i in
+            return CGSize(width: CGFloat(24 + (i * 37) % 60), height: 28)
+        }
+    }
+
+    static func flow(tagSizes: [CGSize]) -> Layout {
+        return FlowLayout<View>(spacing: spacing, lineSpacing: spacing, sublayouts: tagSizes.map { SizeLayout<View>(size: $0) })
+    }
+
+    /// Packs the tags into rows at `width` in advance, like an app has to do when it builds the rows out of stacks.
+    static func nestedStacks(tagSizes: [CGSize], width: CGFloat) -> Layout {
+        var rows = [Layout]()
+        var row = [Layout]()
+        var rowWidth: CGFloat = 0
+        for size in tagSizes {
+            if !row.isEmpty && rowWidth + spacing + size.width > width {
+                rows.append(StackLayout<View>(axis: .horizontal, spacing: spacing, distribution: .leading, sublayouts: row))
+                row = []
+                rowWidth = 0
+            } else if !row.isEmpty {
+                rowWidth += spacing
+            }
+            rowWidth += size.width
+            row.append(SizeLayout<View>(size: size))
+        }
+        if !row.isEmpty {
+            rows.append(StackLayout<View>(axis: .horizontal, spacing: spacing, distribution: .leading, sublayouts: row))
+        }
+        return StackLayout<View>(axis: .vertical, spacing: spacing, distribution: .leading, sublayouts: rows)
+    }
+}
@@ -0,0 +1,168 @@
+// Copyright 2019 LinkedIn Corp.
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+
+/*
+ Benchmarks the layout engine without views, so it runs on macOS and Linux:
+
+     swift run -c release LayoutKitBenchmarks [options]
+
+ Options:
+     --widths 320,375,414   The widths to lay out the feed at.
+     --depths 0,4,16        The number of stacks that each feed item is nested in.
+     --items 500            The number of feed items (like `FeedItemData.generate(count:)`).
+     --fixture path.json    Load feed items from a JSON file instead of generating them.
+     --rounds 5             The number of timed passes over the feed items.
+     --output path.json     Write the report to a file instead of standard output.
+     --flow-children 100,1000,10000
+                            The numbers of tags in the flow layout suites.
+
+ Each width and depth is measured by three suites:
+     measurement   `Layout.measurement(within:)` of a layout that was built in advance.
+     arrangement   `LayoutMeasurement.arrangement(within:)` of a measurement that was computed in advance.
+     endToEnd      Building the layout and calling `arrangement(width:)`, like a reload does for each item.
+
+ Each width and number of tags is measured by two more suites, which lay out a whole tag cloud per operation:
+     flow          `arrangement(width:)` of a `FlowLayout` of the tags.
+     nestedStacks  `arrangement(width:)` of a vertical stack of horizontal stacks that were packed with the same rows.
+
+ The report is JSON, so results of different versions can be compared by a script.
+ */
+
+import Foundation
+import LayoutKit
+
+/// The JSON report.
+struct BenchmarkReport: Codable {
+    let items: Int
+    let rounds: Int
+    let results: [BenchmarkResult]
+}
+
+struct Options {
+    var widths: [CGFloat] = [320, 375, 414]
+    var depths = [0, 4, 16]
+    var itemCount = 500
+    var fixturePath: String?
+    var rounds = 5
+    var outputPath: String?
+    var flowChildCounts = [100, 1000, 10_000]
+
+    init(arguments: [String]) {
+        var iterator = arguments.makeIterator()
+        while let argument = iterator.next() {
+            guard let value = iterator.next() else {
+                Options.fail("missing value for \(argument)")
+            }
+            switch argument {
+            case "--widths":
+                widths = Options.list(value).map { CGFloat($0) }
+            case "--depths":
+                depths = Options.list(value).map { Int($0) }
+            case "--items":
+                itemCount = Options.number(value)
+            case "--fixture":
+                fixturePath = value
+            case "--rounds":
+                rounds = Options.number(value)
+            case "--output":
+                outputPath = value
+            case "--flow-children":
+                flowChildCounts = Options.list(value).map { Int($0) }
+            default:
+                Options.fail("unknown option \(argument)")
+            }
+        }
+    }
+
+    private static func list(_ value: String) -> [Double] {
+        return value.split(separator: ",").map { element in
+            guard let number = Double(element), number >= 0 else {
+                fail("expected a list of non-negative numbers instead of \(value)")
+            }
+            return number
+        }
+    }
+
+    private static func number(_ value: String) -> Int {
+        guard let number = Int(value), number >= 0 else {
+            fail("expected a non-negative number instead of \(value)")
+        }
+        return number
+    }
+
+    static func fail(_ message: String) -> Never {
+        FileHandle.standardError.write("LayoutKitBenchmarks: \(message)\n".data(using: .utf8)!)
+        exit(1)
+    }
+}
+
+let options = Options(arguments: Array(CommandLine.arguments.dropFirst()))
+
+let items: [FeedItemFixture]
+if let fixturePath = options.fixturePath {
+    do {
+        items = try FeedItemFixture.load(from: URL(fileURLWithPath: fixturePath))
+    } catch {
+        Options.fail("could not load \(fixturePath): \(error)")
+    }
+} else {
+    items = FeedItemFixture.generate(count: options.itemCount)
+}
+
+var results = [BenchmarkResult]()
+for depth in options.depths {
+    let layouts = items.map { FeedLayoutFactory.layout(for: $0, depth: depth) }
+    for width in options.widths {
+        let maxSize = CGSize(width: width, height: .greatestFiniteMagnitude)
+
+        results.append(Benchmark(suite: "measurement", width: width, depth: depth, rounds: options.rounds).run(count: layouts.count) { index in
+            return layouts[index].measurement(within: maxSize)
+        })
+
+        let measurements = layouts.map { $0.measurement(within: maxSize) }
+        results.append(Benchmark(suite: "arrangement", width: width, depth: depth, rounds: options.rounds).run(count: measurements.count) { index in
+            // The same rect as `arrangement(width:)`.
+            let measurement = measurements[index]
+            return measurement.arrangement(within: CGRect(x: 0, y: 0, width: width, height: measurement.size.height))
+        })
+
+        results.append(Benchmark(suite: "endToEnd", width: width, depth: depth, rounds: options.rounds).run(count: items.count) { index in
+            return FeedLayoutFactory.layout(for: items[index], depth: depth).arrangement(width: width)
+        })
+    }
+}
+
+for childCount in options.flowChildCounts {
+    let tagSizes = FlowLayoutFactory.tagSizes(count: childCount)
+    for width in options.widths {
+        let flow = FlowLayoutFactory.flow(tagSizes: tagSizes)
+        results.append(Benchmark(suite: "flow", width: width, children: childCount, rounds: options.rounds).run(count: 1) { _ in
+            return flow.arrangement(width: width)
+        })
+
+        let nestedStacks = FlowLayoutFactory.nestedStacks(tagSizes: tagSizes, width: width)
+        results.append(Benchmark(suite: "nestedStacks", width: width, children: childCount, rounds: options.rounds).run(count: 1) { _ in
+            return nestedStacks.arrangement(width: width)
+        })
+    }
+}
+
+let encoder = JSONEncoder()
+encoder.outputFormatting = [.prettyPrinted, .sortedKeys]
+let report = BenchmarkReport(items: items.count, rounds: options.rounds, results: results)
+do {
+    let data = try encoder.encode(report)
+    if let outputPath = options.outputPath {
+        try data.write(to: URL(fileURLWithPath: outputPath))
+    } else {
+        FileHandle.standardOutput.write(data)
+        FileHandle.standardOutput.write("\n".data(using: .utf8)!)
+    }
+} catch {
+    Options.fail("could not write the report: \(error)")
+}
@@ -0,0 +1,48 @@
+// Copyright 2019 LinkedIn Corp.
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+
+import UIKit
+import LayoutKit
+
+/// Measures the memory and view application time of the arrangements of feed items.
+class ArrangementBenchmark {
+
+    private let itemCount = 2000
+    private let width: CGFloat = 375
+
+    func run() {
+        let arrangements = FeedItemData.generate(count: itemCount).map {
+            ReloadBenchmark.feedItemLayout(for: $0).arrangement(width: width)
+        }
+
+        let treeBytes = arrangements.reduce(0) { $0 + ArrangementBenchmark.approximateBytes(of: $1) }
+        NSLog("Benchmark\t\(treeBytes / itemCount)\tbytes/item\tLayoutArrangement")
+
+        let rootView = UIView(frame: CGRect(x: 0, y: 0, width: width, height: 667))
+        var index = 0
+        Stopwatch.benchmark("makeViews\tLayoutArrangement", block: { (stopwatch: Stopwatch) -> Void in
+            let arrangement = arrangements[index % arrangements.count]
+            index += 1
+            stopwatch.resume()
+            arrangement.makeViews(in: rootView)
+            stopwatch.pause()
+        })
+    }
+
+    /// The size of an array's heap buffer, approximately.
+    private static func approximateBytes<T>(ofArrayOf type: T.Type, count: Int) -> Int {
+        // Empty arrays share a single static buffer.
+        return count == 0 ? 0 : 32 + count * MemoryLayout<T>.stride
+    }
+
+    private static func approximateBytes(of arrangement: LayoutArrangement) -> Int {
+        return arrangement.sublayouts.reduce(approximateBytes(ofArrayOf: LayoutArrangement.self, count: arrangement.sublayouts.count)) {
+            $0 + approximateBytes(of: $1)
+        }
+    }
+}
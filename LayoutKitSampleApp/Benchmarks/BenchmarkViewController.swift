@@ -73,6 +73,33 @@ class BenchmarkViewController: UITableViewController {
     override func viewDidLoad() {
         super.viewDidLoad()
         tableView.register(UITableViewCell.self, forCellReuseIdentifier: reuseIdentifier)
+        navigationItem.rightBarButtonItems = [
+            UIBarButtonItem(title: "Reload", style: .plain, target: self, action: #selector(benchmarkReload)),
+            UIBarButtonItem(title: "Arrangement", style: .plain, target: self, action: #selector(benchmarkArrangement)),
+            UIBarButtonItem(title: "Stacks", style: .plain, target: self, action: #selector(benchmarkNestedStacks)),
+            UIBarButtonItem(title: "Text", style: .plain, target: self, action: #selector(benchmarkTextMeasurement)),
+            UIBarButtonItem(title: "Bridge", style: .plain, target: self, action: #selector(benchmarkObjCBridge))
+        ]
+    }
+
+    @objc private func benchmarkReload() {
+        ReloadBenchmark().run()
+    }
+
+    @objc private func benchmarkArrangement() {
+        ArrangementBenchmark().run()
+    }
+
+    @objc private func benchmarkNestedStacks() {
+        NestedStackBenchmark().run()
+    }
+
+    @objc private func benchmarkTextMeasurement() {
+        TextMeasurementBenchmark().run()
+    }
+
+    @objc private func benchmarkObjCBridge() {
+        ObjCBridgeBenchmark().run()
     }
 
     override func tableView(_ tableView: UITableView, numberOfRowsInSection section: Int) -> Int {
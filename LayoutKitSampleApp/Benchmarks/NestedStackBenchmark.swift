@@ -0,0 +1,45 @@
+// Copyright 2019 LinkedIn Corp.
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+
+import UIKit
+import LayoutKit
+
+/// Benchmarks measuring and arranging deeply nested stacks with different mixes of sublayout flexibility.
+class NestedStackBenchmark {
+
+    private let depth = 6
+    private let fanOut = 4
+    private let width: CGFloat = 375
+
+    func run() {
+        benchmark("inflexible", flexibility: { _ in .inflexible })
+        benchmark("single flexible", flexibility: { $0 == 1 ? .flexible : .inflexible })
+        benchmark("mixed flexible", flexibility: { [.low, .high, .flexible, .inflexible][$0 % 4] })
+    }
+
+    private func benchmark(_ description: String, flexibility: @escaping (Int) -> Flexibility) {
+        Stopwatch.benchmark("nested stacks\t\(description)", block: { (stopwatch: Stopwatch) -> Void in
+            // A new tree on each iteration so that no measurements are cached.
+            let layout = self.makeStack(depth: self.depth, axis: .vertical, flexibility: flexibility)
+            stopwatch.resume()
+            _ = layout.arrangement(width: self.width)
+            stopwatch.pause()
+        })
+    }
+
+    private func makeStack(depth: Int, axis: Axis, flexibility: (Int) -> Flexibility) -> Layout {
+        let sublayouts: [Layout] = (0..<fanOut).map { index in
+            if depth == 0 {
+                return SizeLayout<View>(minWidth: 4, minHeight: 4, flexibility: flexibility(index))
+            }
+            let crossAxis: Axis = axis == .vertical ? .horizontal : .vertical
+            return makeStack(depth: depth - 1, axis: crossAxis, flexibility: flexibility)
+        }
+        return StackLayout(axis: axis, spacing: 1, flexibility: flexibility(0), sublayouts: sublayouts)
+    }
+}
@@ -0,0 +1,87 @@
+// Copyright 2019 LinkedIn Corp.
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+
+import UIKit
+import LayoutKit
+
+/// Compares arranging the same tree of nested stacks from Swift and through the Objective-C bridge.
+class ObjCBridgeBenchmark {
+
+    private let depth = 4
+    private let fanOut = 4
+    private let width: CGFloat = 375
+
+    func run() {
+        let layout = makeStack(depth: depth, axis: .vertical)
+        Stopwatch.benchmark("bridge\tswift", block: { (stopwatch: Stopwatch) -> Void in
+            stopwatch.resume()
+            _ = self.frameCount(of: layout.arrangement(width: self.width))
+            stopwatch.pause()
+        })
+
+        let objCLayout = makeObjCStack(depth: depth, axis: .vertical, subclassesLeaves: false)
+        benchmark("objc", layout: objCLayout, visitsSublayouts: false)
+        benchmark("objc visiting sublayouts", layout: objCLayout, visitsSublayouts: true)
+
+        // Leaves that subclass a LayoutKit layout are called through the bridge by the Swift stacks that contain them.
+        let subclassedLayout = makeObjCStack(depth: depth, axis: .vertical, subclassesLeaves: true)
+        benchmark("objc subclassed leaves", layout: subclassedLayout, visitsSublayouts: false)
+    }
+
+    private func benchmark(_ description: String, layout: LOKLayout, visitsSublayouts: Bool) {
+        Stopwatch.benchmark("bridge\t\(description)", block: { (stopwatch: Stopwatch) -> Void in
+            stopwatch.resume()
+            let arrangement = LOKLayoutArrangement.arrangeLayout(layout, width: self.width, height: .infinity)
+            if visitsSublayouts {
+                _ = self.frameCount(of: arrangement)
+            }
+            stopwatch.pause()
+        })
+    }
+
+    private func frameCount(of arrangement: LayoutArrangement) -> Int {
+        return arrangement.sublayouts.reduce(1) { $0 + frameCount(of: $1) }
+    }
+
+    private func frameCount(of arrangement: LOKLayoutArrangement) -> Int {
+        return arrangement.sublayouts.reduce(1) { $0 + frameCount(of: $1) }
+    }
+
+    private func makeStack(depth: Int, axis: Axis) -> Layout {
+        let sublayouts: [Layout] = (0..<fanOut).map { _ in
+            if depth == 0 {
+                return SizeLayout<View>(minWidth: 4, minHeight: 4)
+            }
+            return makeStack(depth: depth - 1, axis: axis == .vertical ? .horizontal : .vertical)
+        }
+        return StackLayout(axis: axis, spacing: 1, sublayouts: sublayouts)
+    }
+
+    private func makeObjCStack(depth: Int, axis: LOKAxis, subclassesLeaves: Bool) -> LOKLayout {
+        let sublayouts: [LOKLayout] = (0..<fanOut).map { _ in
+            if depth == 0 {
+                if subclassesLeaves {
+                    return SubclassedSizeLayout(size: 4)
+                }
+                return LOKSizeLayout(minWidth: 4, maxWidth: .infinity, minHeight: 4, maxHeight: .infinity,
+                                     alignment: nil, flexibility: nil, viewReuseId: nil, viewClass: nil, sublayout: nil)
+            }
+            return makeObjCStack(depth: depth - 1, axis: axis == .vertical ? .horizontal : .vertical, subclassesLeaves: subclassesLeaves)
+        }
+        return LOKStackLayout(axis: axis, spacing: 1, sublayouts: sublayouts)
+    }
+}
+
+/// A size layout that isn't one of the LayoutKit provided classes, so Swift layouts call it through the bridge.
+private class SubclassedSizeLayout: LOKSizeLayout {
+
+    init(size: CGFloat) {
+        super.init(minWidth: size, maxWidth: .infinity, minHeight: size, maxHeight: .infinity,
+                   alignment: nil, flexibility: nil, viewReuseId: nil, viewClass: nil, sublayout: nil)
+    }
+}
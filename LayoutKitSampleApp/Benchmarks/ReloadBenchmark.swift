@@ -0,0 +1,59 @@
+// Copyright 2019 LinkedIn Corp.
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+
+import UIKit
+import LayoutKit
+import ExampleLayouts
+
+/// Benchmarks reloading a `ReloadableViewLayoutAdapter` with serial and concurrent item layout.
+class ReloadBenchmark {
+
+    private let itemCounts = [100, 500, 2000]
+    private let width: CGFloat = 375
+
+    func run() {
+        for itemCount in itemCounts {
+            let data = FeedItemData.generate(count: itemCount)
+            benchmark("\(itemCount)\titems\tserial reload", data: data, layoutItemsConcurrently: false)
+            benchmark("\(itemCount)\titems\tconcurrent reload", data: data, layoutItemsConcurrently: true)
+        }
+    }
+
+    private func benchmark(_ description: String, data: [FeedItemData], layoutItemsConcurrently: Bool) {
+        Stopwatch.benchmark(description, block: { (stopwatch: Stopwatch) -> Void in
+            let collectionView = LayoutAdapterCollectionView(
+                frame: CGRect(x: 0, y: 0, width: self.width, height: 667),
+                collectionViewLayout: UICollectionViewFlowLayout())
+            collectionView.layoutAdapter.layoutItemsConcurrently = layoutItemsConcurrently
+
+            stopwatch.resume()
+            collectionView.layoutAdapter.reload(width: self.width, synchronous: true, layoutProvider: {
+                return [Section(header: nil, items: data.map(ReloadBenchmark.feedItemLayout), footer: nil)]
+            })
+            stopwatch.pause()
+        })
+    }
+
+    /// The same layout as `FeedItemLayoutKitView`.
+    static func feedItemLayout(for data: FeedItemData) -> Layout {
+        let posterProfile = ProfileCardLayout(
+            name: data.posterName,
+            connectionDegree: "2nd",
+            headline: data.posterHeadline,
+            timestamp: data.posterTimestamp,
+            profileImageName: "50x50.png")
+
+        let content = ContentLayout(title: data.contentTitle, domain: data.contentDomain)
+        return FeedItemLayout(
+            actionText: data.actionText,
+            posterProfile: posterProfile,
+            posterComment: data.posterComment,
+            contentLayout: content,
+            actorComment: data.actorComment)
+    }
+}
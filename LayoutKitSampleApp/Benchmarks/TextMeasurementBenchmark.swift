@@ -0,0 +1,52 @@
+// Copyright 2019 LinkedIn Corp.
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+
+import UIKit
+import LayoutKit
+
+/// Compares measuring the text of the feed items with `boundingRect` and with pooled TextKit stacks.
+class TextMeasurementBenchmark {
+
+    private let itemCount = 200
+    private let width: CGFloat = 375
+
+    func run() {
+        let strings = FeedItemData.generate(count: itemCount).flatMap { data in
+            [data.actionText, data.posterName, data.posterHeadline, data.posterTimestamp,
+             data.posterComment, data.contentTitle, data.contentDomain, data.actorComment]
+        }
+        for numberOfLines in [0, 1] {
+            benchmark(strings, numberOfLines: numberOfLines, backend: .boundingRect)
+            benchmark(strings, numberOfLines: numberOfLines, backend: .textKit)
+
+            let font = LabelLayoutDefaults.defaultFont
+            let maxSize = CGSize(width: width, height: .greatestFiniteMagnitude)
+            let requests = strings.map {
+                TextMeasurementRequest(text: .unattributed($0), font: font, numberOfLines: numberOfLines, maxSize: maxSize)
+            }
+            Stopwatch.benchmark("text\t\(strings.count) strings\t\(numberOfLines) lines\ttextKit batch", block: { (stopwatch: Stopwatch) -> Void in
+                stopwatch.resume()
+                _ = TextKitMeasurer.current.metrics(of: requests)
+                stopwatch.pause()
+            })
+        }
+    }
+
+    private func benchmark(_ strings: [String], numberOfLines: Int, backend: TextMeasurementBackend) {
+        Stopwatch.benchmark("text\t\(strings.count) strings\t\(numberOfLines) lines\t\(backend)", block: { (stopwatch: Stopwatch) -> Void in
+            let layouts = strings.map { LabelLayout(text: $0, numberOfLines: numberOfLines, measurementBackend: backend) }
+            // Measure the text again on every iteration.
+            TextMeasurementCache.shared.removeAll()
+            stopwatch.resume()
+            for layout in layouts {
+                _ = layout.measurement(within: CGSize(width: self.width, height: .greatestFiniteMagnitude))
+            }
+            stopwatch.pause()
+        })
+    }
+}
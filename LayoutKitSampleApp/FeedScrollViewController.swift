@@ -9,53 +9,28 @@
 import UIKit
 import LayoutKit
 
-/// Displays a feed using a UIScrollView
+/// Displays a feed using a VirtualListView, which only makes views for the feed items near the visible bounds.
 class FeedScrollViewController: FeedBaseViewController {
-    private var scrollView: UIScrollView!
-    private var cachedFeedLayout: Layout?
+    private var scrollView: VirtualListView!
 
     override func viewDidLoad() {
         super.viewDidLoad()
         view.backgroundColor = UIColor.purple
 
-        scrollView = UIScrollView(frame: view.bounds)
+        scrollView = VirtualListView(frame: view.bounds)
         scrollView.autoresizingMask = [.flexibleWidth, .flexibleHeight]
         view.addSubview(scrollView)
 
-        self.layoutFeed(width: self.view.bounds.width)
-    }
-
-    private func layoutFeed(width: CGFloat) {
-        let _ = CFAbsoluteTimeGetCurrent()
         DispatchQueue.global(qos: DispatchQoS.QoSClass.userInitiated).async {
-            let arrangement = self.getFeedLayout().arrangement(width: width)
+            let feedLayout = self.getFeedLayout()
             DispatchQueue.main.async(execute: {
-                self.scrollView.contentSize = arrangement.frame.size
-                arrangement.makeViews(in: self.scrollView)
-                let _ = CFAbsoluteTimeGetCurrent()
-//                NSLog("user: \((end-start).ms)")
+                self.scrollView.layout = feedLayout
             })
         }
     }
 
-    func getFeedLayout() -> Layout {
-        if let cachedFeedLayout = cachedFeedLayout {
-            return cachedFeedLayout
-        }
-
+    func getFeedLayout() -> VirtualListLayout {
         let feedItems = getFeedItems()
-        let feedLayout = StackLayout(
-            axis: .vertical,
-            distribution: .leading,
-            sublayouts: feedItems
-        )
-        cachedFeedLayout = feedLayout
-        return feedLayout
-    }
-
-    override func viewWillTransition(to size: CGSize, with coordinator: UIViewControllerTransitionCoordinator) {
-        super.viewWillTransition(to: size, with: coordinator)
-        layoutFeed(width: size.width)
+        return VirtualListLayout(itemCount: feedItems.count, itemSize: .estimated(200), itemLayout: { feedItems[$0] })
     }
 }
-
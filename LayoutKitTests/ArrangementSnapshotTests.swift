@@ -0,0 +1,114 @@
+// Copyright 2019 LinkedIn Corp.
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+
+import XCTest
+import LayoutKit
+
+class ArrangementSnapshotTests: XCTestCase {
+
+    private let key = ArrangementSnapshot.Key(contentVersion: "feed-42", width: 320)
+
+    private func makeLayout(_ index: Int) -> Layout {
+        return InsetLayout(inset: 4, sublayout: StackLayout(axis: .horizontal, spacing: 4, sublayouts: [
+            SizeLayout<View>(width: 20, height: 20),
+            OverlayLayout(primaryLayouts: [SizeLayout<View>(width: CGFloat(10 + index), height: 10)], backgroundLayouts: [SizeLayout<View>(minWidth: 0, minHeight: 0)])
+        ]))
+    }
+
+    private func makeData(itemCount: Int = 3) -> Data {
+        var builder = ArrangementSnapshot.Builder(key: key)
+        builder.appendSection(
+            header: SizeLayout<View>(height: 30).arrangement(width: 320),
+            items: (0..<itemCount).map { makeLayout($0).arrangement(width: 320) },
+            footer: nil)
+        builder.appendSection(header: nil, items: [makeLayout(9).arrangement(width: 320)], footer: nil)
+        return builder.data()
+    }
+
+    func testRoundTrip() throws {
+        let snapshot = try ArrangementSnapshot(data: makeData())
+
+        XCTAssertEqual(snapshot.key, key)
+        XCTAssertEqual(snapshot.sectionCount, 2)
+        XCTAssertEqual(snapshot.itemCount(inSection: 0), 3)
+        XCTAssertEqual(snapshot.itemCount(inSection: 1), 1)
+        XCTAssertEqual(snapshot.itemCount(inSection: 2), 0)
+
+        let layout = makeLayout(2)
+        let expected = layout.arrangement(width: 320)
+        let restored = snapshot.arrangement(of: layout, forItem: 2, inSection: 0)
+        XCTAssertEqual(restored.map(frames(of:)), frames(of: expected))
+        XCTAssertTrue((restored?.layout as AnyObject) === (layout as AnyObject))
+        XCTAssertEqual(snapshot.frame(ofItem: 2, inSection: 0), expected.frame)
+        XCTAssertEqual(snapshot.arrangement(of: SizeLayout<View>(height: 30), forHeaderInSection: 0)?.frame.height, 30)
+        XCTAssertNil(snapshot.arrangement(of: SizeLayout<View>(height: 30), forFooterInSection: 0))
+        XCTAssertNil(snapshot.arrangement(of: layout, forItem: 3, inSection: 0))
+    }
+
+    func testMismatchedLayoutIsNotRestored() throws {
+        let snapshot = try ArrangementSnapshot(data: makeData())
+        XCTAssertNil(snapshot.arrangement(of: SizeLayout<View>(width: 20, height: 20), forItem: 0, inSection: 0))
+        let extraSublayout = InsetLayout(inset: 4, sublayout: StackLayout(axis: .horizontal, sublayouts: [
+            SizeLayout<View>(width: 20, height: 20),
+            SizeLayout<View>(width: 20, height: 20),
+            SizeLayout<View>(width: 20, height: 20)
+        ]))
+        XCTAssertNil(snapshot.arrangement(of: extraSublayout, forItem: 0, inSection: 0))
+    }
+
+    func testCorruptionIsDetected() throws {
+        // The frames are checked when they are read, so a corrupted item doesn't prevent restoring the others.
+        var frames = makeData()
+        frames[frames.count - 10] ^= 0xFF
+        let snapshot = try ArrangementSnapshot(data: frames)
+        XCTAssertNil(snapshot.frame(ofItem: 0, inSection: 1))
+        XCTAssertNil(snapshot.arrangement(of: makeLayout(9), forItem: 0, inSection: 1))
+        XCTAssertNotNil(snapshot.arrangement(of: makeLayout(0), forItem: 0, inSection: 0))
+
+        // The header and tables are checked when the snapshot is opened. Byte 50 follows the 48 byte fixed header.
+        var data = makeData()
+        data[50] ^= 0xFF
+        XCTAssertThrowsError(try ArrangementSnapshot(data: data)) { error in
+            guard case ArrangementSnapshot.Error.checksumMismatch = error else {
+                return XCTFail("unexpected error \(error)")
+            }
+        }
+
+        XCTAssertThrowsError(try ArrangementSnapshot(data: makeData().dropLast(8))) { error in
+            guard case ArrangementSnapshot.Error.truncated = error else {
+                return XCTFail("unexpected error \(error)")
+            }
+        }
+
+        var version = makeData()
+        version[4] = 99
+        XCTAssertThrowsError(try ArrangementSnapshot(data: version)) { error in
+            guard case ArrangementSnapshot.Error.unsupportedVersion(99) = error else {
+                return XCTFail("unexpected error \(error)")
+            }
+        }
+
+        XCTAssertThrowsError(try ArrangementSnapshot(data: Data(count: 64)))
+    }
+
+    func testMemoryMappedFile() throws {
+        let url = URL(fileURLWithPath: NSTemporaryDirectory()).appendingPathComponent("ArrangementSnapshotTests-\(UUID().uuidString)")
+        defer {
+            try? FileManager.default.removeItem(at: url)
+        }
+        try makeData(itemCount: 1000).write(to: url)
+
+        let snapshot = try ArrangementSnapshot(contentsOf: url)
+        XCTAssertEqual(snapshot.itemCount(inSection: 0), 1000)
+        XCTAssertEqual(snapshot.arrangement(of: makeLayout(999), forItem: 999, inSection: 0)?.frame, makeLayout(999).arrangement(width: 320).frame)
+    }
+
+    private func frames(of arrangement: LayoutArrangement) -> [CGRect] {
+        return [arrangement.frame] + arrangement.sublayouts.flatMap { frames(of: $0) }
+    }
+}
@@ -19,8 +19,6 @@ class CGFloatExtensionTests: XCTestCase {
     }
 
     func testRoundedUpToFractionalPoint() {
-        let scale = UIScreen.main.scale
-
         let testCases: [TestCase] = [
             TestCase(rawValue: -1.1, roundedValue: [1.0: -1.0, 2.0: -1.0, 3.0: -1.0]),
             TestCase(rawValue: -1.0, roundedValue: [1.0: -1.0, 2.0: -1.0, 3.0: -1.0]),
@@ -38,14 +36,13 @@ class CGFloatExtensionTests: XCTestCase {
         ]
 
         for testCase in testCases {
-            let expected = testCase.roundedValue[scale]
-            XCTAssertEqual(testCase.rawValue.roundedUpToFractionalPoint, expected)
+            for (scale, expected) in testCase.roundedValue {
+                XCTAssertEqual(testCase.rawValue.roundedUp(toScale: scale), expected)
+            }
         }
     }
 
     func testRoundedToFractionalPoint() {
-        let scale = UIScreen.main.scale
-
         let testCases: [TestCase] = [
             TestCase(rawValue: -1.1, roundedValue: [1.0: -1.0, 2.0: -1.0, 3.0: -1.0]),
             TestCase(rawValue: -1.0, roundedValue: [1.0: -1.0, 2.0: -1.0, 3.0: -1.0]),
@@ -73,8 +70,24 @@ class CGFloatExtensionTests: XCTestCase {
         ]
 
         for testCase in testCases {
-            let expected = testCase.roundedValue[scale]
-            XCTAssertEqual(testCase.rawValue.roundedToFractionalPoint, expected)
+            for (scale, expected) in testCase.roundedValue {
+                XCTAssertEqual(testCase.rawValue.rounded(toScale: scale), expected)
+            }
         }
     }
+
+    func testRoundsToDisplayScale() {
+        let originalScale = DisplayScale.current
+        defer {
+            DisplayScale.current = originalScale
+        }
+
+        DisplayScale.current = 2
+        XCTAssertEqual(CGFloat(0.3).roundedUpToFractionalPoint, 0.5)
+        XCTAssertEqual(CGFloat(0.3).roundedDownToFractionalPoint, 0)
+
+        DisplayScale.current = 3
+        XCTAssertEqual(CGFloat(0.3).roundedUpToFractionalPoint, 1.0/3.0)
+        XCTAssertEqual(CGFloat(0.7).roundedToFractionalPoint, 2.0/3.0)
+    }
 }
@@ -0,0 +1,88 @@
+// Copyright 2019 LinkedIn Corp.
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+
+import XCTest
+import LayoutKit
+
+class FlowLayoutTests: XCTestCase {
+
+    /// Wraps into lines of [30, 30], [30, 50] and [20] at a width of 100.
+    private func makeFlow(distribution: StackLayoutDistribution = .leading) -> FlowLayout<View> {
+        return FlowLayout(spacing: 10, lineSpacing: 5, distribution: distribution, sublayouts: [
+            SizeLayout<View>(width: 30, height: 10),
+            SizeLayout<View>(width: 30, height: 10),
+            SizeLayout<View>(width: 30, height: 20),
+            SizeLayout<View>(width: 50, height: 10),
+            SizeLayout<View>(width: 20, height: 10),
+        ])
+    }
+
+    func testWrapping() {
+        let flow = makeFlow()
+        let measurement = flow.measurement(within: CGSize(width: 100, height: CGFloat.greatestFiniteMagnitude))
+        XCTAssertEqual(measurement.size, CGSize(width: 90, height: 10 + 5 + 20 + 5 + 10))
+
+        let arrangement = flow.arrangement(width: 100)
+        XCTAssertEqual(arrangement.frame, CGRect(x: 0, y: 0, width: 100, height: 50))
+        XCTAssertEqual(arrangement.sublayouts.map { $0.frame }, [
+            CGRect(x: 0, y: 0, width: 30, height: 10),
+            CGRect(x: 40, y: 0, width: 30, height: 10),
+            CGRect(x: 0, y: 15, width: 30, height: 20),
+            // Sublayouts are aligned within the height of their line.
+            CGRect(x: 40, y: 20, width: 50, height: 10),
+            CGRect(x: 0, y: 40, width: 20, height: 10),
+        ])
+    }
+
+    func testLineDistribution() {
+        let center = makeFlow(distribution: .center).arrangement(width: 100).sublayouts.map { $0.frame.minX }
+        XCTAssertEqual(center, [15, 55, 5, 45, 40])
+
+        let trailing = makeFlow(distribution: .trailing).arrangement(width: 100).sublayouts.map { $0.frame.minX }
+        XCTAssertEqual(trailing, [30, 70, 10, 50, 80])
+
+        let equalSpacing = makeFlow(distribution: .fillEqualSpacing).arrangement(width: 100).sublayouts.map { $0.frame.minX }
+        XCTAssertEqual(equalSpacing, [0, 70, 0, 50, 0])
+
+        let flexing = FlowLayout(spacing: 10, distribution: .fillFlexing, sublayouts: [
+            SizeLayout<View>(width: 30, height: 10),
+            SizeLayout<View>(height: 10, minWidth: 30),
+        ])
+        XCTAssertEqual(flexing.arrangement(width: 100).sublayouts.map { $0.frame }, [
+            CGRect(x: 0, y: 0, width: 30, height: 10),
+            CGRect(x: 40, y: 0, width: 60, height: 10),
+        ])
+    }
+
+    func testVerticalAxis() {
+        let flow = FlowLayout(axis: .vertical, spacing: 10, sublayouts: [
+            SizeLayout<View>(width: 20, height: 20),
+            SizeLayout<View>(width: 20, height: 20),
+            SizeLayout<View>(width: 20, height: 20),
+        ])
+        let arrangement = flow.arrangement(height: 50)
+        XCTAssertEqual(arrangement.frame.size, CGSize(width: 40, height: 50))
+        XCTAssertEqual(arrangement.sublayouts.map { $0.frame.origin }, [
+            CGPoint(x: 0, y: 0),
+            CGPoint(x: 0, y: 30),
+            CGPoint(x: 20, y: 0),
+        ])
+    }
+
+    func testSublayoutsThatDontFitAcrossTheAxisAreDropped() {
+        let measurement = makeFlow().measurement(within: CGSize(width: 100, height: 25))
+        XCTAssertEqual(measurement.size, CGSize(width: 70, height: 10))
+        XCTAssertEqual(measurement.sublayouts.count, 2)
+    }
+
+    func testEmptyFlow() {
+        let arrangement = FlowLayout<View>(sublayouts: []).arrangement(width: 100)
+        XCTAssertEqual(arrangement.frame.height, 0)
+        XCTAssertTrue(arrangement.sublayouts.isEmpty)
+    }
+}
@@ -0,0 +1,173 @@
+// Copyright 2019 LinkedIn Corp.
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+
+import XCTest
+@testable import LayoutKit
+
+class IncrementalFlushSchedulerTests: XCTestCase {
+
+    // Durations are powers of two so that the averages are exact.
+    private var now: CFTimeInterval = 0
+
+    private func makeScheduler() -> IncrementalFlushScheduler {
+        return IncrementalFlushScheduler(frameInterval: 1.0 / 64, frameBudget: 1.0 / 128, movingFlushInterval: 1.0 / 8, clock: { self.now })
+    }
+
+    private func layOutItem(with scheduler: IncrementalFlushScheduler, cost: CFTimeInterval = 1.0 / 256) {
+        scheduler.measureLayout {
+            now += cost
+        }
+    }
+
+    func testChunksAreSizedByLayoutAndInsertCosts() {
+        let scheduler = makeScheduler()
+
+        // The first item is flushed right away.
+        layOutItem(with: scheduler)
+        XCTAssertTrue(scheduler.shouldFlush())
+        scheduler.flushWillStart()
+
+        // No flush while the previous one is waiting for the main thread.
+        layOutItem(with: scheduler)
+        XCTAssertFalse(scheduler.shouldFlush())
+        scheduler.recordInsert(itemCount: 1, duration: 1.0 / 1024)
+        scheduler.flushDidEnd(viewIsMoving: false)
+
+        // Four items are laid out per frame, and eight can be inserted within the budget.
+        XCTAssertEqual(scheduler.chunkSize, 4)
+        layOutItem(with: scheduler)
+        layOutItem(with: scheduler)
+        XCTAssertFalse(scheduler.shouldFlush())
+        layOutItem(with: scheduler)
+        XCTAssertTrue(scheduler.shouldFlush())
+
+        // Slower inserts shrink the chunks to what fits within the budget: 1/1024 + (1/128 - 1/1024) / 4 = 11/4096 per item.
+        scheduler.recordInsert(itemCount: 1, duration: 1.0 / 128)
+        XCTAssertEqual(scheduler.chunkSize, 2)
+    }
+
+    func testBatchesOfConcurrentLayoutsAreMeasuredPerItem() {
+        let scheduler = makeScheduler()
+
+        // Four items laid out in a frame cost 1/256 each.
+        scheduler.recordLayout(itemCount: 4, duration: 1.0 / 64)
+        XCTAssertEqual(scheduler.chunkSize, 4)
+        XCTAssertTrue(scheduler.shouldFlush())
+        scheduler.flushWillStart()
+        scheduler.flushDidEnd(viewIsMoving: false)
+
+        scheduler.recordLayout(itemCount: 2, duration: 1.0 / 128)
+        XCTAssertFalse(scheduler.shouldFlush())
+        scheduler.recordLayout(itemCount: 2, duration: 1.0 / 128)
+        XCTAssertTrue(scheduler.shouldFlush())
+    }
+
+    func testFlushesAreCoalescedWhileTheViewIsMoving() {
+        let scheduler = makeScheduler()
+        layOutItem(with: scheduler)
+        XCTAssertTrue(scheduler.shouldFlush())
+        scheduler.flushWillStart()
+        scheduler.flushDidEnd(viewIsMoving: true)
+
+        for _ in 0..<10 {
+            layOutItem(with: scheduler)
+        }
+        XCTAssertFalse(scheduler.shouldFlush())
+
+        now += 1.0 / 8
+        XCTAssertTrue(scheduler.shouldFlush())
+        scheduler.flushWillStart()
+        scheduler.flushDidEnd(viewIsMoving: false)
+
+        layOutItem(with: scheduler)
+        XCTAssertFalse(scheduler.shouldFlush(), "Chunks are sized by cost again once the view stopped")
+    }
+
+    func testIncrementalReloadInsertsEveryItemOnce() {
+        let view = MockReloadableView()
+        let adapter = ReloadableViewLayoutAdapter(reloadableView: view)
+        var reloadedItemCount = 0
+        view.didReload = {
+            reloadedItemCount = adapter.currentArrangement.first?.items.count ?? 0
+        }
+
+        let completed = expectation(description: "completed")
+        adapter.reload(width: 320, layoutProvider: { self.layouts(count: 100) }, completion: {
+            completed.fulfill()
+        })
+        waitForExpectations(timeout: 10, handler: nil)
+
+        let insertedIndexPaths = view.batchUpdates.flatMap { $0.insertItems }
+        XCTAssertEqual(view.reloadCount, 1)
+        XCTAssertEqual(Set(insertedIndexPaths).count, insertedIndexPaths.count)
+        XCTAssertEqual(reloadedItemCount + insertedIndexPaths.count, 100)
+        XCTAssertEqual(adapter.currentArrangement.first?.items.count, 100)
+    }
+
+    func testIncrementalReloadIsCoalescedWhileTracking() {
+        let view = MockReloadableView()
+        view.isTracking = true
+        let adapter = ReloadableViewLayoutAdapter(reloadableView: view)
+        // Time doesn't pass, so deferred flushes are never retried.
+        adapter.incrementalUpdateClock = { 0 }
+        let recorder = DeferredUpdateRecorder()
+        adapter.metricsDelegate = recorder
+
+        recorder.expectation = expectation(description: "completed")
+        adapter.reload(width: 320, layoutProvider: { self.layouts(count: 100) })
+        waitForExpectations(timeout: 10, handler: nil)
+
+        // The first item and the end of the section were flushed and deferred, then the final arrangement reloaded the view.
+        XCTAssertEqual(recorder.deferredUpdateCount, 2)
+        XCTAssertEqual(view.reloadCount, 1)
+        XCTAssertTrue(view.batchUpdates.isEmpty)
+        XCTAssertEqual(adapter.currentArrangement.first?.items.count, 100)
+    }
+
+    private func layouts(count: Int) -> [Section<[Layout]>] {
+        let items: [Layout] = (0..<count).map { _ in SizeLayout<View>(height: 10) }
+        return [Section(items: items)]
+    }
+}
+
+/// A reloadable view that records how it was updated.
+private class MockReloadableView: ReloadableView {
+
+    var bounds = CGRect(x: 0, y: 0, width: 320, height: 480)
+    var isTracking = false
+    var isDecelerating = false
+
+    var didReload: (() -> Void)?
+    private(set) var reloadCount = 0
+    private(set) var batchUpdates = [BatchUpdates]()
+
+    func reloadDataSynchronously() {
+        reloadCount += 1
+        didReload?()
+    }
+
+    func registerViews(withReuseIdentifier reuseIdentifier: String) {
+        // Nothing to register.
+    }
+
+    func perform(batchUpdates: BatchUpdates, completion: (() -> Void)?) {
+        self.batchUpdates.append(batchUpdates)
+        completion?()
+    }
+}
+
+private class DeferredUpdateRecorder: ReloadableViewLayoutAdapterMetricsDelegate {
+
+    var deferredUpdateCount = 0
+    var expectation: XCTestExpectation?
+
+    func layoutAdapter(_ layoutAdapter: ReloadableViewLayoutAdapter, didFinishReloadWith metrics: ReloadMetrics) {
+        deferredUpdateCount += metrics.deferredUpdateCount
+        expectation?.fulfill()
+    }
+}
@@ -44,6 +44,75 @@ class LayoutArrangementTests: XCTestCase {
         XCTAssertTrue(firstView == secondView)
     }
 
+    func testMakeViewsConfiguresAgainBySameLayoutByDefault() {
+        var configCount = 0
+        let layout = SizeLayout<View>(width: 50, height: 50, viewReuseId: "someID") { _ in configCount += 1 }
+        let arrangement = layout.arrangement()
+        let container = View()
+
+        arrangement.makeViews(in: container)
+        arrangement.makeViews(in: container)
+
+        XCTAssertEqual(configCount, 2)
+    }
+
+    func testMakeViewsSkipsConfigurationBySameLayoutThatOptsIn() {
+        var configCount = 0
+        let layout = ConfiguredOnceSizeLayout(width: 50, height: 50, viewReuseId: "someID") { _ in configCount += 1 }
+        let arrangement = layout.arrangement()
+        let container = View()
+
+        arrangement.makeViews(in: container)
+        let view = container.subviews.first
+        arrangement.makeViews(in: container)
+        layout.arrangement().makeViews(in: container)
+
+        XCTAssertEqual(configCount, 1)
+        XCTAssertTrue(container.subviews.first == view)
+        XCTAssertEqual(view?.frame, CGRect(x: 0, y: 0, width: 50, height: 50))
+    }
+
+    func testMakeViewsConfiguresForNewLayout() {
+        var configCount = 0
+        let makeLayout = { (width: CGFloat) in
+            return SizeLayout<View>(width: width, height: 50, viewReuseId: "someID") { _ in configCount += 1 }
+        }
+        let container = View()
+
+        makeLayout(50).arrangement().makeViews(in: container)
+        makeLayout(50).arrangement().makeViews(in: container)
+        XCTAssertEqual(configCount, 2)
+
+        makeLayout(60).arrangement().makeViews(in: container)
+        XCTAssertEqual(configCount, 3)
+        XCTAssertEqual(container.subviews.first?.frame, CGRect(x: 0, y: 0, width: 60, height: 50))
+    }
+
+    func testMakeViewsUpdatesFramesOfConfiguredViews() {
+        let layout = SizeLayout<View>(width: 50, height: 50, viewReuseId: "someID") { _ in }
+        let container = View()
+
+        layout.arrangement().makeViews(in: container)
+        layout.arrangement(origin: CGPoint(x: 5, y: 5)).makeViews(in: container)
+
+        XCTAssertEqual(container.subviews.first?.frame, CGRect(x: 5, y: 5, width: 50, height: 50))
+    }
+
+    #if os(iOS) || os(tvOS)
+    func testMakeViewsReconfiguresAfterResettingTransform() {
+        let layout = ConfiguredOnceSizeLayout(width: 50, height: 50, viewReuseId: "someID") { view in
+            view.transform = CGAffineTransform(scaleX: 2, y: 2)
+        }
+        let arrangement = layout.arrangement()
+        let container = View()
+
+        arrangement.makeViews(in: container)
+        arrangement.makeViews(in: container)
+
+        XCTAssertEqual(container.subviews.first?.transform, CGAffineTransform(scaleX: 2, y: 2))
+    }
+    #endif
+
     func testSubviewOrderIsStable() {
         // Forces the SizeLayout to produce a view.
         let forceViewConfig: (View) -> Void = { _ in }
@@ -149,3 +218,11 @@ class LayoutArrangementTests: XCTestCase {
         XCTAssertEqual(redSquare?.frame, CGRect(x: 30, y: 0, width: 20, height: 20))
     }
 }
+
+/// A size layout whose views are only configured again once another layout configured them.
+private class ConfiguredOnceSizeLayout: SizeLayout<View> {
+
+    override var configuresViewsOnce: Bool {
+        return true
+    }
+}
@@ -0,0 +1,147 @@
+// Copyright 2019 LinkedIn Corp.
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+
+import XCTest
+import LayoutKit
+
+class LayoutMeasurementCacheTests: XCTestCase {
+
+    func testCacheIsNotUsedOutsideOfPerform() {
+        let cache = LayoutMeasurementCache()
+        let leaf = CountingLayout(size: CGSize(width: 10, height: 10))
+        let stack = StackLayout(axis: .vertical, sublayouts: [leaf])
+
+        _ = stack.arrangement(width: 100)
+        _ = stack.arrangement(width: 100)
+
+        XCTAssertEqual(leaf.measurementCount, 2)
+        XCTAssertEqual(cache.hitCount, 0)
+        XCTAssertEqual(cache.missCount, 0)
+    }
+
+    func testRepeatedMeasurementIsCached() {
+        let cache = LayoutMeasurementCache()
+        let leaf = CountingLayout(size: CGSize(width: 10, height: 10))
+        let stack = StackLayout(axis: .vertical, sublayouts: [
+            InsetLayout(inset: 5, sublayout: leaf)
+        ])
+
+        let first = cache.perform { stack.arrangement(width: 100) }
+        let second = cache.perform { stack.arrangement(width: 100) }
+
+        XCTAssertEqual(first.frame, second.frame)
+        XCTAssertEqual(first.sublayouts[0].sublayouts[0].frame, second.sublayouts[0].sublayouts[0].frame)
+        XCTAssertEqual(leaf.measurementCount, 1)
+        XCTAssertEqual(cache.missCount, 3)
+        XCTAssertEqual(cache.hitCount, 1)
+    }
+
+    func testDifferentMaxSizeIsNotShared() {
+        let cache = LayoutMeasurementCache()
+        let leaf = CountingLayout(size: CGSize(width: 10, height: 10))
+
+        cache.perform {
+            _ = leaf.arrangement(width: 100)
+            _ = leaf.arrangement(width: 200)
+            _ = leaf.arrangement(width: 100)
+        }
+
+        XCTAssertEqual(leaf.measurementCount, 2)
+        XCTAssertEqual(cache.missCount, 2)
+        XCTAssertEqual(cache.hitCount, 1)
+    }
+
+    func testLeastRecentlyUsedIsEvicted() {
+        let cache = LayoutMeasurementCache(countLimit: 2)
+        let one = CountingLayout(size: CGSize(width: 1, height: 1))
+        let two = CountingLayout(size: CGSize(width: 2, height: 2))
+        let three = CountingLayout(size: CGSize(width: 3, height: 3))
+
+        cache.perform {
+            _ = one.arrangement()
+            _ = two.arrangement()
+            // Touch `one` so that `two` is the least recently used.
+            _ = one.arrangement()
+            _ = three.arrangement()
+        }
+        XCTAssertEqual(cache.count, 2)
+        XCTAssertEqual(cache.evictionCount, 1)
+
+        cache.perform {
+            _ = one.arrangement()
+            _ = two.arrangement()
+        }
+        XCTAssertEqual(one.measurementCount, 1)
+        XCTAssertEqual(two.measurementCount, 2)
+        XCTAssertEqual(three.measurementCount, 1)
+    }
+
+    func testLayoutsWithoutKeyAreNotCached() {
+        let cache = LayoutMeasurementCache()
+        let leaf = CountingLayout(size: CGSize(width: 10, height: 10), cacheable: false)
+
+        cache.perform {
+            _ = leaf.arrangement(width: 100)
+            _ = leaf.arrangement(width: 100)
+        }
+
+        XCTAssertEqual(leaf.measurementCount, 2)
+        XCTAssertEqual(cache.count, 0)
+    }
+
+    func testRemoveAll() {
+        let cache = LayoutMeasurementCache()
+        let leaf = CountingLayout(size: CGSize(width: 10, height: 10))
+
+        cache.perform { _ = leaf.arrangement() }
+        cache.removeAll()
+        cache.perform { _ = leaf.arrangement() }
+
+        XCTAssertEqual(cache.count, 1)
+        XCTAssertEqual(leaf.measurementCount, 2)
+    }
+
+    #if os(iOS)
+    func testEquivalentLabelsShareMeasurementAndKeepTheirOwnConfig() {
+        let cache = LayoutMeasurementCache()
+        var configured = [String]()
+        let one = LabelLayout(text: "Nick Snyder", font: UIFont.helvetica(), config: { _ in configured.append("one") })
+        let two = LabelLayout(text: "Nick Snyder", font: UIFont.helvetica(), config: { _ in configured.append("two") })
+
+        let first = cache.perform { one.arrangement(width: 100) }
+        let second = cache.perform { two.arrangement(width: 100) }
+
+        XCTAssertEqual(first.frame, second.frame)
+        XCTAssertEqual(cache.hitCount, 1)
+
+        second.makeViews()
+        XCTAssertEqual(configured, ["two"])
+    }
+    #endif
+}
+
+/// A fixed size layout that counts how many times it is measured.
+private class CountingLayout: SizeLayout<View> {
+
+    private let cacheable: Bool
+    private(set) var measurementCount = 0
+
+    init(size: CGSize, cacheable: Bool = true) {
+        self.cacheable = cacheable
+        super.init(minWidth: size.width, maxWidth: size.width, minHeight: size.height, maxHeight: size.height)
+    }
+
+    override var measurementCacheKey: AnyHashable? {
+        return cacheable ? super.measurementCacheKey : nil
+    }
+
+    override func measurement(within maxSize: CGSize) -> LayoutMeasurement {
+        measurementCount += 1
+        return super.measurement(within: maxSize)
+    }
+}
@@ -0,0 +1,88 @@
+// Copyright 2019 LinkedIn Corp.
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+
+import XCTest
+import LayoutKit
+
+class LayoutProfilerTests: XCTestCase {
+
+    private func makeLayout() -> Layout {
+        return StackLayout(axis: .vertical, sublayouts: [
+            SizeLayout<View>(width: 20, height: 20, viewReuseId: "square"),
+            InsetLayout(inset: 2, sublayout: SizeLayout<View>(width: 10, height: 10))
+        ])
+    }
+
+    func testRecordsEveryNode() {
+        let profiler = LayoutProfiler()
+        profiler.emitsSignposts = false
+        let layout = makeLayout()
+
+        let arrangement = profiler.perform {
+            return layout.arrangement(width: 320)
+        }
+
+        XCTAssertEqual(arrangement.frame.width, 320)
+        let intervals = profiler.intervals
+        XCTAssertEqual(intervals.filter { $0.phase == .measurement }.count, 4)
+        XCTAssertEqual(intervals.filter { $0.phase == .arrangement }.count, 4)
+        XCTAssertEqual(intervals.filter { $0.viewReuseId == "square" }.count, 2)
+
+        // The root ends last and includes the time of its sublayouts.
+        let rootMeasurement = intervals.last { $0.phase == .measurement }
+        XCTAssertEqual(rootMeasurement?.layoutType, String(describing: type(of: layout)))
+        for interval in intervals where interval.phase == .measurement {
+            XCTAssertLessThanOrEqual(interval.duration, rootMeasurement?.duration ?? 0)
+        }
+    }
+
+    func testSummariesCountRepeatedMeasurements() {
+        let profiler = LayoutProfiler()
+        profiler.emitsSignposts = false
+        let layout = makeLayout()
+
+        profiler.perform {
+            _ = layout.arrangement(width: 320)
+            _ = layout.arrangement(width: 200)
+        }
+
+        let summary = profiler.summaries.first { $0.layoutType == String(describing: type(of: layout)) }
+        XCTAssertEqual(summary?.measurementCount, 2)
+        XCTAssertEqual(summary?.arrangementCount, 2)
+        XCTAssertEqual(summary?.repeatedMeasurementCount, 1)
+    }
+
+    func testNothingIsRecordedOutsideOfPerform() {
+        let profiler = LayoutProfiler()
+        profiler.emitsSignposts = false
+        let layout = makeLayout()
+
+        profiler.perform {
+            _ = layout.arrangement(width: 320)
+        }
+        profiler.removeAll()
+        _ = layout.arrangement(width: 320)
+
+        XCTAssertTrue(profiler.intervals.isEmpty)
+    }
+
+    func testChromeTrace() throws {
+        let profiler = LayoutProfiler()
+        profiler.emitsSignposts = false
+        profiler.perform {
+            _ = makeLayout().arrangement(width: 320)
+        }
+
+        let trace = try JSONSerialization.jsonObject(with: profiler.chromeTrace(), options: []) as? [String: Any]
+        let events = trace?["traceEvents"] as? [[String: Any]]
+        XCTAssertEqual(events?.count, profiler.intervals.count)
+        XCTAssertEqual(events?.first?["ph"] as? String, "X")
+        XCTAssertNotNil(events?.first?["dur"] as? Double)
+        XCTAssertEqual(Set(events?.compactMap { $0["cat"] as? String } ?? []), ["measurement", "arrangement"])
+    }
+}
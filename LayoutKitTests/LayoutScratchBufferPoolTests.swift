@@ -0,0 +1,62 @@
+// Copyright 2019 LinkedIn Corp.
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+
+import XCTest
+import LayoutKit
+
+class LayoutScratchBufferPoolTests: XCTestCase {
+
+    private func makeLayout() -> Layout {
+        let rows: [Layout] = (0..<10).map { index in
+            let row = StackLayout(axis: .horizontal, spacing: 4, sublayouts: [
+                SizeLayout<View>(width: 20, height: 20),
+                InsetLayout(inset: 2, sublayout: SizeLayout<View>(width: CGFloat(index), height: 10)),
+                SizeLayout<View>(minWidth: 10, maxWidth: nil, minHeight: 10, maxHeight: nil)
+            ])
+            return OverlayLayout(primaryLayouts: [row], backgroundLayouts: [SizeLayout<View>(minWidth: 0, minHeight: 0)])
+        }
+        return StackLayout(axis: .vertical, distribution: .fillEqualSize, sublayouts: rows)
+    }
+
+    func testRepeatedPassDoesNotAllocate() {
+        let pool = LayoutScratchBufferPool.current
+        let layout = makeLayout()
+
+        let first = layout.arrangement(width: 320)
+        pool.resetCounters()
+        let second = layout.arrangement(width: 320)
+
+        XCTAssertEqual(pool.allocationCount, 0)
+        XCTAssertGreaterThan(pool.reuseCount, 0)
+        XCTAssertEqual(second.frame, first.frame)
+        XCTAssertEqual(second.sublayouts.map { $0.frame }, first.sublayouts.map { $0.frame })
+    }
+
+    func testLargerStackGrowsBuffer() {
+        let pool = LayoutScratchBufferPool.current
+        _ = StackLayout(axis: .vertical, sublayouts: [SizeLayout<View>(width: 10, height: 10)]).arrangement()
+
+        pool.resetCounters()
+        let sublayouts = (0..<100).map { _ in SizeLayout<View>(width: 10, height: 10) }
+        _ = StackLayout(axis: .vertical, sublayouts: sublayouts).arrangement()
+
+        XCTAssertGreaterThan(pool.allocationCount, 0)
+    }
+
+    func testPoolsArePerThread() {
+        let pool = LayoutScratchBufferPool.current
+        XCTAssertTrue(pool === LayoutScratchBufferPool.current)
+
+        let finished = expectation(description: "finished")
+        Thread.detachNewThread {
+            XCTAssertFalse(pool === LayoutScratchBufferPool.current)
+            finished.fulfill()
+        }
+        waitForExpectations(timeout: 10, handler: nil)
+    }
+}
@@ -0,0 +1,137 @@
+// Copyright 2019 LinkedIn Corp.
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+
+import XCTest
+@testable import LayoutKit
+
+class ReloadMetricsTests: XCTestCase {
+
+    func testAsynchronousReloadReportsPhases() {
+        let view = LayoutAdapterTableView(frame: CGRect(x: 0, y: 0, width: 320, height: 100), style: .plain)
+        let recorder = MetricsRecorder()
+        view.layoutAdapter.metricsDelegate = recorder
+
+        recorder.expectation = expectation(description: "metrics")
+        view.layoutAdapter.reload(width: 320, layoutProvider: { self.layouts(count: 20) })
+        waitForExpectations(timeout: 10, handler: nil)
+
+        XCTAssertEqual(recorder.metrics.count, 1)
+        let metrics = recorder.metrics[0]
+        XCTAssertEqual(metrics.outcome, .completed)
+        XCTAssertFalse(metrics.isSynchronous)
+        XCTAssertEqual(metrics.layoutDurations.count, 20)
+        XCTAssertGreaterThan(metrics.mainThreadUpdateCount, 0)
+        XCTAssertGreaterThanOrEqual(metrics.totalDuration, metrics.queueWaitDuration + metrics.layoutProviderDuration)
+        XCTAssertEqual(metrics.cancelledReloadCount, 0)
+    }
+
+    func testCancelledReloadIsReported() {
+        let view = LayoutAdapterTableView(frame: CGRect(x: 0, y: 0, width: 320, height: 100), style: .plain)
+        let recorder = MetricsRecorder()
+        view.layoutAdapter.metricsDelegate = recorder
+
+        // Block the layout queue so that the first reload can't finish before it is cancelled.
+        let blocker = DispatchSemaphore(value: 0)
+        view.layoutAdapter.backgroundLayoutQueue.addOperation {
+            blocker.wait()
+        }
+        view.layoutAdapter.reload(width: 320, layoutProvider: { self.layouts(count: 20) })
+        XCTAssertEqual(recorder.metrics.count, 0)
+
+        recorder.expectation = expectation(description: "metrics")
+        view.layoutAdapter.reload(width: 320, synchronous: true, layoutProvider: { self.layouts(count: 10) })
+        XCTAssertEqual(recorder.metrics.first?.outcome, .cancelled)
+        blocker.signal()
+        waitForExpectations(timeout: 10, handler: nil)
+
+        XCTAssertEqual(recorder.metrics.count, 2)
+        let metrics = recorder.metrics[1]
+        XCTAssertEqual(metrics.outcome, .completed)
+        XCTAssertTrue(metrics.isSynchronous)
+        XCTAssertEqual(metrics.cancelledReloadCount, 1)
+        XCTAssertEqual(metrics.layoutDurations.count, 10)
+    }
+
+    func testNoMetricsWithoutDelegate() {
+        let view = LayoutAdapterTableView(frame: CGRect(x: 0, y: 0, width: 320, height: 100), style: .plain)
+        view.layoutAdapter.reload(width: 320, synchronous: true, layoutProvider: { self.layouts(count: 1) })
+        XCTAssertNil(view.layoutAdapter.activeReloadMetrics)
+    }
+
+    func testHistogram() {
+        var histogram = LatencyHistogram()
+        XCTAssertNil(histogram.upperBound(atPercentile: 50))
+
+        for _ in 0..<90 {
+            histogram.record(0.000_1)
+        }
+        for _ in 0..<9 {
+            histogram.record(0.003)
+        }
+        histogram.record(60)
+
+        XCTAssertEqual(histogram.count, 100)
+        XCTAssertEqual(histogram.bucketCounts.first, 90)
+        XCTAssertEqual(histogram.bucketCounts.last, 1)
+        XCTAssertEqual(histogram.upperBound(atPercentile: 50), 0.000_25)
+        XCTAssertEqual(histogram.upperBound(atPercentile: 99), 0.004)
+        XCTAssertEqual(histogram.upperBound(atPercentile: 100), .infinity)
+
+        var merged = LatencyHistogram()
+        merged.merge(histogram)
+        merged.merge(histogram)
+        XCTAssertEqual(merged.count, 200)
+        XCTAssertEqual(merged.sum, histogram.sum * 2, accuracy: 0.000_001)
+    }
+
+    func testAggregatorSamplesReloads() {
+        let aggregator = ReloadMetricsAggregator(sampleRate: 0.5)
+        var randomValues = [0.1, 0.9]
+        aggregator.random = { randomValues.removeFirst() }
+        let adapter = ReloadableViewLayoutAdapter(reloadableView: LayoutAdapterTableView())
+        let metrics = ReloadMetrics(
+            outcome: .completed,
+            isSynchronous: false,
+            queueWaitDuration: 0.001,
+            layoutProviderDuration: 0.002,
+            layoutDurations: [0.001, 0.001],
+            mainThreadUpdateDuration: 0.005,
+            mainThreadUpdateCount: 2,
+            deferredUpdateCount: 1,
+            cancelledReloadCount: 0,
+            totalDuration: 0.02)
+
+        aggregator.layoutAdapter(adapter, didFinishReloadWith: metrics)
+        aggregator.layoutAdapter(adapter, didFinishReloadWith: metrics)
+
+        let snapshot = aggregator.takeSnapshot()
+        XCTAssertEqual(snapshot.completedReloadCount, 1)
+        XCTAssertEqual(snapshot.layout.count, 2)
+        XCTAssertEqual(snapshot.deferredUpdateCount, 1)
+        XCTAssertEqual(snapshot.mainThreadUpdate.count, 1)
+        XCTAssertEqual(aggregator.snapshot.completedReloadCount, 0)
+    }
+
+    private func layouts(count: Int) -> [Section<[Layout]>] {
+        let items: [Layout] = (0..<count).map { _ in SizeLayout<View>(height: 10) }
+        return [Section(items: items)]
+    }
+}
+
+private class MetricsRecorder: ReloadableViewLayoutAdapterMetricsDelegate {
+
+    var metrics = [ReloadMetrics]()
+    var expectation: XCTestExpectation?
+
+    func layoutAdapter(_ layoutAdapter: ReloadableViewLayoutAdapter, didFinishReloadWith metrics: ReloadMetrics) {
+        self.metrics.append(metrics)
+        if metrics.outcome == .completed {
+            expectation?.fulfill()
+        }
+    }
+}
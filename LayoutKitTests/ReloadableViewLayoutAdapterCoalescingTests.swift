@@ -0,0 +1,179 @@
+// Copyright 2019 LinkedIn Corp.
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+
+import XCTest
+@testable import LayoutKit
+
+class ReloadableViewLayoutAdapterCoalescingTests: XCTestCase {
+
+    func testRapidRequestsAreCoalesced() {
+        let view = makeView()
+        var results = [CoalescedReloadResult]()
+        var providedCounts = [Int]()
+        let completed = expectation(description: "completed")
+        for count in 1...10 {
+            view.layoutAdapter.requestReload(width: 320, layoutProvider: { () -> [Section<[Layout]>] in
+                providedCounts.append(count)
+                return self.layouts(count: count)
+            }, completion: { result in
+                results.append(result)
+                if result == .completed {
+                    completed.fulfill()
+                }
+            })
+        }
+        waitForExpectations(timeout: 10, handler: nil)
+
+        XCTAssertEqual(results, [CoalescedReloadResult](repeating: .superseded, count: 9) + [.completed])
+        XCTAssertEqual(providedCounts, [10])
+        XCTAssertEqual(view.layoutAdapter.currentArrangement.first?.items.count, 10)
+
+        let statistics = view.layoutAdapter.coalescedReloadStatistics
+        XCTAssertEqual(statistics.requestedCount, 10)
+        XCTAssertEqual(statistics.supersededCount, 9)
+        XCTAssertEqual(statistics.completedCount, 1)
+        XCTAssertEqual(statistics.completedLayoutCount, 10)
+        XCTAssertEqual(statistics.wastedLayoutCount, 0)
+    }
+
+    func testRequestsWaitForTheReloadInProgress() {
+        let view = makeView()
+        let blocker = DispatchSemaphore(value: 0)
+        view.layoutAdapter.backgroundLayoutQueue.addOperation {
+            blocker.wait()
+        }
+
+        var results = [String: CoalescedReloadResult]()
+        let completed = expectation(description: "completed")
+        view.layoutAdapter.requestReload(width: 320, layoutProvider: { self.layouts(count: 3) }, completion: { results["a"] = $0 })
+        waitUntil { view.layoutAdapter.reloadCoalescer.current != nil }
+
+        view.layoutAdapter.requestReload(width: 320, layoutProvider: { self.layouts(count: 4) }, completion: { results["b"] = $0 })
+        view.layoutAdapter.requestReload(width: 320, layoutProvider: { self.layouts(count: 5) }, completion: { result in
+            results["c"] = result
+            completed.fulfill()
+        })
+        XCTAssertEqual(results, ["b": .superseded])
+
+        blocker.signal()
+        waitForExpectations(timeout: 10, handler: nil)
+
+        XCTAssertEqual(results, ["a": .completed, "b": .superseded, "c": .completed])
+        XCTAssertEqual(view.layoutAdapter.currentArrangement.first?.items.count, 5)
+
+        let statistics = view.layoutAdapter.coalescedReloadStatistics
+        XCTAssertEqual(statistics.completedCount, 2)
+        XCTAssertEqual(statistics.completedLayoutCount, 8)
+        XCTAssertEqual(statistics.cancelledCount, 0)
+    }
+
+    func testCancellingTheReloadInProgressCountsWastedLayouts() {
+        let view = makeView()
+        let blockingLayout = BlockingLayout()
+        var result: CoalescedReloadResult?
+        let request = view.layoutAdapter.requestReload(width: 320, layoutProvider: { () -> [Section<[Layout]>] in
+            [Section(items: [SizeLayout<View>(height: 10), blockingLayout, SizeLayout<View>(height: 10)])]
+        }, completion: { result = $0 })
+        waitUntil { view.layoutAdapter.reloadCoalescer.current != nil }
+
+        // The second layout is being measured, so two layouts have been counted.
+        blockingLayout.started.wait()
+        request.cancel()
+        blockingLayout.gate.signal()
+
+        XCTAssertEqual(result, .cancelled)
+        let statistics = view.layoutAdapter.coalescedReloadStatistics
+        XCTAssertEqual(statistics.cancelledCount, 1)
+        XCTAssertEqual(statistics.wastedLayoutCount, 2)
+        XCTAssertEqual(statistics.completedCount, 0)
+
+        view.layoutAdapter.resetCoalescedReloadStatistics()
+        XCTAssertEqual(view.layoutAdapter.coalescedReloadStatistics.requestedCount, 0)
+    }
+
+    func testReloadThatIsNotCoalescedInterruptsCoalescedReloads() {
+        let view = makeView()
+        let blocker = DispatchSemaphore(value: 0)
+        view.layoutAdapter.backgroundLayoutQueue.addOperation {
+            blocker.wait()
+        }
+
+        var results = [String: CoalescedReloadResult]()
+        view.layoutAdapter.requestReload(width: 320, layoutProvider: { self.layouts(count: 3) }, completion: { results["a"] = $0 })
+        waitUntil { view.layoutAdapter.reloadCoalescer.current != nil }
+        view.layoutAdapter.requestReload(width: 320, layoutProvider: { self.layouts(count: 4) }, completion: { results["b"] = $0 })
+
+        view.layoutAdapter.reload(width: 320, synchronous: true, layoutProvider: { self.layouts(count: 1) })
+        blocker.signal()
+
+        XCTAssertEqual(results, ["a": .cancelled, "b": .superseded])
+        XCTAssertEqual(view.layoutAdapter.currentArrangement.first?.items.count, 1)
+    }
+
+    func testRequestsEndWhenTheAdapterIsDeallocated() {
+        let tableView = UITableView()
+        var adapter: ReloadableViewLayoutAdapter? = ReloadableViewLayoutAdapter(reloadableView: tableView)
+        var result: CoalescedReloadResult?
+        adapter?.requestReload(width: 320, layoutProvider: { self.layouts(count: 3) }, completion: { result = $0 })
+
+        adapter = nil
+        XCTAssertEqual(result, .cancelled)
+    }
+
+    func testRequestsEndWhenTheReloadableViewIsDeallocated() {
+        var adapter: ReloadableViewLayoutAdapter?
+        autoreleasepool {
+            adapter = ReloadableViewLayoutAdapter(reloadableView: UITableView())
+        }
+        XCTAssertNil(adapter?.reloadableView)
+        adapter?.reloadCoalescingInterval = 0
+
+        var result: CoalescedReloadResult?
+        adapter?.requestReload(width: 320, layoutProvider: { self.layouts(count: 3) }, completion: { result = $0 })
+        waitUntil { result != nil }
+        XCTAssertEqual(result, .cancelled)
+        XCTAssertNil(adapter?.reloadCoalescer.pending)
+    }
+
+    private func makeView() -> LayoutAdapterTableView {
+        let view = LayoutAdapterTableView(frame: CGRect(x: 0, y: 0, width: 320, height: 100), style: .plain)
+        view.layoutAdapter.reloadCoalescingInterval = 0
+        return view
+    }
+
+    private func layouts(count: Int) -> [Section<[Layout]>] {
+        let items: [Layout] = (0..<count).map { _ in SizeLayout<View>(height: 10) }
+        return [Section(items: items)]
+    }
+
+    /// Runs the main run loop until the condition is true, so that the coalescing window can close.
+    private func waitUntil(timeout: TimeInterval = 10, _ condition: () -> Bool) {
+        let deadline = Date(timeIntervalSinceNow: timeout)
+        while !condition() && Date() < deadline {
+            RunLoop.main.run(until: Date(timeIntervalSinceNow: 0.01))
+        }
+        XCTAssertTrue(condition())
+    }
+}
+
+/// A layout that signals when it starts being measured and then waits until its gate is opened.
+private class BlockingLayout: SizeLayout<View> {
+
+    let started = DispatchSemaphore(value: 0)
+    let gate = DispatchSemaphore(value: 0)
+
+    init() {
+        super.init(minHeight: 10, maxHeight: 10)
+    }
+
+    override func measurement(within maxSize: CGSize) -> LayoutMeasurement {
+        started.signal()
+        gate.wait()
+        return super.measurement(within: maxSize)
+    }
+}
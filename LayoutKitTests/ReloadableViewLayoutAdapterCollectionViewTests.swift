@@ -38,6 +38,52 @@ class ReloadableViewLayoutAdapterCollectionViewTests: ReloadableViewLayoutAdapte
     func testCollectionViewReloadAsyncCancelledOnViewDeinit() {
         verifyReloadAsyncCancelledOnViewDeinit(TestCollectionView())
     }
+
+    func testCollectionViewReloadSyncConcurrently() {
+        let view = TestCollectionView()
+        view.layoutAdapter.layoutItemsConcurrently = true
+        verifyReloadSync(view)
+    }
+
+    func testCollectionViewReloadAsyncConcurrently() {
+        let view = TestCollectionView()
+        view.layoutAdapter.layoutItemsConcurrently = true
+        verifyReloadAsync(view)
+    }
+
+    func testCollectionViewReloadAsyncConcurrentlyCancelsPreviousLayout() {
+        let view = TestCollectionView()
+        view.layoutAdapter.layoutItemsConcurrently = true
+        verifyReloadAsyncCancelsPreviousLayout(view)
+    }
+
+    func testConcurrentArrangementsAreInIndexOrder() {
+        let layouts: [Layout] = (0..<100).map { index in
+            SizeLayout<View>(width: 10, height: CGFloat(index + 1))
+        }
+        var arrangements = [LayoutArrangement]()
+        let completed = ReloadableViewLayoutAdapter.concurrentArrangements(
+            of: layouts,
+            layoutFunc: { $0.arrangement(width: 320) },
+            isCancelled: { false },
+            batchCompleted: { arrangements.append(contentsOf: $0) })
+
+        XCTAssertTrue(completed)
+        XCTAssertEqual(arrangements.map { $0.frame.height }, (0..<100).map { CGFloat($0 + 1) })
+    }
+
+    func testConcurrentArrangementsStopWhenCancelled() {
+        let layouts: [Layout] = (0..<1000).map { _ in SizeLayout<View>(width: 10, height: 10) }
+        var batchCount = 0
+        let completed = ReloadableViewLayoutAdapter.concurrentArrangements(
+            of: layouts,
+            layoutFunc: { $0.arrangement(width: 320) },
+            isCancelled: { batchCount > 0 },
+            batchCompleted: { _ in batchCount += 1 })
+
+        XCTAssertFalse(completed)
+        XCTAssertEqual(batchCount, 1)
+    }
 }
 
 private class TestCollectionView: LayoutAdapterCollectionView, TestableReloadableView {
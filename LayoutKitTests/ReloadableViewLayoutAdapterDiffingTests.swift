@@ -0,0 +1,165 @@
+// Copyright 2019 LinkedIn Corp.
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+
+import XCTest
+@testable import LayoutKit
+
+class ReloadableViewLayoutAdapterDiffingTests: XCTestCase {
+
+    func testListDiff() {
+        let diff = ListDiff(old: ["a", "b", "c", "d"], new: ["b", "a", "d", "e"])
+        XCTAssertEqual(diff.deletedIndexes, [2])
+        XCTAssertEqual(diff.insertedIndexes, [3])
+        XCTAssertEqual(diff.matches.map { $0?.oldIndex }, [1, 0, 3, nil])
+        // Only one of a and b has to move.
+        XCTAssertEqual(diff.matches.compactMap { $0 }.filter { $0.isMoved }.count, 1)
+        XCTAssertEqual(diff.matches[2]?.isMoved, false)
+    }
+
+    func testListDiffMatchesRepeatedIdsNextToUniqueIds() {
+        let diff = ListDiff(old: ["a", "x", "x", "b"], new: ["a", "x", "x", "b", "x"])
+        XCTAssertEqual(diff.matches.map { $0?.oldIndex }, [0, 1, 2, 3, nil])
+        XCTAssertEqual(diff.insertedIndexes, [4])
+        XCTAssertEqual(diff.deletedIndexes, [])
+    }
+
+    func testItemUpdates() {
+        let old = [section("s", items: [("a", 0), ("b", 0), ("c", 0), ("d", 0)])]
+        let new = [section("s", items: [("b", 0), ("a", 0), ("c", 1), ("e", 0)])]
+
+        let updates = ReloadableViewLayoutAdapter.batchUpdatesFrom(old, to: new)
+        XCTAssertEqual(updates.deleteItems, [IndexPath(item: 3, section: 0)])
+        XCTAssertEqual(updates.insertItems, [IndexPath(item: 3, section: 0)])
+        XCTAssertEqual(updates.reloadItems, [IndexPath(item: 2, section: 0)])
+        XCTAssertEqual(updates.moveItems.count, 1)
+        XCTAssertTrue(updates.insertSections.isEmpty)
+        XCTAssertTrue(updates.deleteSections.isEmpty)
+    }
+
+    func testMovedItemWithChangedContentIsDeletedAndInserted() {
+        let old = [section("s", items: [("a", 0), ("b", 0)])]
+        let new = [section("s", items: [("b", 1), ("a", 0)])]
+
+        let updates = ReloadableViewLayoutAdapter.batchUpdatesFrom(old, to: new)
+        XCTAssertTrue(updates.reloadItems.isEmpty)
+        XCTAssertEqual(updates.moveItems.count + updates.deleteItems.count, 1)
+        XCTAssertEqual(updates.deleteItems.count, updates.insertItems.count)
+    }
+
+    func testSectionUpdates() {
+        let old = [
+            section("s0", items: [("a", 0)]),
+            section("s1", items: [("b", 0)]),
+            section("s2", items: [("c", 0)], header: 0),
+            section("s3", items: [("d", 0)])
+        ]
+        let new = [
+            section("s1", items: [("b", 0)]),
+            section("s0", items: [("a", 0)]),
+            section("s2", items: [("c", 0)], header: 1),
+            section("s4", items: [("e", 0)])
+        ]
+
+        let updates = ReloadableViewLayoutAdapter.batchUpdatesFrom(old, to: new)
+        XCTAssertEqual(updates.deleteSections, IndexSet([3]))
+        XCTAssertEqual(updates.insertSections, IndexSet([3]))
+        XCTAssertEqual(updates.reloadSections, IndexSet([2]))
+        XCTAssertEqual(updates.moveSections.count, 1)
+        XCTAssertTrue(updates.insertItems.isEmpty)
+        XCTAssertTrue(updates.deleteItems.isEmpty)
+    }
+
+    func testItemsOfUnchangedContentReuseArrangements() {
+        let view = LayoutAdapterTableView(frame: CGRect(x: 0, y: 0, width: 320, height: 100), style: .plain)
+        var madeLayouts = 0
+        let makeSections = { (items: [(String, Int)]) -> () -> [IdentifiedSection] in
+            return {
+                let identified = items.map { id, content in
+                    return IdentifiedLayout(id: id, content: content, makeLayout: { () -> Layout in
+                        madeLayouts += 1
+                        return SizeLayout<View>(height: CGFloat(10 + content))
+                    })
+                }
+                return [IdentifiedSection(id: "s", items: identified)]
+            }
+        }
+
+        view.layoutAdapter.reloadDiffing(width: 320, synchronous: true, sectionProvider: makeSections([("a", 0), ("b", 0)]))
+        XCTAssertEqual(madeLayouts, 2)
+        let first = view.layoutAdapter.currentArrangement[0].items
+
+        view.layoutAdapter.reloadDiffing(width: 320, synchronous: true, sectionProvider: makeSections([("b", 0), ("a", 1), ("c", 0)]))
+        XCTAssertEqual(madeLayouts, 4)
+        let second = view.layoutAdapter.currentArrangement[0].items
+        XCTAssertTrue((second[0].layout as AnyObject) === (first[1].layout as AnyObject))
+        XCTAssertFalse((second[1].layout as AnyObject) === (first[0].layout as AnyObject))
+        XCTAssertEqual(second[1].frame.height, 11)
+
+        // Arrangements of a different width can't be reused.
+        view.layoutAdapter.reloadDiffing(width: 300, synchronous: true, sectionProvider: makeSections([("b", 0)]))
+        XCTAssertEqual(madeLayouts, 5)
+
+        // Arrangements that another reload is about to replace can't be reused.
+        view.layoutAdapter.backgroundLayoutQueue.isSuspended = true
+        view.layoutAdapter.reload(width: 300, layoutProvider: { [Section(items: [SizeLayout<View>(height: 10)] as [Layout])] })
+        view.layoutAdapter.reloadDiffing(width: 300, synchronous: true, sectionProvider: makeSections([("b", 0)]))
+        XCTAssertEqual(madeLayouts, 6)
+        view.layoutAdapter.backgroundLayoutQueue.isSuspended = false
+    }
+
+    func testAsynchronousReloadDiffing() {
+        let view = LayoutAdapterTableView(frame: CGRect(x: 0, y: 0, width: 320, height: 100), style: .plain)
+        let sections = { (count: Int) -> () -> [IdentifiedSection] in
+            return {
+                let items = (0..<count).map { index in
+                    return IdentifiedLayout(id: index, content: 0, makeLayout: { SizeLayout<View>(height: 10) })
+                }
+                return [IdentifiedSection(id: 0, items: items)]
+            }
+        }
+
+        for count in [10, 5] {
+            let completionExpectation = expectation(description: "completion")
+            view.layoutAdapter.reloadDiffing(width: 320, sectionProvider: sections(count), completion: {
+                completionExpectation.fulfill()
+            })
+            waitForExpectations(timeout: 10, handler: nil)
+            XCTAssertEqual(view.layoutAdapter.currentArrangement[0].items.count, count)
+            XCTAssertEqual(view.numberOfRows(inSection: 0), count)
+            XCTAssertNotNil(view.layoutAdapter.currentIdentities)
+        }
+
+        // A regular reload forgets the identities.
+        let items: [Layout] = [SizeLayout<View>(height: 10)]
+        view.layoutAdapter.reload(width: 320, synchronous: true, layoutProvider: { [Section(items: items)] })
+        XCTAssertNil(view.layoutAdapter.currentIdentities)
+    }
+
+    func testLargeListDiff() {
+        let count = 10_000
+        let old = [SectionIdentity(id: 0, header: nil, items: (0..<count).map { ItemIdentity(id: $0, content: 0) }, footer: nil)]
+        var newItems = old[0].items.filter { $0.id != AnyHashable(5) }
+        newItems.insert(ItemIdentity(id: count, content: 0), at: 100)
+        newItems.swapAt(200, 9_000)
+        newItems[300] = ItemIdentity(id: newItems[300].id, content: 1)
+        let new = [SectionIdentity(id: 0, header: nil, items: newItems, footer: nil)]
+
+        var updates = BatchUpdates()
+        measure {
+            updates = ReloadableViewLayoutAdapter.batchUpdatesFrom(old, to: new)
+        }
+        XCTAssertEqual(updates.deleteItems, [IndexPath(item: 5, section: 0)])
+        XCTAssertEqual(updates.insertItems, [IndexPath(item: 100, section: 0)])
+        XCTAssertEqual(updates.reloadItems.count, 1)
+        XCTAssertEqual(updates.moveItems.count, 2)
+    }
+
+    private func section(_ id: String, items: [(String, Int)], header: Int? = nil) -> SectionIdentity {
+        return SectionIdentity(id: id, header: header, items: items.map { ItemIdentity(id: $0.0, content: $0.1) }, footer: nil)
+    }
+}
@@ -0,0 +1,137 @@
+// Copyright 2019 LinkedIn Corp.
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+
+import XCTest
+@testable import LayoutKit
+
+class ReloadableViewLayoutAdapterEvictionTests: XCTestCase {
+
+    // Items are 10 points high, so items 0 to 10 intersect the visible bounds and items 0 to 21 are near them.
+    private func makeAdapter(view: StackedReloadableView) -> ReloadableViewLayoutAdapter {
+        let adapter = ReloadableViewLayoutAdapter(reloadableView: view)
+        let items: [Layout] = (0..<100).map { _ in
+            StackLayout(axis: .vertical, sublayouts: [SizeLayout<View>(height: 10)])
+        }
+        adapter.itemLayoutProvider = { items[$0.item] }
+        adapter.reload(width: 320, synchronous: true, layoutProvider: { [Section(items: items)] })
+        return adapter
+    }
+
+    private func isEvicted(_ adapter: ReloadableViewLayoutAdapter, _ item: Int) -> Bool {
+        return adapter.isArrangementEvicted(ofItemAt: IndexPath(item: item, section: 0))
+    }
+
+    func testItemsFarthestFromTheVisibleBoundsAreEvicted() {
+        let adapter = makeAdapter(view: StackedReloadableView())
+
+        adapter.evictArrangements(keepingAtMost: 30)
+
+        let items = adapter.currentArrangement[0].items
+        XCTAssertEqual((0..<100).filter({ !isEvicted(adapter, $0) }).count, 30)
+        XCTAssertFalse(isEvicted(adapter, 29))
+        XCTAssertTrue(isEvicted(adapter, 30))
+        XCTAssertTrue(items[99].sublayouts.isEmpty)
+        XCTAssertEqual(items[99].frame, CGRect(x: 0, y: 0, width: 320, height: 10))
+
+        // Items near the visible bounds are kept whatever the budget.
+        adapter.evictArrangements(keepingAtMost: 0)
+        XCTAssertFalse(isEvicted(adapter, 21))
+        XCTAssertTrue(isEvicted(adapter, 22))
+    }
+
+    func testEvictedItemIsRestoredWhenItsCellIsNeeded() {
+        let adapter = makeAdapter(view: StackedReloadableView())
+        adapter.evictArrangements(keepingAtMost: 0)
+
+        let contentView = UIView()
+        adapter.makeViews(ofItemAt: IndexPath(item: 99, section: 0), in: contentView)
+        XCTAssertFalse(isEvicted(adapter, 99))
+        XCTAssertEqual(contentView.subviews.count, 1)
+        let arrangement = adapter.currentArrangement[0].items[99]
+        XCTAssertEqual(arrangement.sublayouts.count, 1)
+        XCTAssertEqual(arrangement.frame, CGRect(x: 0, y: 0, width: 320, height: 10))
+    }
+
+    func testLeastRecentlyUsedItemIsEvictedWhenTheBudgetIsExceeded() {
+        let adapter = makeAdapter(view: StackedReloadableView())
+        adapter.maxArrangedItemCount = 30
+        waitUntil { self.isEvicted(adapter, 30) }
+
+        // Of the items that kept their arrangements, the farthest from the visible bounds was used least recently.
+        adapter.makeViews(ofItemAt: IndexPath(item: 99, section: 0), in: UIView())
+        waitUntil { self.isEvicted(adapter, 29) }
+        XCTAssertFalse(isEvicted(adapter, 28))
+        XCTAssertFalse(isEvicted(adapter, 99))
+        XCTAssertEqual((0..<100).filter({ !isEvicted(adapter, $0) }).count, 30)
+    }
+
+    func testItemsNearTheVisibleBoundsAreRestoredInTheBackground() {
+        let view = StackedReloadableView()
+        let adapter = makeAdapter(view: view)
+        adapter.evictArrangements(keepingAtMost: 0)
+        XCTAssertTrue(isEvicted(adapter, 90))
+
+        view.bounds.origin.y = 900
+        adapter.evictArrangements(keepingAtMost: 0)
+        XCTAssertTrue(isEvicted(adapter, 0))
+
+        waitUntil { !self.isEvicted(adapter, 90) && !self.isEvicted(adapter, 99) }
+        XCTAssertEqual(adapter.currentArrangement[0].items[90].sublayouts.count, 1)
+    }
+
+    func testMemoryWarningOnlyEvictsItemsWithABudget() {
+        let adapter = makeAdapter(view: StackedReloadableView())
+        XCTAssertNil(adapter.maxArrangedItemCount)
+
+        NotificationCenter.default.post(name: UIApplication.didReceiveMemoryWarningNotification, object: nil)
+        XCTAssertFalse(isEvicted(adapter, 50))
+
+        // The budget is larger than the number of items, but a memory warning evicts whatever the budget.
+        adapter.maxArrangedItemCount = 1000
+        NotificationCenter.default.post(name: UIApplication.didReceiveMemoryWarningNotification, object: nil)
+        XCTAssertFalse(isEvicted(adapter, 0))
+        XCTAssertTrue(isEvicted(adapter, 50))
+    }
+
+    func testBudgetIsAppliedAfterReloads() {
+        let adapter = makeAdapter(view: StackedReloadableView())
+        adapter.maxArrangedItemCount = 40
+
+        waitUntil { self.isEvicted(adapter, 40) }
+        XCTAssertFalse(isEvicted(adapter, 39))
+    }
+
+    /// Runs the main run loop until the condition is true, so that scheduled evictions and restorations can complete.
+    private func waitUntil(timeout: TimeInterval = 10, _ condition: () -> Bool) {
+        let deadline = Date(timeIntervalSinceNow: timeout)
+        while !condition() && Date() < deadline {
+            RunLoop.main.run(until: Date(timeIntervalSinceNow: 0.01))
+        }
+        XCTAssertTrue(condition())
+    }
+}
+
+/// A reloadable view that stacks its items vertically, so its visible items are found from its bounds.
+private class StackedReloadableView: ReloadableView {
+
+    var bounds = CGRect(x: 0, y: 0, width: 320, height: 100)
+    let isTracking = false
+    let isDecelerating = false
+
+    func reloadDataSynchronously() {
+        // Nothing to reload.
+    }
+
+    func registerViews(withReuseIdentifier reuseIdentifier: String) {
+        // Nothing to register.
+    }
+
+    func perform(batchUpdates: BatchUpdates, completion: (() -> Void)?) {
+        completion?()
+    }
+}
@@ -0,0 +1,130 @@
+// Copyright 2019 LinkedIn Corp.
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+
+import XCTest
+@testable import LayoutKit
+
+class ReloadableViewLayoutAdapterIncrementalReloadTests: XCTestCase {
+
+    func testItemsAreCarriedOverThroughDeletesMovesAndInserts() {
+        let arrangement = [Section(items: (1...5).map { item(height: CGFloat($0)) })]
+        let batchUpdates = BatchUpdates()
+        batchUpdates.deleteItems = [IndexPath(item: 1, section: 0)]
+        batchUpdates.reloadItems = [IndexPath(item: 3, section: 0)]
+        batchUpdates.moveItems = [ItemMove(from: IndexPath(item: 4, section: 0), to: IndexPath(item: 2, section: 0))]
+        batchUpdates.insertItems = [IndexPath(item: 0, section: 0)]
+
+        let carriedOver = ReloadableViewLayoutAdapter.carriedOverArrangements(from: arrangement, through: batchUpdates, itemCounts: [5])
+
+        XCTAssertEqual(carriedOver[0].items.map { $0?.frame.height }, [nil, 1, 5, 3, nil])
+    }
+
+    func testSectionsAreCarriedOverThroughDeletesAndInserts() {
+        let arrangement = [
+            Section(header: item(height: 10), items: [item(height: 1)], footer: nil),
+            Section(header: item(height: 20), items: [item(height: 2), item(height: 3)], footer: nil)
+        ]
+        let batchUpdates = BatchUpdates()
+        batchUpdates.deleteSections = [0]
+        batchUpdates.insertSections = [1]
+
+        let carriedOver = ReloadableViewLayoutAdapter.carriedOverArrangements(from: arrangement, through: batchUpdates, itemCounts: [2, 1])
+
+        XCTAssertEqual(carriedOver[0].header?.frame.height, 20)
+        XCTAssertEqual(carriedOver[0].items.map { $0?.frame.height }, [2, 3])
+        XCTAssertNil(carriedOver[1].header)
+        XCTAssertEqual(carriedOver[1].items.map { $0?.frame.height }, [nil])
+    }
+
+    func testMismatchedUpdatesAreNotCarriedOver() {
+        let arrangement = [Section(items: [item(height: 1), item(height: 2)])]
+        let batchUpdates = BatchUpdates()
+        batchUpdates.insertItems = [IndexPath(item: 0, section: 0)]
+
+        // The updates say there are three items, but there are four.
+        let carriedOver = ReloadableViewLayoutAdapter.carriedOverArrangements(from: arrangement, through: batchUpdates, itemCounts: [4])
+
+        XCTAssertEqual(carriedOver[0].items.map { $0?.frame.height }, [nil, nil, nil, nil])
+    }
+
+    func testOnlyChangedItemsAreLaidOut() {
+        let view = LayoutAdapterTableView(frame: CGRect(x: 0, y: 0, width: 320, height: 1000), style: .plain)
+        let layouts = (0..<10).map { CountingLayout(height: CGFloat($0 + 1)) }
+        view.layoutAdapter.reload(width: 320, synchronous: true, layoutProvider: { [Section(items: layouts as [Layout])] })
+
+        let inserted = CountingLayout(height: 100)
+        let reloaded = CountingLayout(height: 200)
+        var newLayouts: [CountingLayout] = layouts
+        newLayouts.remove(at: 9)
+        newLayouts[2] = reloaded
+        newLayouts.insert(inserted, at: 5)
+
+        let batchUpdates = BatchUpdates()
+        batchUpdates.deleteItems = [IndexPath(item: 9, section: 0)]
+        batchUpdates.reloadItems = [IndexPath(item: 2, section: 0)]
+        batchUpdates.insertItems = [IndexPath(item: 5, section: 0)]
+        view.layoutAdapter.reloadIncrementally(width: 320, synchronous: true, batchUpdates: batchUpdates, layoutProvider: {
+            [Section(items: newLayouts as [Layout])]
+        })
+
+        XCTAssertEqual(inserted.measurementCount, 1)
+        XCTAssertEqual(reloaded.measurementCount, 1)
+        XCTAssertEqual(layouts.map { $0.measurementCount }, [Int](repeating: 1, count: 10))
+        XCTAssertEqual(view.layoutAdapter.currentArrangement[0].items.map { $0.frame.height }, [1, 2, 200, 4, 5, 100, 6, 7, 8, 9])
+        XCTAssertTrue(view.layoutAdapter.currentArrangement[0].items[0].layout is CarriedOverLayout)
+    }
+
+    func testDifferentWidthLaysOutAllItems() {
+        let view = LayoutAdapterTableView(frame: CGRect(x: 0, y: 0, width: 320, height: 1000), style: .plain)
+        let layouts = (0..<3).map { CountingLayout(height: CGFloat($0 + 1)) }
+        view.layoutAdapter.reload(width: 320, synchronous: true, layoutProvider: { [Section(items: layouts as [Layout])] })
+
+        view.layoutAdapter.reloadIncrementally(width: 200, synchronous: true, batchUpdates: BatchUpdates(), layoutProvider: {
+            [Section(items: layouts as [Layout])]
+        })
+
+        XCTAssertEqual(layouts.map { $0.measurementCount }, [2, 2, 2])
+    }
+
+    func testArrangementThatWasNotAppliedByAReloadLaysOutAllItems() {
+        let view = LayoutAdapterTableView(frame: CGRect(x: 0, y: 0, width: 320, height: 1000), style: .plain)
+        let layouts = (0..<3).map { CountingLayout(height: CGFloat($0 + 1)) }
+        view.layoutAdapter.reload(width: 320, synchronous: true, layoutProvider: { [Section(items: layouts as [Layout])] })
+        XCTAssertEqual(view.layoutAdapter.currentArrangementSizeConstraint, CGSize(width: 320, height: CGFloat.greatestFiniteMagnitude))
+
+        // Like a partial arrangement that an update manager applies before the final one.
+        view.layoutAdapter.currentArrangement = view.layoutAdapter.currentArrangement
+        XCTAssertNil(view.layoutAdapter.currentArrangementSizeConstraint)
+
+        view.layoutAdapter.reloadIncrementally(width: 320, synchronous: true, batchUpdates: BatchUpdates(), layoutProvider: {
+            [Section(items: layouts as [Layout])]
+        })
+
+        XCTAssertEqual(layouts.map { $0.measurementCount }, [2, 2, 2])
+        XCTAssertEqual(view.layoutAdapter.currentArrangementSizeConstraint, CGSize(width: 320, height: CGFloat.greatestFiniteMagnitude))
+    }
+
+    private func item(height: CGFloat) -> LayoutArrangement {
+        return LayoutArrangement(layout: SizeLayout<View>(height: height), frame: CGRect(x: 0, y: 0, width: 320, height: height), sublayouts: [])
+    }
+}
+
+/// A fixed height layout that counts how many times it is measured.
+private class CountingLayout: SizeLayout<View> {
+
+    private(set) var measurementCount = 0
+
+    init(height: CGFloat) {
+        super.init(minHeight: height, maxHeight: height)
+    }
+
+    override func measurement(within maxSize: CGSize) -> LayoutMeasurement {
+        measurementCount += 1
+        return super.measurement(within: maxSize)
+    }
+}
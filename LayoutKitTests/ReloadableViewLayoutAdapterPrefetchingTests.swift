@@ -0,0 +1,160 @@
+// Copyright 2019 LinkedIn Corp.
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+
+import XCTest
+@testable import LayoutKit
+
+class ReloadableViewLayoutAdapterPrefetchingTests: XCTestCase {
+
+    private var configuredViews = [UIView]()
+
+    private func layouts(count: Int, viewReuseId: String? = nil) -> [Section<[Layout]>] {
+        let items: [Layout] = (0..<count).map { index in
+            SizeLayout<UILabel>(height: 44, viewReuseId: viewReuseId, config: { label in
+                label.text = "\(index)"
+                self.configuredViews.append(label)
+            })
+        }
+        return [Section(items: items)]
+    }
+
+    private func makeTableView(itemCount: Int, viewReuseId: String? = nil) -> LayoutAdapterTableView {
+        let view = LayoutAdapterTableView(frame: CGRect(x: 0, y: 0, width: 320, height: 100), style: .plain)
+        view.layoutAdapter.prewarmsViews = true
+        view.layoutAdapter.reload(width: 320, synchronous: true, layoutProvider: { self.layouts(count: itemCount, viewReuseId: viewReuseId) })
+        configuredViews.removeAll()
+        return view
+    }
+
+    func testCellAttachesPrewarmedViews() {
+        let view = makeTableView(itemCount: 100)
+        let adapter = view.layoutAdapter
+        let indexPath = IndexPath(item: 50, section: 0)
+
+        adapter.prewarmViews(at: [indexPath])
+        XCTAssertEqual(adapter.viewPrewarmer.pendingCount, 1)
+        adapter.viewPrewarmer.prewarmPendingItems(within: .greatestFiniteMagnitude)
+        XCTAssertEqual(adapter.viewPrewarmer.prewarmedCount, 1)
+        XCTAssertEqual(configuredViews.count, 1)
+
+        let cell = adapter.tableView(view, cellForRowAt: indexPath)
+
+        XCTAssertEqual(configuredViews.count, 1)
+        XCTAssertTrue(cell.contentView.subviews.contains(configuredViews[0]))
+        XCTAssertEqual((configuredViews[0] as? UILabel)?.text, "50")
+        XCTAssertEqual(adapter.viewPrewarmer.prewarmedCount, 0)
+    }
+
+    func testPrewarmedViewsReplaceViewsOfReusedCell() {
+        let view = makeTableView(itemCount: 100)
+        let adapter = view.layoutAdapter
+        let cell = adapter.tableView(view, cellForRowAt: IndexPath(item: 0, section: 0))
+        let oldView = configuredViews[0]
+
+        adapter.prewarmViews(at: [IndexPath(item: 1, section: 0)])
+        adapter.viewPrewarmer.prewarmPendingItems(within: .greatestFiniteMagnitude)
+        adapter.makeViews(of: adapter.currentArrangement[0].items[1], at: IndexPath(item: 1, section: 0), in: cell.contentView)
+
+        XCTAssertNil(oldView.superview)
+        XCTAssertEqual(cell.contentView.subviews.filter { $0 is UILabel }.count, 1)
+        XCTAssertEqual((cell.contentView.subviews.first { $0 is UILabel } as? UILabel)?.text, "1")
+    }
+
+    func testReusedCellRecyclesItsViewsInsteadOfPrewarmedViews() {
+        let view = makeTableView(itemCount: 100, viewReuseId: "label")
+        let adapter = view.layoutAdapter
+        let cell = adapter.tableView(view, cellForRowAt: IndexPath(item: 0, section: 0))
+        let oldView = configuredViews[0]
+
+        adapter.prewarmViews(at: [IndexPath(item: 1, section: 0)])
+        adapter.viewPrewarmer.prewarmPendingItems(within: .greatestFiniteMagnitude)
+        let prewarmedView = configuredViews[1]
+        adapter.makeViews(of: adapter.currentArrangement[0].items[1], at: IndexPath(item: 1, section: 0), in: cell.contentView)
+
+        XCTAssertTrue(oldView.superview == cell.contentView)
+        XCTAssertNil(prewarmedView.superview)
+        XCTAssertEqual(cell.contentView.subviews.filter { $0 is UILabel }.count, 1)
+        XCTAssertEqual((oldView as? UILabel)?.text, "1")
+    }
+
+    func testStaleViewsAreNotAttached() {
+        let view = makeTableView(itemCount: 10)
+        let adapter = view.layoutAdapter
+        let indexPath = IndexPath(item: 5, section: 0)
+        adapter.prewarmViews(at: [indexPath])
+        adapter.viewPrewarmer.prewarmPendingItems(within: .greatestFiniteMagnitude)
+        let prewarmedView = configuredViews[0]
+
+        adapter.reload(width: 320, synchronous: true, layoutProvider: { self.layouts(count: 10) })
+        let cell = adapter.tableView(view, cellForRowAt: indexPath)
+
+        XCTAssertFalse(cell.contentView.subviews.contains(prewarmedView))
+        XCTAssertEqual(configuredViews.count, 2)
+    }
+
+    func testCancelPrefetching() {
+        let view = makeTableView(itemCount: 10)
+        let adapter = view.layoutAdapter
+        adapter.prewarmViews(at: [IndexPath(item: 1, section: 0), IndexPath(item: 2, section: 0)])
+        adapter.viewPrewarmer.prewarmPendingItems(within: 0)
+
+        adapter.viewPrewarmer.cancel([IndexPath(item: 1, section: 0), IndexPath(item: 2, section: 0)])
+
+        XCTAssertEqual(adapter.viewPrewarmer.pendingCount, 0)
+        XCTAssertEqual(adapter.viewPrewarmer.prewarmedCount, 0)
+    }
+
+    func testPrewarmingStopsWhenBudgetIsUsedUp() {
+        let view = makeTableView(itemCount: 10)
+        let prewarmer = view.layoutAdapter.viewPrewarmer
+        var time: CFTimeInterval = 0
+        prewarmer.clock = {
+            time += 1
+            return time
+        }
+
+        view.layoutAdapter.prewarmViews(at: (0..<10).map { IndexPath(item: $0, section: 0) })
+        prewarmer.prewarmPendingItems(within: 2.5)
+
+        XCTAssertEqual(prewarmer.prewarmedCount, 3)
+        XCTAssertEqual(prewarmer.pendingCount, 7)
+    }
+
+    func testPrewarmsWhenRunLoopIsIdle() {
+        let view = makeTableView(itemCount: 10)
+        view.layoutAdapter.prewarmViews(at: [IndexPath(item: 3, section: 0)])
+
+        RunLoop.main.run(until: Date(timeIntervalSinceNow: 0.1))
+
+        XCTAssertEqual(view.layoutAdapter.viewPrewarmer.prewarmedCount, 1)
+    }
+
+    func testKeepsAtMostCapacityItems() {
+        let view = makeTableView(itemCount: 100)
+        let prewarmer = view.layoutAdapter.viewPrewarmer
+        prewarmer.capacity = 4
+
+        view.layoutAdapter.prewarmViews(at: (0..<10).map { IndexPath(item: $0, section: 0) })
+        prewarmer.prewarmPendingItems(within: .greatestFiniteMagnitude)
+
+        XCTAssertEqual(prewarmer.prewarmedCount, 4)
+    }
+
+    func testPrewarmingIsDisabledByDefault() {
+        XCTAssertFalse(ReloadableViewLayoutAdapter(reloadableView: UITableView()).prewarmsViews)
+    }
+
+    func testDoesNotPrewarmWhenDisabled() {
+        let view = makeTableView(itemCount: 10)
+        view.layoutAdapter.prewarmsViews = false
+
+        view.layoutAdapter.prewarmViews(at: [IndexPath(item: 3, section: 0)])
+
+        XCTAssertEqual(view.layoutAdapter.viewPrewarmer.pendingCount, 0)
+    }
+}
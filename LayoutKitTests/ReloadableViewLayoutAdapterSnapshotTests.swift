@@ -0,0 +1,92 @@
+// Copyright 2019 LinkedIn Corp.
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+
+import XCTest
+@testable import LayoutKit
+
+class ReloadableViewLayoutAdapterSnapshotTests: XCTestCase {
+
+    private let key = ArrangementSnapshot.Key(contentVersion: "1", width: 320)
+
+    private func makeSnapshot(itemCount: Int) throws -> ArrangementSnapshot {
+        var builder = ArrangementSnapshot.Builder(key: key)
+        builder.appendSection(header: nil, items: (0..<itemCount).map { _ in SizeLayout<View>(height: 10).arrangement(width: 320) }, footer: nil)
+        return try ArrangementSnapshot(data: builder.data())
+    }
+
+    func testOnlyItemsNearTheVisibleBoundsAreRestored() throws {
+        let view = LayoutAdapterTableView(frame: CGRect(x: 0, y: 0, width: 320, height: 100), style: .plain)
+        let snapshot = try makeSnapshot(itemCount: 100)
+        var madeLayouts = 0
+        let layoutProvider = { () -> [Section<LazyMapCollection<CountableRange<Int>, Layout>>] in
+            return [Section(items: (0..<100).lazy.map { _ -> Layout in
+                madeLayouts += 1
+                return SizeLayout<View>(height: 10)
+            })]
+        }
+
+        let completionExpectation = expectation(description: "completion")
+        view.layoutAdapter.backgroundLayoutQueue.isSuspended = true
+        let restored = view.layoutAdapter.reload(width: 320, restoringFrom: snapshot, contentVersion: "1", layoutProvider: layoutProvider, completion: {
+            completionExpectation.fulfill()
+        })
+
+        // The visible bounds and one screen on each side reach down to the item at 200 points.
+        XCTAssertTrue(restored)
+        XCTAssertEqual(madeLayouts, 21)
+        let items = view.layoutAdapter.currentArrangement[0].items
+        XCTAssertEqual(items.count, 100)
+        XCTAssertFalse(items[20].layout is PlaceholderLayout)
+        XCTAssertTrue(items[21].layout is PlaceholderLayout)
+        XCTAssertEqual(items[99].frame.height, 10)
+
+        // The background reload fills in the rest.
+        view.layoutAdapter.backgroundLayoutQueue.isSuspended = false
+        waitForExpectations(timeout: 10, handler: nil)
+        XCTAssertFalse(view.layoutAdapter.currentArrangement[0].items.contains { $0.layout is PlaceholderLayout })
+    }
+
+    func testMismatchedSnapshotIsNotRestored() throws {
+        let view = LayoutAdapterTableView(frame: CGRect(x: 0, y: 0, width: 320, height: 100), style: .plain)
+        let snapshot = try makeSnapshot(itemCount: 10)
+        view.layoutAdapter.backgroundLayoutQueue.isSuspended = true
+        defer { view.layoutAdapter.backgroundLayoutQueue.isSuspended = false }
+
+        XCTAssertFalse(view.layoutAdapter.reload(width: 320, restoringFrom: snapshot, contentVersion: "2", layoutProvider: {
+            [Section(items: [SizeLayout<View>(height: 10)] as [Layout])]
+        }))
+        XCTAssertFalse(view.layoutAdapter.reload(width: 320, restoringFrom: snapshot, contentVersion: "1", layoutProvider: {
+            [Section(items: [SizeLayout<View>(height: 10)] as [Layout])]
+        }))
+    }
+
+    func testSnapshotOfEvictedItemsHasTheirFrames() throws {
+        let view = LayoutAdapterTableView(frame: CGRect(x: 0, y: 0, width: 320, height: 100), style: .plain)
+        let layouts: [Layout] = (0..<100).map { _ in StackLayout(axis: .vertical, sublayouts: [SizeLayout<View>(height: 10)]) }
+        view.layoutAdapter.reload(width: 320, synchronous: true, layoutProvider: { [Section(items: layouts)] })
+        view.layoutAdapter.itemLayoutProvider = { layouts[$0.item] }
+        view.layoutAdapter.maxArrangedItemCount = 30
+        view.layoutAdapter.evictArrangements(keepingAtMost: 30)
+        XCTAssertTrue(view.layoutAdapter.isArrangementEvicted(ofItemAt: IndexPath(item: 99, section: 0)))
+
+        var data: Data?
+        let completionExpectation = expectation(description: "completion")
+        view.layoutAdapter.snapshotData(for: key, completion: {
+            data = $0
+            completionExpectation.fulfill()
+        })
+        waitForExpectations(timeout: 10, handler: nil)
+        guard let snapshotData = data else {
+            return XCTFail("no snapshot")
+        }
+
+        let snapshot = try ArrangementSnapshot(data: snapshotData)
+        XCTAssertEqual(snapshot.arrangement(of: layouts[99], forItem: 99, inSection: 0)?.sublayouts.count, 1)
+        XCTAssertTrue(view.layoutAdapter.isArrangementEvicted(ofItemAt: IndexPath(item: 99, section: 0)))
+    }
+}
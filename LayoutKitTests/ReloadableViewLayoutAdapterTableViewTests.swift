@@ -38,6 +38,24 @@ class ReloadableViewLayoutAdapterTableViewTests: ReloadableViewLayoutAdapterTest
     func testTableViewReloadAsyncCancelledOnViewDeinit() {
         verifyReloadAsyncCancelledOnViewDeinit(TestTableView())
     }
+
+    func testTableViewReloadSyncConcurrently() {
+        let view = TestTableView()
+        view.layoutAdapter.layoutItemsConcurrently = true
+        verifyReloadSync(view)
+    }
+
+    func testTableViewReloadAsyncConcurrently() {
+        let view = TestTableView()
+        view.layoutAdapter.layoutItemsConcurrently = true
+        verifyReloadAsync(view)
+    }
+
+    func testTableViewReloadAsyncConcurrentlyCancelsPreviousLayout() {
+        let view = TestTableView()
+        view.layoutAdapter.layoutItemsConcurrently = true
+        verifyReloadAsyncCancelsPreviousLayout(view)
+    }
 }
 
 private class TestTableView: LayoutAdapterTableView, TestableReloadableView {
@@ -0,0 +1,119 @@
+// Copyright 2019 LinkedIn Corp.
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+
+import XCTest
+@testable import LayoutKit
+
+class ReloadableViewLayoutAdapterViewportTests: XCTestCase {
+
+    func testVisibleItemsAreShownFirst() {
+        let view = SnapshottingTableView()
+        view.layoutAdapter.prioritizesVisibleItems = true
+        view.layoutAdapter.visibleItemsPrefetchFactor = 0
+        view.layoutAdapter.estimatedItemSize = CGSize(width: 320, height: 10)
+
+        let completionExpectation = expectation(description: "completion")
+        view.layoutAdapter.reload(width: 320, layoutProvider: { self.layouts(count: 1000, height: 10) }, completion: {
+            completionExpectation.fulfill()
+        })
+        waitForExpectations(timeout: 10, handler: nil)
+
+        guard let first = view.snapshots.first else {
+            XCTFail("expected the visible items to be shown before the reload completed")
+            return
+        }
+        XCTAssertEqual(first[0].items.count, 1000)
+        XCTAssertFalse(first[0].items[0].layout is PlaceholderLayout)
+        XCTAssertFalse(first[0].items[9].layout is PlaceholderLayout)
+        XCTAssertTrue(first[0].items[999].layout is PlaceholderLayout)
+
+        let final = view.layoutAdapter.currentArrangement
+        XCTAssertFalse(final[0].items.contains { $0.layout is PlaceholderLayout })
+        XCTAssertEqual(final[0].items[999].frame.height, 10)
+    }
+
+    func testReloadWhileScrolledKeepsVisibleItemInPlace() {
+        let view = SnapshottingTableView()
+        view.layoutAdapter.reload(width: 320, synchronous: true, layoutProvider: { self.layouts(count: 1000, height: 10) })
+        view.contentOffset = CGPoint(x: 0, y: 5000)
+        view.snapshots.removeAll()
+
+        view.layoutAdapter.prioritizesVisibleItems = true
+        let completionExpectation = expectation(description: "completion")
+        view.layoutAdapter.reload(width: 320, layoutProvider: { self.layouts(count: 1000, height: 20) }, completion: {
+            completionExpectation.fulfill()
+        })
+        waitForExpectations(timeout: 10, handler: nil)
+
+        // Item 500 was at the top, so it is laid out first and stays at the top.
+        XCTAssertFalse(view.snapshots.first?[0].items[500].layout is PlaceholderLayout)
+        XCTAssertEqual(view.contentOffset.y, 500 * 20)
+    }
+
+    func testItemIndexPathsWithinOffsets() {
+        let item = LayoutArrangement(layout: PlaceholderLayout(), frame: CGRect(x: 0, y: 0, width: 320, height: 10), sublayouts: [])
+        let header = LayoutArrangement(layout: PlaceholderLayout(), frame: CGRect(x: 0, y: 0, width: 320, height: 5), sublayouts: [])
+        let arrangement = [
+            Section(header: header, items: [item, item], footer: nil),
+            Section(header: header, items: [item, item], footer: nil)
+        ]
+
+        let indexPaths = ReloadableViewLayoutAdapter.itemIndexPaths(from: 15, to: 30, in: arrangement, axis: .vertical)
+        XCTAssertEqual(indexPaths, [IndexPath(item: 1, section: 0), IndexPath(item: 0, section: 1)])
+        XCTAssertEqual(ReloadableViewLayoutAdapter.offset(of: IndexPath(item: 1, section: 1), in: arrangement, axis: .vertical), 40)
+
+        let viewport = ReloadableViewLayoutAdapter.viewport(of: CGRect(x: 0, y: 33, width: 320, height: 100), in: arrangement, axis: .vertical)
+        XCTAssertEqual(viewport.anchor?.indexPath, IndexPath(item: 0, section: 1))
+        XCTAssertEqual(viewport.anchor?.offset, 3)
+    }
+
+    func testStackedItemOffsetsMatchTheArrangement() {
+        let item = LayoutArrangement(layout: PlaceholderLayout(), frame: CGRect(x: 0, y: 0, width: 320, height: 10), sublayouts: [])
+        let header = LayoutArrangement(layout: PlaceholderLayout(), frame: CGRect(x: 0, y: 0, width: 320, height: 5), sublayouts: [])
+        var offsets = StackedItemOffsets(headers: [header, header], itemCounts: [2, 2], footers: [nil, nil], itemLength: 20, axis: .vertical)
+
+        // Items that are not laid out yet have the placeholder length.
+        XCTAssertEqual(offsets.offset(of: IndexPath(item: 1, section: 1)), 70)
+
+        for indexPath in [IndexPath(item: 0, section: 0), IndexPath(item: 1, section: 0), IndexPath(item: 0, section: 1)] {
+            offsets.setLength(of: item, at: indexPath)
+        }
+        XCTAssertEqual(offsets.itemIndexPaths(from: 15, to: 30), [IndexPath(item: 1, section: 0), IndexPath(item: 0, section: 1)])
+        XCTAssertEqual(offsets.offset(of: IndexPath(item: 1, section: 1)), 40)
+        XCTAssertNil(offsets.offset(of: IndexPath(item: 2, section: 1)))
+
+        let viewport = offsets.viewport(of: CGRect(x: 0, y: 33, width: 320, height: 100))
+        XCTAssertEqual(viewport.anchor?.indexPath, IndexPath(item: 0, section: 1))
+        XCTAssertEqual(viewport.anchor?.offset, 3)
+        XCTAssertEqual(offsets.origin(of: viewport), 33)
+    }
+
+    private func layouts(count: Int, height: CGFloat) -> [Section<[Layout]>] {
+        let items: [Layout] = (0..<count).map { _ in SizeLayout<View>(height: height) }
+        return [Section(items: items)]
+    }
+}
+
+/// Records the arrangement that the table view shows each time it reloads.
+private class SnapshottingTableView: LayoutAdapterTableView {
+
+    var snapshots = [[Section<[LayoutArrangement]>]]()
+
+    init() {
+        super.init(frame: CGRect(x: 0, y: 0, width: 320, height: 100), style: .plain)
+    }
+
+    required init?(coder aDecoder: NSCoder) {
+        fatalError("init(coder:) has not been implemented")
+    }
+
+    override func reloadDataSynchronously() {
+        super.reloadDataSynchronously()
+        snapshots.append(layoutAdapter.currentArrangement)
+    }
+}
@@ -62,4 +62,70 @@ class StackLayoutFlexibilityTests: XCTestCase {
         XCTAssertEqual(stack.flexibility.horizontal, Flexibility.highFlex)
         XCTAssertEqual(stack.flexibility.vertical, nil)
     }
+
+    func testMeasuresMostFlexibleSublayoutLast() {
+        let stack = StackLayout(
+            axis: .horizontal,
+            sublayouts: [
+                SizeLayout<View>(width: 30, height: 1, flexibility: .flexible),
+                SizeLayout<View>(width: 30, height: 1, flexibility: .inflexible),
+            ]
+        )
+        let arrangement = stack.arrangement(width: 40)
+        XCTAssertEqual(arrangement.sublayouts.map { $0.frame.width }, [10, 30])
+        XCTAssertEqual(arrangement.sublayouts.map { $0.frame.minX }, [0, 10])
+    }
+
+    func testStretchesSingleFlexibleSublayout() {
+        let stack = StackLayout(
+            axis: .horizontal,
+            sublayouts: [
+                SizeLayout<View>(minWidth: 10, minHeight: 1, flexibility: .inflexible),
+                SizeLayout<View>(minWidth: 10, minHeight: 1, flexibility: .flexible),
+                SizeLayout<View>(minWidth: 10, minHeight: 1, flexibility: .inflexible),
+            ]
+        )
+        let arrangement = stack.arrangement(width: 50)
+        XCTAssertEqual(arrangement.sublayouts.map { $0.frame.width }, [10, 30, 10])
+    }
+
+    func testStretchesMostFlexibleSublayout() {
+        let stack = StackLayout(
+            axis: .vertical,
+            sublayouts: [
+                SizeLayout<View>(minWidth: 1, minHeight: 10, flexibility: .low),
+                SizeLayout<View>(minWidth: 1, minHeight: 10, flexibility: .high),
+                SizeLayout<View>(minWidth: 1, minHeight: 10, flexibility: .flexible),
+                SizeLayout<View>(minWidth: 1, minHeight: 10, flexibility: .inflexible),
+            ]
+        )
+        let arrangement = stack.arrangement(height: 60)
+        XCTAssertEqual(arrangement.sublayouts.map { $0.frame.height }, [10, 30, 10, 10])
+    }
+
+    func testStretchesMinimumFlexSublayout() {
+        let minimumFlexibility = Flexibility(horizontal: Flexibility.minFlex, vertical: Flexibility.minFlex)
+        let stack = StackLayout(
+            axis: .horizontal,
+            sublayouts: [
+                SizeLayout<View>(minWidth: 10, minHeight: 1, flexibility: minimumFlexibility),
+                SizeLayout<View>(minWidth: 10, minHeight: 1, flexibility: .inflexible),
+                SizeLayout<View>(minWidth: 10, minHeight: 1, flexibility: .inflexible),
+            ]
+        )
+        let arrangement = stack.arrangement(width: 50)
+        XCTAssertEqual(arrangement.sublayouts.map { $0.frame.width }, [30, 10, 10])
+    }
+
+    func testDoesNotStretchInflexibleSublayouts() {
+        let stack = StackLayout(
+            axis: .horizontal,
+            sublayouts: [
+                SizeLayout<View>(minWidth: 10, minHeight: 1, flexibility: .inflexible),
+                SizeLayout<View>(minWidth: 10, minHeight: 1, flexibility: .inflexible),
+            ]
+        )
+        let arrangement = stack.arrangement(width: 50)
+        XCTAssertEqual(arrangement.sublayouts.map { $0.frame.width }, [10, 10])
+    }
 }
@@ -117,6 +117,30 @@ class StackViewTests: XCTestCase {
         XCTAssertEqual(stackView.subviews.count, 0)
     }
 
+    func testSetNeedsLayoutMeasuresSubviewsAgain() {
+        let view1 = CountingView(width: 7, height: 14)
+        let view2 = CountingView(width: 18, height: 18.5)
+        let stackView = StackView(axis: .vertical, spacing: 3)
+        stackView.addArrangedSubviews([view1, view2])
+
+        stackView.frame = CGRect(origin: .zero, size: stackView.intrinsicContentSize)
+        stackView.layoutIfNeeded()
+        let measuredCount = view1.measuredCount
+
+        // The bounds don't change, but the subviews may have.
+        stackView.setNeedsLayout()
+        stackView.layoutIfNeeded()
+        XCTAssertGreaterThan(view1.measuredCount, measuredCount)
+        XCTAssertEqual(view2.frame, CGRect(x: 0, y: 14 + 3, width: 18, height: 18.5))
+
+        let view3 = CountingView(width: 10, height: 10)
+        stackView.addArrangedSubviews([view3])
+        XCTAssertEqual(stackView.intrinsicContentSize, CGSize(width: 18, height: 14 + 3 + 18.5 + 3 + 10))
+        stackView.frame = CGRect(origin: .zero, size: stackView.intrinsicContentSize)
+        stackView.layoutIfNeeded()
+        XCTAssertEqual(view3.frame, CGRect(x: 0, y: 14 + 3 + 18.5 + 3, width: 18, height: 10))
+    }
+
     func testUIStackViewAutomaticallyInvalidatesIntrinsicContentSizeWhenContentChanges() {
         if #available(iOS 9.0, *) {
             let label = UILabel(text: "Nick", font: UIFont(name: "Helvetica", size: 17)!)
@@ -171,3 +195,14 @@ class FixedSizeView: UIView {
         return sizeThatFits(CGSize(width: CGFloat.greatestFiniteMagnitude, height: CGFloat.greatestFiniteMagnitude))
     }
 }
+
+/// A fixed size view that counts how many times it is measured.
+class CountingView: FixedSizeView {
+
+    private(set) var measuredCount = 0
+
+    override func sizeThatFits(_ size: CGSize) -> CGSize {
+        measuredCount += 1
+        return super.sizeThatFits(size)
+    }
+}
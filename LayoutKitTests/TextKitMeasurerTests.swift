@@ -0,0 +1,85 @@
+// Copyright 2019 LinkedIn Corp.
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+
+import XCTest
+import LayoutKit
+
+class TextKitMeasurerTests: XCTestCase {
+
+    // Wraps onto 3 lines by word and 2 lines by character at this width, like in `LabelLayoutTests`.
+    private static let sampleText = "Lorem ipsum dolor sit amet, consectetuer adipiscing elit. Aenean comm"
+    private static let maxSize = CGSize(width: 305, height: CGFloat.greatestFiniteMagnitude)
+
+    func testLineCounts() {
+        let measurer = TextKitMeasurer.current
+        let font = LabelLayoutDefaults.defaultFont
+        let text = Text.unattributed(TextKitMeasurerTests.sampleText)
+
+        let wrapped = measurer.metrics(of: text, font: font, within: TextKitMeasurerTests.maxSize)
+        XCTAssertEqual(wrapped.lineCount, 3)
+
+        let charWrapped = measurer.metrics(of: text, font: font, lineBreakMode: .byCharWrapping, within: TextKitMeasurerTests.maxSize)
+        XCTAssertEqual(charWrapped.lineCount, 2)
+
+        let truncated = measurer.metrics(of: text, font: font, numberOfLines: 2, within: TextKitMeasurerTests.maxSize)
+        XCTAssertEqual(truncated.lineCount, 2)
+        XCTAssertLessThan(truncated.size.height, wrapped.size.height)
+
+        let empty = measurer.metrics(of: .unattributed(""), font: font, within: TextKitMeasurerTests.maxSize)
+        XCTAssertEqual(empty, TextMetrics(size: .zero, lineCount: 0))
+    }
+
+    func testNumberOfLinesIsExact() {
+        for numberOfLines in 0...3 {
+            let layout = LabelLayout(text: TextKitMeasurerTests.sampleText, numberOfLines: numberOfLines, measurementBackend: .textKit)
+            let label = UILabel(text: TextKitMeasurerTests.sampleText, numberOfLines: numberOfLines)
+            XCTAssertEqual(layout.measurement(within: TextKitMeasurerTests.maxSize).size,
+                           label.sizeThatFits(TextKitMeasurerTests.maxSize),
+                           "numberOfLines: \(numberOfLines)")
+        }
+    }
+
+    func testCustomLineHeightFallsBackToBoundingRect() {
+        let textKit = LabelLayout(text: TextKitMeasurerTests.sampleText, lineHeight: 40, numberOfLines: 2, measurementBackend: .textKit)
+        let boundingRect = LabelLayout(text: TextKitMeasurerTests.sampleText, lineHeight: 40, numberOfLines: 2, measurementBackend: .boundingRect)
+        XCTAssertEqual(textKit.measurement(within: TextKitMeasurerTests.maxSize).size,
+                       boundingRect.measurement(within: TextKitMeasurerTests.maxSize).size)
+    }
+
+    func testBatchMatchesSingleMeasurements() {
+        let font = UIFont.helvetica()
+        let requests = [
+            TextMeasurementRequest(text: .unattributed("Hi"), font: font, maxSize: TextKitMeasurerTests.maxSize),
+            TextMeasurementRequest(text: .unattributed(TextKitMeasurerTests.sampleText), font: font, numberOfLines: 1, maxSize: TextKitMeasurerTests.maxSize),
+            TextMeasurementRequest(text: .attributed(NSAttributedString(string: TextKitMeasurerTests.sampleText)), font: font, maxSize: CGSize(width: 100, height: 40)),
+        ]
+
+        let measurer = TextKitMeasurer.current
+        let batch = measurer.metrics(of: requests)
+        let single = requests.map {
+            measurer.metrics(of: $0.text, font: $0.font, lineBreakMode: $0.lineBreakMode, numberOfLines: $0.numberOfLines, within: $0.maxSize)
+        }
+        XCTAssertEqual(batch, single)
+        XCTAssertEqual(batch[1].lineCount, 1)
+        XCTAssertLessThanOrEqual(batch[2].size.height, 40)
+    }
+
+    func testEachThreadHasItsOwnMeasurer() {
+        let measurer = TextKitMeasurer.current
+        XCTAssertTrue(measurer === TextKitMeasurer.current)
+
+        var otherMeasurer: TextKitMeasurer?
+        let measured = expectation(description: "measured")
+        DispatchQueue.global().async {
+            otherMeasurer = TextKitMeasurer.current
+            measured.fulfill()
+        }
+        waitForExpectations(timeout: 10, handler: nil)
+        XCTAssertFalse(measurer === otherMeasurer)
+    }
+}
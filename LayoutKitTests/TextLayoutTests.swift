@@ -0,0 +1,64 @@
+// Copyright 2019 LinkedIn Corp.
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+
+import XCTest
+import LayoutKit
+
+/// Measures every character as a square that is as wide as the font size, and wraps lines at any character.
+private struct MonospaceTextMeasurer: TextMeasuring {
+
+    func size(of text: String, font: CGFloat, within maxSize: CGSize) -> CGSize {
+        let fitsOnOneLine = CGFloat(text.count) * font <= maxSize.width
+        let charactersPerLine = fitsOnOneLine ? max(1, text.count) : max(1, Int(maxSize.width / font))
+        let lineCount = (text.count + charactersPerLine - 1) / charactersPerLine
+        let width = CGFloat(min(text.count, charactersPerLine)) * font
+        return CGSize(width: width, height: CGFloat(lineCount) * font)
+    }
+}
+
+class TextLayoutTests: XCTestCase {
+
+    func testMeasuresWithMeasurer() {
+        let layout = TextLayout<MonospaceTextMeasurer, View>(text: "Hello", font: 10, measurer: MonospaceTextMeasurer())
+
+        XCTAssertEqual(layout.arrangement().frame, CGRect(x: 0, y: 0, width: 50, height: 10))
+        XCTAssertEqual(layout.arrangement(width: 30).frame, CGRect(x: 0, y: 0, width: 30, height: 20))
+    }
+
+    func testClipsToMaxSize() {
+        let layout = TextLayout<MonospaceTextMeasurer, View>(text: "Hello", font: 10, measurer: MonospaceTextMeasurer())
+
+        XCTAssertEqual(layout.measurement(within: CGSize(width: 30, height: 15)).size, CGSize(width: 30, height: 15))
+    }
+
+    func testEmptyText() {
+        let layout = TextLayout<MonospaceTextMeasurer, View>(text: "", font: 10, measurer: MonospaceTextMeasurer())
+
+        XCTAssertEqual(layout.arrangement().frame, .zero)
+    }
+
+    func testRoundsToDisplayScale() {
+        let originalScale = DisplayScale.current
+        defer {
+            DisplayScale.current = originalScale
+        }
+        DisplayScale.current = 2
+        let layout = TextLayout<MonospaceTextMeasurer, View>(text: "Hi", font: 10.2, measurer: MonospaceTextMeasurer())
+
+        XCTAssertEqual(layout.arrangement().frame.size, CGSize(width: 20.5, height: 10.5))
+    }
+
+    func testEqualLayoutsShareMeasurementCacheKey() {
+        let one = TextLayout<MonospaceTextMeasurer, View>(text: "Hello", font: 10, measurer: MonospaceTextMeasurer())
+        let two = TextLayout<MonospaceTextMeasurer, View>(text: "Hello", font: 10, measurer: MonospaceTextMeasurer())
+        let three = TextLayout<MonospaceTextMeasurer, View>(text: "Hello", font: 12, measurer: MonospaceTextMeasurer())
+
+        XCTAssertEqual(one.measurementCacheKey, two.measurementCacheKey)
+        XCTAssertNotEqual(one.measurementCacheKey, three.measurementCacheKey)
+    }
+}
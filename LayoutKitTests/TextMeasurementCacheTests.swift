@@ -0,0 +1,123 @@
+// Copyright 2019 LinkedIn Corp.
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+
+import XCTest
+@testable import LayoutKit
+
+class TextMeasurementCacheTests: XCTestCase {
+
+    private let maxSize = CGSize(width: 100, height: CGFloat.greatestFiniteMagnitude)
+
+    func testSameTextIsMeasuredOnce() {
+        let cache = TextMeasurementCache()
+        var measureCount = 0
+        let measure = { () -> CGSize in
+            measureCount += 1
+            return CGSize(width: 10, height: 20)
+        }
+
+        let first = cache.size(of: .unattributed("Hello"), within: maxSize, font: UIFont.helvetica(), lineBreakMode: .byTruncatingTail, measure: measure)
+        let second = cache.size(of: .unattributed("Hello"), within: maxSize, font: UIFont.helvetica(), lineBreakMode: .byTruncatingTail, measure: measure)
+
+        XCTAssertEqual(first, second)
+        XCTAssertEqual(measureCount, 1)
+        XCTAssertEqual(cache.hitCount, 1)
+        XCTAssertEqual(cache.missCount, 1)
+    }
+
+    func testKeyIncludesFontLineBreakModeAndSize() {
+        let cache = TextMeasurementCache()
+        var measureCount = 0
+        let measure = { () -> CGSize in
+            measureCount += 1
+            return .zero
+        }
+
+        _ = cache.size(of: .unattributed("Hello"), within: maxSize, font: UIFont.helvetica(), lineBreakMode: .byTruncatingTail, measure: measure)
+        _ = cache.size(of: .unattributed("Hello"), within: maxSize, font: UIFont.helvetica(size: 20), lineBreakMode: .byTruncatingTail, measure: measure)
+        _ = cache.size(of: .unattributed("Hello"), within: maxSize, font: UIFont.helvetica(), lineBreakMode: .byCharWrapping, measure: measure)
+        _ = cache.size(of: .unattributed("Hello"), within: CGSize(width: 50, height: 50), font: UIFont.helvetica(), lineBreakMode: .byTruncatingTail, measure: measure)
+        _ = cache.size(of: .attributed(NSAttributedString(string: "Hello")), within: maxSize, font: UIFont.helvetica(), lineBreakMode: .byTruncatingTail, measure: measure)
+
+        XCTAssertEqual(measureCount, 5)
+        XCTAssertEqual(cache.hitCount, 0)
+    }
+
+    func testMutatingAttributedTextAfterMeasurementDoesNotChangeItsKey() {
+        let cache = TextMeasurementCache()
+        var measureCount = 0
+        let measure = { () -> CGSize in
+            measureCount += 1
+            return .zero
+        }
+
+        let text = NSMutableAttributedString(string: "Hello")
+        _ = cache.size(of: .attributed(text), within: maxSize, font: UIFont.helvetica(), lineBreakMode: .byTruncatingTail, measure: measure)
+        text.mutableString.setString("Goodbye")
+
+        _ = cache.size(of: .attributed(NSAttributedString(string: "Hello")), within: maxSize, font: UIFont.helvetica(), lineBreakMode: .byTruncatingTail, measure: measure)
+        XCTAssertEqual(measureCount, 1)
+        _ = cache.size(of: .attributed(NSAttributedString(string: "Goodbye")), within: maxSize, font: UIFont.helvetica(), lineBreakMode: .byTruncatingTail, measure: measure)
+        XCTAssertEqual(measureCount, 2)
+    }
+
+    func testEvictsWhenOverBudget() {
+        let cache = TextMeasurementCache(totalCostLimit: 1024, shardCount: 1)
+        for i in 0..<100 {
+            _ = cache.size(of: .unattributed("Text \(i)"), within: maxSize, font: UIFont.helvetica(), lineBreakMode: .byTruncatingTail, measure: { .zero })
+        }
+        XCTAssertLessThanOrEqual(cache.totalCost, 1024)
+        XCTAssertGreaterThan(cache.evictionCount, 0)
+    }
+
+    func testContentSizeCategoryChangeInvalidates() {
+        let cache = TextMeasurementCache()
+        var measureCount = 0
+        let measure = { () -> CGSize in
+            measureCount += 1
+            return .zero
+        }
+
+        _ = cache.size(of: .unattributed("Hello"), within: maxSize, font: UIFont.helvetica(), lineBreakMode: .byTruncatingTail, measure: measure)
+        NotificationCenter.default.post(name: UIContentSizeCategory.didChangeNotification, object: nil)
+        XCTAssertEqual(cache.totalCost, 0)
+
+        _ = cache.size(of: .unattributed("Hello"), within: maxSize, font: UIFont.helvetica(), lineBreakMode: .byTruncatingTail, measure: measure)
+        XCTAssertEqual(measureCount, 2)
+    }
+
+    func testCachedLabelMeasurementMatchesUncached() {
+        let cache = TextMeasurementCache.shared
+        // Empty text is never measured, so it isn't cached.
+        for testCase in Text.testCases where !testCase.text.isEmptyText {
+            let font = testCase.font ?? UIFont.helvetica()
+            let uncached = testCase.text.uncachedTextSize(within: maxSize, font: font, lineBreakMode: .byTruncatingTail).decreasedToSize(maxSize)
+
+            cache.removeAll()
+            let missed = LabelLayout(text: testCase.text, font: font).measurement(within: maxSize).size
+            let hitCount = cache.hitCount
+            let hit = LabelLayout(text: testCase.text, font: font).measurement(within: maxSize).size
+
+            XCTAssertEqual(missed, uncached)
+            XCTAssertEqual(hit, uncached)
+            XCTAssertEqual(cache.hitCount, hitCount + 1, "The second measurement is cached")
+        }
+    }
+}
+
+private extension Text {
+
+    var isEmptyText: Bool {
+        switch self {
+        case .unattributed(let text):
+            return text.isEmpty
+        case .attributed(let attributedText):
+            return attributedText.length == 0
+        }
+    }
+}
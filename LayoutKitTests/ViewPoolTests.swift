@@ -0,0 +1,130 @@
+// Copyright 2019 LinkedIn Corp.
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+
+import XCTest
+import LayoutKit
+
+class ViewPoolTests: XCTestCase {
+
+    private var pool = ViewPool(capacity: 2)
+
+    override func setUp() {
+        super.setUp()
+        pool = ViewPool(capacity: 2)
+        ViewPool.shared = pool
+    }
+
+    override func tearDown() {
+        ViewPool.shared = nil
+        super.tearDown()
+    }
+
+    /// A layout whose view is recorded in `views` when it is configured.
+    private func recordingLayout(_ views: Box, viewReuseId: String = "view") -> SizeLayout<View> {
+        return SizeLayout<View>(width: 10, height: 10, viewReuseId: viewReuseId) { view in views.value.append(view) }
+    }
+
+    private class Box {
+        var value = [View]()
+    }
+
+    func testReusesPurgedViewInOtherHierarchy() {
+        let views = Box()
+        let firstContainer = View()
+        let secondContainer = View()
+
+        recordingLayout(views).arrangement().makeViews(in: firstContainer)
+        // The first container no longer needs its view.
+        SizeLayout<View>(width: 10, height: 10).arrangement().makeViews(in: firstContainer)
+        XCTAssertEqual(pool.count, 1)
+
+        recordingLayout(views).arrangement().makeViews(in: secondContainer)
+
+        XCTAssertEqual(views.value.count, 2)
+        XCTAssertTrue(views.value[0] == views.value[1])
+        XCTAssertTrue(secondContainer.subviews.first == views.value[0])
+        XCTAssertEqual(pool.count, 0)
+        XCTAssertEqual(pool.createCount, 1)
+        XCTAssertEqual(pool.purgeCount, 1)
+        XCTAssertEqual(pool.reuseCount, 1)
+    }
+
+    func testMatchesViewReuseId() {
+        let views = Box()
+        let container = View()
+
+        recordingLayout(views, viewReuseId: "a").arrangement().makeViews(in: container)
+        recordingLayout(views, viewReuseId: "b").arrangement().makeViews(in: container)
+
+        XCTAssertEqual(views.value.count, 2)
+        XCTAssertFalse(views.value[0] == views.value[1])
+        XCTAssertEqual(pool.count, 1)
+        XCTAssertEqual(pool.reuseCount, 0)
+    }
+
+    func testDiscardsViewsWhenFull() {
+        let container = View()
+        let stack = StackLayout(axis: .vertical, sublayouts: (0..<3).map { recordingLayout(Box(), viewReuseId: "\($0)") })
+        stack.arrangement().makeViews(in: container)
+
+        SizeLayout<View>(width: 10, height: 10).arrangement().makeViews(in: container)
+
+        XCTAssertEqual(pool.count, 2)
+        XCTAssertEqual(pool.purgeCount, 2)
+        XCTAssertEqual(pool.discardCount, 1)
+    }
+
+    func testDoesNotPoolViewsWithoutViewReuseId() {
+        let views = Box()
+        let container = View()
+        SizeLayout<View>(width: 10, height: 10) { view in views.value.append(view) }.arrangement().makeViews(in: container)
+        SizeLayout<View>(width: 10, height: 10).arrangement().makeViews(in: container)
+
+        XCTAssertEqual(views.value.count, 1)
+        XCTAssertNil(views.value[0].superview)
+        XCTAssertEqual(pool.count, 0)
+        XCTAssertEqual(pool.createCount, 0)
+    }
+
+    #if os(iOS) || os(tvOS)
+    func testDoesNotPoolButtons() {
+        let container = View()
+        ButtonLayout(type: .custom, title: "Hi").arrangement().makeViews(in: container)
+        SizeLayout<View>(width: 10, height: 10).arrangement().makeViews(in: container)
+
+        XCTAssertEqual(pool.count, 0)
+        XCTAssertEqual(pool.createCount, 0)
+    }
+
+    func testResetsTransformOfParkedViews() {
+        let container = View()
+        let layout = SizeLayout<View>(width: 10, height: 10, viewReuseId: "view") { view in
+            view.transform = CGAffineTransform(scaleX: 2, y: 2)
+        }
+        layout.arrangement().makeViews(in: container)
+        let view = container.subviews.first
+
+        SizeLayout<View>(width: 10, height: 10).arrangement().makeViews(in: container)
+
+        XCTAssertEqual(view?.transform, .identity)
+        XCTAssertNil(view?.superview)
+    }
+    #endif
+
+    func testRemoveAll() {
+        let container = View()
+        recordingLayout(Box()).arrangement().makeViews(in: container)
+        SizeLayout<View>(width: 10, height: 10).arrangement().makeViews(in: container)
+
+        pool.removeAll()
+        pool.resetCounters()
+
+        XCTAssertEqual(pool.count, 0)
+        XCTAssertEqual(pool.purgeCount, 0)
+    }
+}
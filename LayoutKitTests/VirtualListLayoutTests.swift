@@ -0,0 +1,74 @@
+// Copyright 2019 LinkedIn Corp.
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+
+import XCTest
+import LayoutKit
+
+class VirtualListLayoutTests: XCTestCase {
+
+    func testUniformList() {
+        var requestedIndexes = [Int]()
+        let list = VirtualListLayout(itemCount: 10_000, itemSize: .uniform(50), spacing: 10, itemLayout: { index in
+            requestedIndexes.append(index)
+            return SizeLayout<View>(minHeight: 20)
+        })
+
+        let arrangement = list.arrangement(width: 320)
+        XCTAssertEqual(arrangement.frame.size, CGSize(width: 320, height: 10_000 * 60 - 10))
+        XCTAssertTrue(arrangement.sublayouts.isEmpty)
+
+        let size = arrangement.frame.size
+        XCTAssertEqual(list.frame(ofItem: 5000, size: size), CGRect(x: 0, y: 300_000, width: 320, height: 50))
+        XCTAssertEqual(list.itemIndexes(in: CGRect(x: 0, y: 300_055, width: 320, height: 100), size: size), 5000..<5003)
+        XCTAssertEqual(list.itemIndexes(in: CGRect(x: 0, y: -100, width: 320, height: 50), size: size), 0..<0)
+
+        let items = list.itemFrames(in: CGRect(x: 0, y: 300_055, width: 320, height: 100), size: size)
+        XCTAssertEqual(items.map { $0.index }, [5000, 5001, 5002])
+        XCTAssertTrue(requestedIndexes.isEmpty)
+
+        let item = list.arrangement(ofItem: 5001, in: items[1].frame)
+        XCTAssertEqual(item.frame, CGRect(x: 0, y: 0, width: 320, height: 50))
+        XCTAssertEqual(requestedIndexes, [5001])
+    }
+
+    func testGrid() {
+        let list = VirtualListLayout(itemCount: 7, itemSize: .uniform(100), columnCount: 3, spacing: 10, interitemSpacing: 10, itemLayout: { _ in
+            return SizeLayout<View>(width: 10, height: 10)
+        })
+        let size = list.arrangement(width: 320).frame.size
+        XCTAssertEqual(size.height, 320)
+        XCTAssertEqual(list.frame(ofItem: 4, size: size), CGRect(x: 110, y: 110, width: 100, height: 100))
+        XCTAssertEqual(list.itemIndexes(in: CGRect(x: 0, y: 215, width: 320, height: 10), size: size), 3..<7)
+        XCTAssertEqual(list.itemIndexes(in: CGRect(x: 0, y: 225, width: 320, height: 10), size: size), 6..<7)
+    }
+
+    func testEstimatedRowsAreMeasuredWhenArranged() {
+        var requestedIndexes = Set<Int>()
+        let list = VirtualListLayout(itemCount: 1000, itemSize: .estimated(100), itemLayout: { index in
+            requestedIndexes.insert(index)
+            return SizeLayout<View>(height: 40)
+        })
+
+        var size = list.arrangement(width: 320).frame.size
+        XCTAssertEqual(size.height, 100_000)
+
+        // Measuring the first rows shortens them, which brings more rows into the rect until they have all been measured.
+        let items = list.itemFrames(in: CGRect(x: 0, y: 0, width: 320, height: 200), size: size)
+        XCTAssertEqual(items.map { $0.index }, Array(0...5))
+        XCTAssertEqual(items.last?.frame, CGRect(x: 0, y: 200, width: 320, height: 40))
+        XCTAssertEqual(requestedIndexes, Set(0...5))
+
+        size = list.arrangement(width: 320).frame.size
+        XCTAssertEqual(size.height, 6 * 40 + 994 * 100)
+        XCTAssertEqual(list.frame(ofItem: 10, size: size).minY, 6 * 40 + 4 * 100)
+        XCTAssertEqual(list.itemIndexes(in: CGRect(x: 0, y: 250, width: 320, height: 1), size: size), 6..<7)
+
+        // Rows are measured again at another width.
+        XCTAssertEqual(list.arrangement(width: 200).frame.height, 100_000)
+    }
+}
@@ -1,3 +1,4 @@
+// swift-tools-version:4.0
 // Copyright 2017 LinkedIn Corp.
 // Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with the License.
 // You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
@@ -6,10 +7,100 @@
 // software distributed under the License is distributed on an "AS IS" BASIS,
 // WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 
-// swift-tools-version:3.1
-
 import PackageDescription
 
+/// The layout engine. It only depends on Foundation, so it also builds on Linux.
+let coreSources = [
+    "Alignment.swift",
+    "ArrangementSnapshot.swift",
+    "Axis.swift",
+    "ConfigurableLayout.swift",
+    "DisplayScale.swift",
+    "Flexibility.swift",
+    "Internal/CGFloatExtension.swift",
+    "Internal/CGSizeExtension.swift",
+    "Internal/LRUCache.swift",
+    "Internal/OffsetIndex.swift",
+    "Internal/ThreadLocal.swift",
+    "Layout.swift",
+    "LayoutArrangement.swift",
+    "LayoutMeasurement.swift",
+    "LayoutMeasurementCache.swift",
+    "LayoutProfiler.swift",
+    "LayoutScratchBufferPool.swift",
+    "Layouts/BaseLayout.swift",
+    "Layouts/FlowLayout.swift",
+    "Layouts/InsetLayout.swift",
+    "Layouts/OverlayLayout.swift",
+    "Layouts/SizeLayout.swift",
+    "Layouts/StackLayout.swift",
+    "Layouts/TextLayout.swift",
+    "Layouts/VirtualListLayout.swift",
+    "Math",
+    "PlatformTypes.swift",
+    "TextMeasuring.swift",
+]
+
+/// Views and makeViews. They build with UIKit or AppKit.
+let viewSources = [
+    "Animation.swift",
+    "Internal/CFAbsoluteTimeExtension.swift",
+    "LayoutArrangement+Views.swift",
+    "ViewPool.swift",
+    "ViewRecycler.swift",
+]
+
+/// UIKit text measurement, the UIKit layouts and the reloadable views. They only build with UIKit (iOS and tvOS).
+let uiKitSources = [
+    "Internal/NSAttributedStringExtension.swift",
+    "Internal/TextViewDefaultFont.swift",
+    "Layouts/ButtonLayout.swift",
+    "Layouts/LabelLayout.swift",
+    "Layouts/TextViewLayout.swift",
+    "Text.swift",
+    "TextKitMeasurer.swift",
+    "TextMeasurementCache.swift",
+    "UIKitSupport.swift",
+    "Views",
+]
+
+/// AppKit support (macOS). Like the pod, the macOS module has the engine and the views but no UIKit layouts.
+let appKitSources = [
+    "AppKitSupport.swift",
+]
+
+/// Tests of the layout engine that don't need views, so they also run headless.
+let coreTestSources = [
+    "AlignmentTests.swift",
+    "ArrangementSnapshotTests.swift",
+    "CGFloatExtensionTests.swift",
+    "FlowLayoutTests.swift",
+    "LayoutProfilerTests.swift",
+    "LayoutScratchBufferPoolTests.swift",
+    "SizeLayoutTests.swift",
+    "StackLayoutFlexibilityTests.swift",
+    "TextLayoutTests.swift",
+    "VirtualListLayoutTests.swift",
+]
+
+// The engine and the views are one module, like the framework and pod, so that the engine's helpers stay internal.
+#if os(iOS) || os(tvOS)
+let sources = coreSources + viewSources + uiKitSources
+#elseif os(macOS)
+let sources = coreSources + viewSources + appKitSources
+#else
+let sources = coreSources
+#endif
+
 let package = Package(
-    name: "LayoutKit"
+    name: "LayoutKit",
+    products: [
+        .library(name: "LayoutKit", targets: ["LayoutKit"]),
+        .executable(name: "LayoutKitBenchmarks", targets: ["LayoutKitBenchmarks"]),
+    ],
+    targets: [
+        .target(name: "LayoutKit", path: "Sources", sources: sources),
+        .target(name: "LayoutKitBenchmarks", dependencies: ["LayoutKit"], path: "LayoutKitBenchmarks"),
+        .testTarget(name: "LayoutKitCoreTests", dependencies: ["LayoutKit"], path: "LayoutKitTests", sources: coreTestSources),
+    ]
 )
@@ -6,7 +6,7 @@
 // software distributed under the License is distributed on an "AS IS" BASIS,
 // WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 
-import CoreGraphics
+import Foundation
 
 /**
  Specifies how a layout positions itself inside of the rect that it is given to it by its parent during arrangement.
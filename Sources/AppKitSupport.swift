@@ -8,10 +8,6 @@
 
 import AppKit
 
-public typealias View = NSView
-
-public typealias UserInterfaceLayoutDirection = NSUserInterfaceLayoutDirection
-
 extension NSView {
     
     func convertToAbsoluteCoordinates(_ rect: CGRect) -> CGRect {
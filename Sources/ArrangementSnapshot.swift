@@ -0,0 +1,483 @@
+// Copyright 2019 LinkedIn Corp.
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+
+import Foundation
+
+/**
+ The frames of the arrangements of a sectioned list (e.g. the items of a `ReloadableViewLayoutAdapter`), in a binary format
+ that can be persisted and memory mapped on the next launch.
+
+ A snapshot only contains frames. Layouts can't be persisted, so an item's arrangement is restored by pairing the frames
+ with a layout that is equivalent to the one that was arranged: `arrangement(of:forItem:inSection:)` walks the layout's sublayouts
+ and the snapshot's nodes together, and fails if their types or number differ.
+ The basic layouts expose their sublayouts; custom layouts can only be restored if they have no sublayouts.
+ Stacks that didn't have room for all of their sublayouts can't be restored.
+
+ Snapshots are keyed by a content version and the size that the items were arranged within (see `Key`).
+ Opening a snapshot only checks its header and tables, so the frames of a memory mapped snapshot are not read until they are needed.
+ The frames of each header, item and footer have their own checksum, which is checked when they are read.
+
+ ### Format
+
+ All values are little endian. The file is:
+
+ - A 48 byte header: magic (`LKAS`), format version, CRC-32 of the rest of the header, the content version and the tables
+   up to the node table, a reserved word, the width and height of the key (`Float64`, infinite if unconstrained),
+   and the byte length of the content version, section count, entry count and node count (`UInt32`).
+ - The UTF-8 content version, padded with zeros to a multiple of 8 bytes.
+ - A section table of 16 bytes per section: item count, index of the first item entry,
+   and entry index of the header and footer (-1 if none).
+ - An entry table of 12 bytes per header, item and footer: index of its first node, node count and CRC-32 of its nodes.
+ - A node table of 40 bytes per node, in depth-first pre-order: x, y, width, height (`Float64`),
+   the index just past the node's last descendant, and a hash of the layout's type name.
+ */
+public struct ArrangementSnapshot {
+
+    /// The version of the format that this version of LayoutKit reads and writes.
+    public static let formatVersion: UInt32 = 2
+
+    /// Identifies the content and size that a snapshot's arrangements were computed for.
+    public struct Key: Equatable {
+        public let contentVersion: String
+        public let width: CGFloat?
+        public let height: CGFloat?
+
+        public init(contentVersion: String, width: CGFloat? = nil, height: CGFloat? = nil) {
+            self.contentVersion = contentVersion
+            self.width = width
+            self.height = height
+        }
+    }
+
+    public enum Error: Swift.Error {
+        /// The data is shorter than its header or tables say.
+        case truncated
+
+        /// The data isn't a snapshot.
+        case badMagic
+
+        /// The snapshot was written in a format that this version of LayoutKit doesn't read.
+        case unsupportedVersion(UInt32)
+
+        /// The header or tables were corrupted.
+        case checksumMismatch
+
+        /// The tables reference nodes or entries that don't exist.
+        case malformed
+    }
+
+    public let key: Key
+
+    /// The number of sections.
+    public let sectionCount: Int
+
+    private let data: Data
+    private let sectionTableOffset: Int
+    private let entryTableOffset: Int
+    private let nodeTableOffset: Int
+    private let entryCount: Int
+    private let nodeCount: Int
+
+    private static let magic: UInt32 = 0x5341_4B4C // "LKAS"
+    private static let headerLength = 48
+    private static let sectionLength = 16
+    private static let entryLength = 12
+    private static let nodeLength = 40
+
+    /// Opens a snapshot in `data`, checking that it is complete and that its header and tables are uncorrupted.
+    public init(data: Data) throws {
+        guard data.count >= ArrangementSnapshot.headerLength else {
+            throw Error.truncated
+        }
+        self.data = data
+        guard ArrangementSnapshot.readUInt32(data, at: 0) == ArrangementSnapshot.magic else {
+            throw Error.badMagic
+        }
+        let version = ArrangementSnapshot.readUInt32(data, at: 4)
+        guard version == ArrangementSnapshot.formatVersion else {
+            throw Error.unsupportedVersion(version)
+        }
+
+        let contentVersionLength = Int(ArrangementSnapshot.readUInt32(data, at: 32))
+        sectionCount = Int(ArrangementSnapshot.readUInt32(data, at: 36))
+        entryCount = Int(ArrangementSnapshot.readUInt32(data, at: 40))
+        nodeCount = Int(ArrangementSnapshot.readUInt32(data, at: 44))
+        sectionTableOffset = ArrangementSnapshot.headerLength + ArrangementSnapshot.padded(contentVersionLength)
+        entryTableOffset = sectionTableOffset + sectionCount * ArrangementSnapshot.sectionLength
+        nodeTableOffset = entryTableOffset + entryCount * ArrangementSnapshot.entryLength
+        guard nodeTableOffset + nodeCount * ArrangementSnapshot.nodeLength == data.count else {
+            throw Error.truncated
+        }
+        guard ArrangementSnapshot.readUInt32(data, at: 8) == ArrangementSnapshot.crc32(of: data, in: 12..<nodeTableOffset) else {
+            throw Error.checksumMismatch
+        }
+
+        let contentVersionBytes = data.subdata(in: ArrangementSnapshot.headerLength..<(ArrangementSnapshot.headerLength + contentVersionLength))
+        guard let contentVersion = String(data: contentVersionBytes, encoding: .utf8) else {
+            throw Error.malformed
+        }
+        key = Key(
+            contentVersion: contentVersion,
+            width: ArrangementSnapshot.dimension(ArrangementSnapshot.readFloat64(data, at: 16)),
+            height: ArrangementSnapshot.dimension(ArrangementSnapshot.readFloat64(data, at: 24)))
+
+        for index in 0..<sectionCount {
+            let table = section(at: index)
+            guard table.firstItemEntry + table.itemCount <= entryCount,
+                table.headerEntry < entryCount, table.footerEntry < entryCount else {
+                throw Error.malformed
+            }
+        }
+        for entry in 0..<entryCount {
+            let (firstNode, count) = entryNodes(at: entry)
+            guard count > 0 && firstNode + count <= nodeCount else {
+                throw Error.malformed
+            }
+        }
+    }
+
+    /// Memory maps the snapshot in the file at `url`.
+    public init(contentsOf url: URL) throws {
+        try self.init(data: Data(contentsOf: url, options: .alwaysMapped))
+    }
+
+    /// The number of items in `section`.
+    public func itemCount(inSection section: Int) -> Int {
+        return section < sectionCount ? self.section(at: section).itemCount : 0
+    }
+
+    /// The frame of the item, or nil if the snapshot doesn't have it or its frames were corrupted.
+    public func frame(ofItem item: Int, inSection section: Int) -> CGRect? {
+        guard let entry = itemEntry(item: item, section: section), isUncorrupted(entry: entry) else {
+            return nil
+        }
+        return node(at: entryNodes(at: entry).firstNode).frame
+    }
+
+    /**
+     Restores the arrangement of the item for `layout`,
+     or returns nil if the snapshot doesn't have the item, its frames were corrupted or `layout` doesn't match them.
+     */
+    public func arrangement(of layout: Layout, forItem item: Int, inSection section: Int) -> LayoutArrangement? {
+        return itemEntry(item: item, section: section).flatMap { arrangement(of: layout, entry: $0) }
+    }
+
+    /// Restores the arrangement of the header of `section` for `layout`.
+    public func arrangement(of layout: Layout, forHeaderInSection section: Int) -> LayoutArrangement? {
+        guard section < sectionCount else {
+            return nil
+        }
+        let entry = self.section(at: section).headerEntry
+        return entry >= 0 ? arrangement(of: layout, entry: entry) : nil
+    }
+
+    /// Restores the arrangement of the footer of `section` for `layout`.
+    public func arrangement(of layout: Layout, forFooterInSection section: Int) -> LayoutArrangement? {
+        guard section < sectionCount else {
+            return nil
+        }
+        let entry = self.section(at: section).footerEntry
+        return entry >= 0 ? arrangement(of: layout, entry: entry) : nil
+    }
+
+    // MARK: - Reading
+
+    private struct SectionTable {
+        let itemCount: Int
+        let firstItemEntry: Int
+        let headerEntry: Int
+        let footerEntry: Int
+    }
+
+    private struct Node {
+        let frame: CGRect
+        let subtreeEnd: Int
+        let typeHash: UInt32
+    }
+
+    private func section(at index: Int) -> SectionTable {
+        let offset = sectionTableOffset + index * ArrangementSnapshot.sectionLength
+        return SectionTable(
+            itemCount: Int(ArrangementSnapshot.readUInt32(data, at: offset)),
+            firstItemEntry: Int(ArrangementSnapshot.readUInt32(data, at: offset + 4)),
+            headerEntry: Int(Int32(bitPattern: ArrangementSnapshot.readUInt32(data, at: offset + 8))),
+            footerEntry: Int(Int32(bitPattern: ArrangementSnapshot.readUInt32(data, at: offset + 12))))
+    }
+
+    private func entryNodes(at index: Int) -> (firstNode: Int, count: Int) {
+        let offset = entryTableOffset + index * ArrangementSnapshot.entryLength
+        return (Int(ArrangementSnapshot.readUInt32(data, at: offset)), Int(ArrangementSnapshot.readUInt32(data, at: offset + 4)))
+    }
+
+    /// Whether the nodes of the entry match the entry's checksum. Only the pages of those nodes are read.
+    private func isUncorrupted(entry index: Int) -> Bool {
+        let (firstNode, count) = entryNodes(at: index)
+        let start = nodeTableOffset + firstNode * ArrangementSnapshot.nodeLength
+        let checksum = ArrangementSnapshot.readUInt32(data, at: entryTableOffset + index * ArrangementSnapshot.entryLength + 8)
+        return checksum == ArrangementSnapshot.crc32(of: data, in: start..<(start + count * ArrangementSnapshot.nodeLength))
+    }
+
+    private func node(at index: Int) -> Node {
+        let offset = nodeTableOffset + index * ArrangementSnapshot.nodeLength
+        let frame = CGRect(
+            x: ArrangementSnapshot.readFloat64(data, at: offset),
+            y: ArrangementSnapshot.readFloat64(data, at: offset + 8),
+            width: ArrangementSnapshot.readFloat64(data, at: offset + 16),
+            height: ArrangementSnapshot.readFloat64(data, at: offset + 24))
+        return Node(frame: frame, subtreeEnd: Int(ArrangementSnapshot.readUInt32(data, at: offset + 32)), typeHash: ArrangementSnapshot.readUInt32(data, at: offset + 36))
+    }
+
+    private func itemEntry(item: Int, section: Int) -> Int? {
+        guard section < sectionCount else {
+            return nil
+        }
+        let table = self.section(at: section)
+        guard item < table.itemCount else {
+            return nil
+        }
+        return table.firstItemEntry + item
+    }
+
+    private func arrangement(of layout: Layout, entry: Int) -> LayoutArrangement? {
+        guard isUncorrupted(entry: entry) else {
+            return nil
+        }
+        let (firstNode, count) = entryNodes(at: entry)
+        guard let restored = arrangement(of: layout, node: firstNode, end: firstNode + count), restored.end == firstNode + count else {
+            return nil
+        }
+        return restored.arrangement
+    }
+
+    /// Pairs `layout` with the subtree at `index`, which must end at or before `end`.
+    private func arrangement(of layout: Layout, node index: Int, end: Int) -> (arrangement: LayoutArrangement, end: Int)? {
+        let node = self.node(at: index)
+        guard node.typeHash == ArrangementSnapshot.typeHash(of: layout), node.subtreeEnd > index, node.subtreeEnd <= end else {
+            return nil
+        }
+        let sublayouts = (layout as? SnapshotRestorableLayout)?.arrangedSublayouts ?? []
+        var sublayoutArrangements = [LayoutArrangement]()
+        sublayoutArrangements.reserveCapacity(sublayouts.count)
+        var sublayoutIndex = index + 1
+        for sublayout in sublayouts {
+            guard sublayoutIndex < node.subtreeEnd, let restored = arrangement(of: sublayout, node: sublayoutIndex, end: node.subtreeEnd) else {
+                return nil
+            }
+            sublayoutArrangements.append(restored.arrangement)
+            sublayoutIndex = restored.end
+        }
+        guard sublayoutIndex == node.subtreeEnd else {
+            return nil
+        }
+        return (LayoutArrangement(layout: layout, frame: node.frame, sublayouts: sublayoutArrangements), node.subtreeEnd)
+    }
+
+    private static func readUInt32(_ data: Data, at offset: Int) -> UInt32 {
+        return data.withUnsafeBytes { (bytes: UnsafeRawBufferPointer) in
+            var value: UInt32 = 0
+            withUnsafeMutableBytes(of: &value) { $0.copyMemory(from: UnsafeRawBufferPointer(rebasing: bytes[offset..<(offset + 4)])) }
+            return UInt32(littleEndian: value)
+        }
+    }
+
+    private static func readFloat64(_ data: Data, at offset: Int) -> CGFloat {
+        return data.withUnsafeBytes { (bytes: UnsafeRawBufferPointer) in
+            var value: UInt64 = 0
+            withUnsafeMutableBytes(of: &value) { $0.copyMemory(from: UnsafeRawBufferPointer(rebasing: bytes[offset..<(offset + 8)])) }
+            return CGFloat(Double(bitPattern: UInt64(littleEndian: value)))
+        }
+    }
+
+    private static func dimension(_ value: CGFloat) -> CGFloat? {
+        return value.isInfinite ? nil : value
+    }
+
+    private static func padded(_ length: Int) -> Int {
+        return (length + 7) & ~7
+    }
+
+    // MARK: - Hashing
+
+    /// The FNV-1a hash of the layout's type name, which, unlike `hashValue`, is the same on every launch.
+    /// Hashes are computed once per type, since reflecting the type name is slow. It is thread-safe.
+    static func typeHash(of layout: Layout) -> UInt32 {
+        let layoutType = ObjectIdentifier(type(of: layout))
+        typeHashLock.lock()
+        defer { typeHashLock.unlock() }
+        if let hash = typeHashes[layoutType] {
+            return hash
+        }
+        var hash: UInt32 = 2_166_136_261
+        for byte in String(reflecting: type(of: layout)).utf8 {
+            hash = (hash ^ UInt32(byte)) &* 16_777_619
+        }
+        typeHashes[layoutType] = hash
+        return hash
+    }
+
+    private static let typeHashLock = NSLock()
+
+    /// The hashes of the layout types that were hashed so far. Guarded by `typeHashLock`.
+    private static var typeHashes = [ObjectIdentifier: UInt32]()
+
+    private static let crcTable: [UInt32] = (0..<256).map { index in
+        var crc = UInt32(index)
+        for _ in 0..<8 {
+            crc = (crc & 1) != 0 ? (crc >> 1) ^ 0xEDB8_8320 : crc >> 1
+        }
+        return crc
+    }
+
+    /// The CRC-32 (IEEE) of the bytes of `data` in `range`.
+    static func crc32(of data: Data, in range: Range<Int>) -> UInt32 {
+        let table = crcTable
+        return data.withUnsafeBytes { (bytes: UnsafeRawBufferPointer) in
+            var crc: UInt32 = 0xFFFF_FFFF
+            for byte in bytes[range] {
+                crc = table[Int((crc ^ UInt32(byte)) & 0xFF)] ^ (crc >> 8)
+            }
+            return crc ^ 0xFFFF_FFFF
+        }
+    }
+}
+
+// MARK: - Writing
+
+extension ArrangementSnapshot {
+
+    /// Writes the arrangements of a sectioned list in the snapshot format.
+    public struct Builder {
+
+        public let key: Key
+
+        private var sections = [(itemCount: UInt32, firstItemEntry: UInt32, headerEntry: Int32, footerEntry: Int32)]()
+        private var entries = [(firstNode: UInt32, count: UInt32, checksum: UInt32)]()
+        private var nodes = Data()
+        private var nodeCount = 0
+
+        public init(key: Key) {
+            self.key = key
+        }
+
+        /// Appends a section with the arrangements of its header, items and footer.
+        public mutating func appendSection(header: LayoutArrangement?, items: [LayoutArrangement], footer: LayoutArrangement?) {
+            let headerEntry = header.map { Int32(append($0)) } ?? -1
+            let firstItemEntry = UInt32(entries.count)
+            for item in items {
+                append(item)
+            }
+            let footerEntry = footer.map { Int32(append($0)) } ?? -1
+            sections.append((UInt32(items.count), firstItemEntry, headerEntry, footerEntry))
+        }
+
+        /// Returns the snapshot.
+        public func data() -> Data {
+            let contentVersion = Data(key.contentVersion.utf8)
+            var data = Data()
+            data.reserveCapacity(ArrangementSnapshot.headerLength + ArrangementSnapshot.padded(contentVersion.count)
+                + sections.count * ArrangementSnapshot.sectionLength + entries.count * ArrangementSnapshot.entryLength + nodes.count)
+            Builder.append(ArrangementSnapshot.magic, to: &data)
+            Builder.append(ArrangementSnapshot.formatVersion, to: &data)
+            Builder.append(UInt32(0), to: &data) // The checksum is written last.
+            Builder.append(UInt32(0), to: &data)
+            Builder.append(key.width ?? .infinity, to: &data)
+            Builder.append(key.height ?? .infinity, to: &data)
+            Builder.append(UInt32(contentVersion.count), to: &data)
+            Builder.append(UInt32(sections.count), to: &data)
+            Builder.append(UInt32(entries.count), to: &data)
+            Builder.append(UInt32(nodeCount), to: &data)
+            data.append(contentVersion)
+            data.append(Data(count: ArrangementSnapshot.padded(contentVersion.count) - contentVersion.count))
+            for section in sections {
+                Builder.append(section.itemCount, to: &data)
+                Builder.append(section.firstItemEntry, to: &data)
+                Builder.append(UInt32(bitPattern: section.headerEntry), to: &data)
+                Builder.append(UInt32(bitPattern: section.footerEntry), to: &data)
+            }
+            for entry in entries {
+                Builder.append(entry.firstNode, to: &data)
+                Builder.append(entry.count, to: &data)
+                Builder.append(entry.checksum, to: &data)
+            }
+
+            var checksum = ArrangementSnapshot.crc32(of: data, in: 12..<data.count).littleEndian
+            data.replaceSubrange(8..<12, with: Data(bytes: &checksum, count: 4))
+            data.append(nodes)
+            return data
+        }
+
+        /// Appends an entry with the nodes of `arrangement` and returns its index.
+        @discardableResult
+        private mutating func append(_ arrangement: LayoutArrangement) -> Int {
+            let firstNode = nodeCount
+            appendNodes(of: arrangement)
+            let checksum = ArrangementSnapshot.crc32(of: nodes, in: (firstNode * ArrangementSnapshot.nodeLength)..<nodes.count)
+            entries.append((UInt32(firstNode), UInt32(nodeCount - firstNode), checksum))
+            return entries.count - 1
+        }
+
+        private mutating func appendNodes(of arrangement: LayoutArrangement) {
+            let offset = nodes.count
+            nodeCount += 1
+            Builder.append(arrangement.frame.origin.x, to: &nodes)
+            Builder.append(arrangement.frame.origin.y, to: &nodes)
+            Builder.append(arrangement.frame.size.width, to: &nodes)
+            Builder.append(arrangement.frame.size.height, to: &nodes)
+            Builder.append(UInt32(0), to: &nodes) // The subtree end is written after the sublayouts.
+            Builder.append(ArrangementSnapshot.typeHash(of: arrangement.layout), to: &nodes)
+            for sublayout in arrangement.sublayouts {
+                appendNodes(of: sublayout)
+            }
+            var subtreeEnd = UInt32(nodeCount).littleEndian
+            nodes.replaceSubrange((offset + 32)..<(offset + 36), with: Data(bytes: &subtreeEnd, count: 4))
+        }
+
+        private static func append(_ value: UInt32, to data: inout Data) {
+            var littleEndian = value.littleEndian
+            data.append(Data(bytes: &littleEndian, count: 4))
+        }
+
+        private static func append(_ value: CGFloat, to data: inout Data) {
+            var littleEndian = Double(value).bitPattern.littleEndian
+            data.append(Data(bytes: &littleEndian, count: 8))
+        }
+    }
+}
+
+// MARK: - Layout support
+
+/// A layout whose sublayouts can be paired with the nodes of an `ArrangementSnapshot`.
+protocol SnapshotRestorableLayout {
+
+    /// The sublayouts in the order that the layout's arrangement lists them, assuming that all of them were arranged.
+    var arrangedSublayouts: [Layout] { get }
+}
+
+extension InsetLayout: SnapshotRestorableLayout {
+    var arrangedSublayouts: [Layout] {
+        return [sublayout]
+    }
+}
+
+extension SizeLayout: SnapshotRestorableLayout {
+    var arrangedSublayouts: [Layout] {
+        return sublayout.map { [$0] } ?? []
+    }
+}
+
+extension StackLayout: SnapshotRestorableLayout {
+    var arrangedSublayouts: [Layout] {
+        return sublayouts
+    }
+}
+
+extension OverlayLayout: SnapshotRestorableLayout {
+    var arrangedSublayouts: [Layout] {
+        return background + primary + overlay
+    }
+}
@@ -0,0 +1,42 @@
+// Copyright 2019 LinkedIn Corp.
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+
+#if os(iOS) || os(tvOS)
+import UIKit
+#elseif os(macOS)
+import AppKit
+#else
+import Foundation
+#endif
+
+/**
+ The scale of the display that layouts are laid out for, in pixels per point.
+ Text sizes are rounded to the nearest fraction of a point that the scale supports.
+ */
+public enum DisplayScale {
+
+    /**
+     The scale that layouts are rounded to.
+
+     It defaults to the scale of the main screen, or 1 on platforms without a screen (e.g. Linux).
+     Set it to lay out for a different display, for example to precompute arrangements for a device on a server.
+     It MUST be set at startup, before any layouts are measured.
+     It is read without synchronization every time a size is rounded, so it MUST NOT be set while layouts may be measured on other threads.
+     */
+    public static var current: CGFloat = DisplayScale.mainScreenScale
+
+    private static var mainScreenScale: CGFloat {
+        #if os(iOS) || os(tvOS)
+            return UIScreen.main.scale
+        #elseif os(macOS)
+            return NSScreen.main?.backingScaleFactor ?? 1
+        #else
+            return 1
+        #endif
+    }
+}
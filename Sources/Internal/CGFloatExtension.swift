@@ -6,22 +6,42 @@
 // software distributed under the License is distributed on an "AS IS" BASIS,
 // WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 
-import UIKit
+import Foundation
 
 extension CGFloat {
 
     /**
      Returns the current float rounded up to the nearest fraction of a pixel
-     that the screen density supports.
+     that the display density (`DisplayScale.current`) supports.
      */
     var roundedUpToFractionalPoint: CGFloat {
+        return roundedUp(toScale: DisplayScale.current)
+    }
+
+    /**
+     Returns the current float rounded down to the nearest fraction of a pixel
+     that the display density (`DisplayScale.current`) supports.
+     */
+    var roundedDownToFractionalPoint: CGFloat {
+        return roundedDown(toScale: DisplayScale.current)
+    }
+
+    /**
+     Returns the current float rounded up or down to the nearest fraction of a pixel
+     that the display density (`DisplayScale.current`) supports.
+     */
+    var roundedToFractionalPoint: CGFloat {
+        return rounded(toScale: DisplayScale.current)
+    }
+
+    /// Returns the current float rounded up to the nearest fraction of a pixel at `scale` pixels per point.
+    func roundedUp(toScale scale: CGFloat) -> CGFloat {
         if self == 0 {
             return 0
         }
         if self < 0 {
-            return -(-self).roundedDownToFractionalPoint
+            return -(-self).roundedDown(toScale: scale)
         }
-        let scale = UIScreen.main.scale
         // The smallest precision in points (aka the number of points per hardware pixel).
         let pointPrecision = 1.0 / scale
         if self <= pointPrecision {
@@ -30,18 +50,14 @@ extension CGFloat {
         return ceil(self * scale) / scale
     }
 
-    /**
-     Returns the current float rounded down to the nearest fraction of a pixel
-     that the screen density supports.
-     */
-    var roundedDownToFractionalPoint: CGFloat {
+    /// Returns the current float rounded down to the nearest fraction of a pixel at `scale` pixels per point.
+    func roundedDown(toScale scale: CGFloat) -> CGFloat {
         if self == 0 {
             return 0
         }
         if self < 0 {
-            return -(-self).roundedUpToFractionalPoint
+            return -(-self).roundedUp(toScale: scale)
         }
-        let scale = UIScreen.main.scale
         // The smallest precision in points (aka the number of points per hardware pixel).
         let pointPrecision = 1.0 / scale
         if self < pointPrecision {
@@ -50,16 +66,13 @@ extension CGFloat {
         return floor(self * scale) / scale
     }
 
-    /**
-     Returns the current float rounded up or down to the nearest fraction of a pixel
-     that the screen density supports.
-     */
-    var roundedToFractionalPoint: CGFloat {
+    /// Returns the current float rounded up or down to the nearest fraction of a pixel at `scale` pixels per point.
+    func rounded(toScale scale: CGFloat) -> CGFloat {
         if self == 0 {
             return 0
         }
-        let up = roundedUpToFractionalPoint
-        let down = roundedDownToFractionalPoint
+        let up = roundedUp(toScale: scale)
+        let down = roundedDown(toScale: scale)
         return up - self <= self - down ? up : down
     }
 }
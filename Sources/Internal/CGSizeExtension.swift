@@ -6,13 +6,8 @@
 // software distributed under the License is distributed on an "AS IS" BASIS,
 // WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 
-import CoreGraphics
 import Foundation
 
-#if os(OSX)
-public typealias EdgeInsets = NSEdgeInsets
-#endif
-
 extension CGSize {
     func increased(by insets: EdgeInsets) -> CGSize {
         return CGSize(
@@ -0,0 +1,145 @@
+// Copyright 2019 LinkedIn Corp.
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+
+/**
+ A dictionary that evicts its least recently used values when it exceeds a cost limit.
+
+ It is NOT thread-safe. Callers are responsible for synchronization.
+ Copies share their entries, so a cache SHOULD only be stored in one place.
+ */
+struct LRUCache<Key: Hashable, Value> {
+
+    /// The total cost that the cache may hold before it starts evicting.
+    let costLimit: Int
+
+    /// The sum of the costs of all values in the cache.
+    private(set) var totalCost = 0
+
+    private var entries = [Key: Entry]()
+
+    /// The most recently used entry.
+    private var head: Entry?
+
+    /// The least recently used entry.
+    private var tail: Entry?
+
+    init(costLimit: Int) {
+        self.costLimit = costLimit
+    }
+
+    var count: Int {
+        return entries.count
+    }
+
+    /// Returns the value for the key and marks it as the most recently used value.
+    mutating func value(forKey key: Key) -> Value? {
+        guard let entry = entries[key] else {
+            return nil
+        }
+        moveToHead(entry)
+        return entry.value
+    }
+
+    /**
+     Inserts or replaces the value for the key.
+
+     - returns: The number of values that were evicted to stay within `costLimit`.
+     */
+    @discardableResult
+    mutating func setValue(_ value: Value, forKey key: Key, cost: Int = 1) -> Int {
+        if let existing = entries[key] {
+            totalCost += cost - existing.cost
+            existing.value = value
+            existing.cost = cost
+            moveToHead(existing)
+        } else {
+            let entry = Entry(key: key, value: value, cost: cost)
+            entries[key] = entry
+            totalCost += cost
+            moveToHead(entry)
+        }
+
+        var evictionCount = 0
+        // Never evict the value that was just inserted.
+        while totalCost > costLimit, let last = tail, last !== head {
+            remove(last)
+            evictionCount += 1
+        }
+        return evictionCount
+    }
+
+    /// Removes the least recently used value and returns its key, or nil if the cache is empty.
+    mutating func removeLeastRecentlyUsed() -> Key? {
+        guard let last = tail else {
+            return nil
+        }
+        remove(last)
+        return last.key
+    }
+
+    mutating func removeAll() {
+        // Break the links so that entries are released without deep recursion.
+        var entry = head
+        while let current = entry {
+            entry = current.next
+            current.next = nil
+        }
+        entries.removeAll()
+        head = nil
+        tail = nil
+        totalCost = 0
+    }
+
+    private mutating func remove(_ entry: Entry) {
+        unlink(entry)
+        entries[entry.key] = nil
+        totalCost -= entry.cost
+    }
+
+    private mutating func moveToHead(_ entry: Entry) {
+        if head === entry {
+            return
+        }
+        unlink(entry)
+        entry.next = head
+        head?.previous = entry
+        head = entry
+        if tail == nil {
+            tail = entry
+        }
+    }
+
+    private mutating func unlink(_ entry: Entry) {
+        let previous = entry.previous
+        let next = entry.next
+        previous?.next = next
+        next?.previous = previous
+        if head === entry {
+            head = next
+        }
+        if tail === entry {
+            tail = previous
+        }
+        entry.previous = nil
+        entry.next = nil
+    }
+
+    private final class Entry {
+        let key: Key
+        var value: Value
+        var cost: Int
+        weak var previous: Entry?
+        var next: Entry?
+
+        init(key: Key, value: Value, cost: Int) {
+            self.key = key
+            self.value = value
+            self.cost = cost
+        }
+    }
+}
@@ -0,0 +1,125 @@
+// Copyright 2019 LinkedIn Corp.
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+
+import Foundation
+
+/**
+ The offsets of `count` lengths that are laid end to end with `spacing` between them.
+
+ While every length is the initial length, offsets are computed in O(1).
+ Once a length changes, the lengths are kept in a Fenwick tree of prefix sums,
+ so changing a length, computing an offset and finding the index at an offset are O(log n).
+ */
+struct OffsetIndex {
+
+    let count: Int
+    let spacing: CGFloat
+    private let initialLength: CGFloat
+
+    /// The lengths, which are empty until a length differs from `initialLength`.
+    private var lengths = [CGFloat]()
+
+    /// The Fenwick tree of length + spacing, indexed from 1.
+    private var tree = [CGFloat]()
+
+    init(count: Int, length: CGFloat, spacing: CGFloat) {
+        self.count = max(count, 0)
+        self.initialLength = length
+        self.spacing = spacing
+    }
+
+    /// The length at `index`.
+    func length(at index: Int) -> CGFloat {
+        return lengths.isEmpty ? initialLength : lengths[index]
+    }
+
+    /// The offset of the leading edge of `index`. Passing `count` returns the offset after the last spacing.
+    func offset(at index: Int) -> CGFloat {
+        if tree.isEmpty {
+            return CGFloat(index) * (initialLength + spacing)
+        }
+        var sum: CGFloat = 0
+        var i = index
+        while i > 0 {
+            sum += tree[i]
+            i -= i & -i
+        }
+        return sum
+    }
+
+    /// The distance from the leading edge of the first length to the trailing edge of the last length.
+    var totalLength: CGFloat {
+        return count == 0 ? 0 : offset(at: count) - spacing
+    }
+
+    /**
+     The index whose length, or the spacing after it, contains `offset`.
+     Offsets before the first length return 0 and offsets after the last length return `count - 1`.
+     */
+    func index(at offset: CGFloat) -> Int {
+        guard count > 0, offset > 0 else {
+            return 0
+        }
+        guard offset < totalLength else {
+            return count - 1
+        }
+        if tree.isEmpty {
+            let stride = initialLength + spacing
+            return stride > 0 ? min(Int(offset / stride), count - 1) : 0
+        }
+        // Finds the largest prefix whose sum doesn't exceed the offset by descending the tree.
+        var index = 0
+        var remaining = offset
+        var step = 1
+        while step * 2 <= count {
+            step *= 2
+        }
+        while step > 0 {
+            let next = index + step
+            if next <= count && tree[next] <= remaining {
+                index = next
+                remaining -= tree[next]
+            }
+            step /= 2
+        }
+        return min(index, count - 1)
+    }
+
+    /// Changes the length at `index`, which moves the offsets of the indexes after it.
+    mutating func setLength(_ length: CGFloat, at index: Int) {
+        if tree.isEmpty {
+            guard length != initialLength else {
+                return
+            }
+            buildTree()
+        }
+        let delta = length - lengths[index]
+        guard delta != 0 else {
+            return
+        }
+        lengths[index] = length
+        var i = index + 1
+        while i <= count {
+            tree[i] += delta
+            i += i & -i
+        }
+    }
+
+    /// Builds the tree of initial lengths in O(n).
+    private mutating func buildTree() {
+        lengths = Array(repeating: initialLength, count: count)
+        tree = Array(repeating: 0, count: count + 1)
+        for i in stride(from: 1, through: count, by: 1) {
+            tree[i] += initialLength + spacing
+            let parent = i + (i & -i)
+            if parent <= count {
+                tree[parent] += tree[i]
+            }
+        }
+    }
+}
@@ -0,0 +1,75 @@
+// Copyright 2019 LinkedIn Corp.
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+
+import Foundation
+
+/**
+ A thread-local storage slot that holds a different object on each thread.
+
+ The pthread key of a slot is never deleted, so slots are meant to be stored in static properties.
+ */
+final class ThreadLocal<T: AnyObject> {
+
+    private let key: pthread_key_t
+
+    /// Whether the slot retains the object of each thread until it is replaced or the thread exits.
+    private let retainsValues: Bool
+
+    /**
+     - parameter retainsValues: If true, the slot retains the object of each thread until it is replaced or the thread exits.
+       Otherwise, whoever sets an object must keep it alive while it is in the slot.
+     */
+    init(retainsValues: Bool) {
+        var key = pthread_key_t()
+        if retainsValues {
+            pthread_key_create(&key) { pointer in
+                releaseThreadLocalValue(pointer)
+            }
+        } else {
+            pthread_key_create(&key, nil)
+        }
+        self.key = key
+        self.retainsValues = retainsValues
+    }
+
+    /// The object of the current thread, if any.
+    var value: T? {
+        get {
+            guard let pointer = pthread_getspecific(key) else {
+                return nil
+            }
+            return Unmanaged<T>.fromOpaque(pointer).takeUnretainedValue()
+        }
+        set {
+            let oldPointer = pthread_getspecific(key)
+            if retainsValues {
+                pthread_setspecific(key, newValue.map { Unmanaged.passRetained($0).toOpaque() })
+                releaseThreadLocalValue(oldPointer)
+            } else {
+                pthread_setspecific(key, newValue.map { Unmanaged.passUnretained($0).toOpaque() })
+            }
+        }
+    }
+
+    /// Returns the object of the current thread, making it and storing it in the slot if there is none.
+    func value(orMake make: () -> T) -> T {
+        if let value = value {
+            return value
+        }
+        let value = make()
+        self.value = value
+        return value
+    }
+}
+
+/// Releases an object that a retaining slot held. The pointer is only optional on some platforms (e.g. Linux).
+private func releaseThreadLocalValue(_ pointer: UnsafeMutableRawPointer?) {
+    if let pointer = pointer {
+        Unmanaged<AnyObject>.fromOpaque(pointer).release()
+    }
+}
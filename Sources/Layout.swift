@@ -6,7 +6,7 @@
 // software distributed under the License is distributed on an "AS IS" BASIS,
 // WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 
-import CoreGraphics
+import Foundation
 
 /**
  A protocol for types that layout view frames.
@@ -105,6 +105,24 @@ public protocol Layout {
      then that view will be reused for the new layout. If there is more than one view with the same viewReuseId, then an arbitrary one will be reused.
      */
     var viewReuseId: String? { get }
+
+    /**
+     Identifies the measurement of this layout for a `LayoutMeasurementCache`.
+
+     Two layouts that return equal keys MUST produce the same measurement (including sublayout measurements) for the same `maxSize`.
+     Return nil to opt out of caching. The default implementation returns nil.
+     */
+    var measurementCacheKey: AnyHashable? { get }
+
+    /**
+     Indicates whether a view that this layout object configured can keep its configuration
+     when an arrangement of this layout is applied to it again (e.g. when a cell is displayed again or an animation is applied).
+     If true, `configure(baseTypeView:)` is only called again once another layout configured the view.
+
+     Only return true if configuring a view has no effect beyond setting its state, and nothing else changes that state.
+     The default implementation returns false.
+     */
+    var configuresViewsOnce: Bool { get }
 }
 
 public extension Layout {
@@ -121,14 +139,19 @@ public extension Layout {
     func arrangement(origin: CGPoint = .zero, width: CGFloat? = nil, height: CGFloat? = nil) -> LayoutArrangement {
 //        let start = CFAbsoluteTimeGetCurrent()
         let maxSize = CGSize(width: width ?? CGFloat.greatestFiniteMagnitude, height: height ?? CGFloat.greatestFiniteMagnitude)
-        let measurement = self.measurement(within: maxSize)
+        let measurement = self.cachedMeasurement(within: maxSize)
 //        let measureEnd = CFAbsoluteTimeGetCurrent()
         var rect = CGRect(origin: origin, size: measurement.size)
         rect.size.width = width ?? rect.size.width
         rect.size.height = height ?? rect.size.height
-        let arrangement = self.arrangement(within: rect, measurement: measurement)
+        let arrangement = measurement.arrangement(within: rect)
 //        let layoutEnd = CFAbsoluteTimeGetCurrent()
 //        NSLog("layout: \((layoutEnd-start).ms) (measure: \((measureEnd-start).ms) + layout: \((layoutEnd-measureEnd).ms))")
         return arrangement
     }
+
+    /// Views are configured each time an arrangement is applied to them, unless the layout opts out.
+    var configuresViewsOnce: Bool {
+        return false
+    }
 }
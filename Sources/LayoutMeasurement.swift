@@ -6,7 +6,7 @@
 // software distributed under the License is distributed on an "AS IS" BASIS,
 // WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 
-import CoreGraphics
+import Foundation
 
 /**
  The size of a layout and the sizes of its sublayouts.
@@ -34,6 +34,11 @@ public struct LayoutMeasurement {
 
     /// Convenience method to position this measured layout.
     public func arrangement(within rect: CGRect) -> LayoutArrangement {
+        if let profiler = LayoutProfiler.current {
+            return profiler.record(.arrangement, of: layout) {
+                return layout.arrangement(within: rect, measurement: self)
+            }
+        }
         return layout.arrangement(within: rect, measurement: self)
     }
 }
\ No newline at end of file
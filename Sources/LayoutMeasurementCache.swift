@@ -0,0 +1,214 @@
+// Copyright 2019 LinkedIn Corp.
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+
+import Foundation
+
+/**
+ A bounded, thread-safe cache of layout measurements.
+
+ Measurements are keyed by a layout's `measurementCacheKey` and the `maxSize` that the layout was measured within.
+ Layouts that return nil for `measurementCacheKey` are never cached.
+ When the cache holds more than `countLimit` measurements, the least recently used measurement is evicted.
+
+ The cache is opt-in. A cache is only consulted by layouts that are measured inside of `perform(_:)`:
+
+ ```
+ let cache = LayoutMeasurementCache(countLimit: 500)
+ let arrangement = cache.perform {
+     return layout.arrangement(width: 320)
+ }
+ ```
+
+ A single cache MAY be shared between threads (e.g. across reloads on `ReloadableViewLayoutAdapter.backgroundLayoutQueue`).
+ */
+public final class LayoutMeasurementCache {
+
+    /// The maximum number of measurements that the cache holds before it starts evicting.
+    public let countLimit: Int
+
+    private let lock = NSLock()
+    private var entries: LRUCache<Key, LayoutMeasurement>
+    private var hits = 0
+    private var misses = 0
+    private var evictions = 0
+
+    public init(countLimit: Int = 1000) {
+        precondition(countLimit > 0, "countLimit must be positive")
+        self.countLimit = countLimit
+        self.entries = LRUCache(costLimit: countLimit)
+    }
+
+    /// The number of measurements that were served from the cache.
+    public var hitCount: Int {
+        lock.lock()
+        defer { lock.unlock() }
+        return hits
+    }
+
+    /// The number of measurements that were computed because they were not in the cache.
+    public var missCount: Int {
+        lock.lock()
+        defer { lock.unlock() }
+        return misses
+    }
+
+    /// The number of measurements that were evicted to stay within `countLimit`.
+    public var evictionCount: Int {
+        lock.lock()
+        defer { lock.unlock() }
+        return evictions
+    }
+
+    /// The number of measurements currently in the cache.
+    public var count: Int {
+        lock.lock()
+        defer { lock.unlock() }
+        return entries.count
+    }
+
+    /// Removes all measurements from the cache. Counters are not reset.
+    public func removeAll() {
+        lock.lock()
+        defer { lock.unlock() }
+        entries.removeAll()
+    }
+
+    /// Resets the hit, miss and eviction counters to zero.
+    public func resetCounters() {
+        lock.lock()
+        defer { lock.unlock() }
+        hits = 0
+        misses = 0
+        evictions = 0
+    }
+
+    /**
+     Makes this cache the active measurement cache on the current thread while `body` runs.
+
+     Layouts that are measured inside of `body` through `cachedMeasurement(within:)`
+     (which all of the basic layouts use to measure their sublayouts) consult this cache.
+     Calls may be nested. The previously active cache is restored when `body` returns.
+     */
+    public func perform<T>(_ body: () throws -> T) rethrows -> T {
+        let previous = LayoutMeasurementCache.current
+        LayoutMeasurementCache.current = self
+        defer {
+            LayoutMeasurementCache.current = previous
+        }
+        return try body()
+    }
+
+    /**
+     Returns the measurement of `layout` within `maxSize`,
+     measuring it only if there is no cached measurement for an equivalent layout and size.
+     */
+    public func measurement(of layout: Layout, within maxSize: CGSize) -> LayoutMeasurement {
+        guard let layoutKey = layout.measurementCacheKey else {
+            return layout.measurement(within: maxSize)
+        }
+        let key = Key(layoutKey: layoutKey, width: maxSize.width, height: maxSize.height)
+
+        if let cached = cachedMeasurement(forKey: key) {
+            // The cached measurement may belong to a different, but equivalent, layout.
+            // Rebind it to this layout so that arrangement uses this layout's configuration.
+            return LayoutMeasurement(layout: layout, size: cached.size, maxSize: maxSize, sublayouts: cached.sublayouts)
+        }
+
+        // Measure outside of the lock so that concurrent measurements don't serialize.
+        let measurement = layout.measurement(within: maxSize)
+        insert(measurement, forKey: key)
+        return measurement
+    }
+
+    // MARK: - Synchronized storage
+
+    private func cachedMeasurement(forKey key: Key) -> LayoutMeasurement? {
+        lock.lock()
+        defer { lock.unlock() }
+        guard let measurement = entries.value(forKey: key) else {
+            misses += 1
+            return nil
+        }
+        hits += 1
+        return measurement
+    }
+
+    private func insert(_ measurement: LayoutMeasurement, forKey key: Key) {
+        lock.lock()
+        defer { lock.unlock() }
+        evictions += entries.setValue(measurement, forKey: key)
+    }
+
+    private struct Key: Hashable {
+        let layoutKey: AnyHashable
+        let width: CGFloat
+        let height: CGFloat
+    }
+}
+
+// MARK: - Active cache
+
+extension LayoutMeasurementCache {
+
+    /// The slot that holds the active cache of each thread.
+    private static let currentSlot = ThreadLocal<LayoutMeasurementCache>(retainsValues: false)
+
+    /// The cache that is active on the current thread, if any.
+    /// The cache is not retained by this slot; `perform(_:)` keeps it alive while it is active.
+    static var current: LayoutMeasurementCache? {
+        get {
+            return currentSlot.value
+        }
+        set {
+            currentSlot.value = newValue
+        }
+    }
+}
+
+// MARK: - Layout support
+
+public extension Layout {
+
+    /// Layouts are not cached unless they opt in by providing a key.
+    var measurementCacheKey: AnyHashable? {
+        return nil
+    }
+
+    /**
+     Measures the layout, consulting the `LayoutMeasurementCache` that is active on the current thread (if any).
+
+     Layouts that contain sublayouts SHOULD measure them with this method instead of `measurement(within:)`.
+     */
+    func cachedMeasurement(within maxSize: CGSize) -> LayoutMeasurement {
+        if let profiler = LayoutProfiler.current {
+            return profiler.record(.measurement, of: self) {
+                return measurementConsultingActiveCache(within: maxSize)
+            }
+        }
+        return measurementConsultingActiveCache(within: maxSize)
+    }
+
+    private func measurementConsultingActiveCache(within maxSize: CGSize) -> LayoutMeasurement {
+        guard let cache = LayoutMeasurementCache.current else {
+            return measurement(within: maxSize)
+        }
+        return cache.measurement(of: self, within: maxSize)
+    }
+}
+
+/// A content based `measurementCacheKey` for layouts that don't have sublayouts.
+struct LeafMeasurementCacheKey: Hashable {
+    let layoutType: ObjectIdentifier
+    let values: [AnyHashable]
+
+    /// `values` MUST include everything that the measurement of `layout` depends on.
+    init(layout: Layout, values: [AnyHashable]) {
+        self.layoutType = ObjectIdentifier(type(of: layout))
+        self.values = values
+    }
+}
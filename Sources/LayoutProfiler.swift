@@ -0,0 +1,281 @@
+// Copyright 2019 LinkedIn Corp.
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+
+import Foundation
+#if canImport(os)
+import os
+#endif
+
+/**
+ Records how long each node of a layout tree takes to measure and arrange.
+
+ Profiling is opt-in. Layouts are only profiled while they are measured and arranged inside of `perform(_:)`:
+
+ ```
+ let profiler = LayoutProfiler()
+ let arrangement = profiler.perform {
+     return layout.arrangement(width: 320)
+ }
+ try profiler.chromeTrace().write(to: url)
+ ```
+
+ Measurements are recorded by `cachedMeasurement(within:)` and arrangements by `LayoutMeasurement.arrangement(within:)`,
+ which all of the basic layouts use for their sublayouts. Each record is one interval of the trace,
+ so the time of a node includes the time of its sublayouts. The trace can be opened in `chrome://tracing` or
+ with any flame graph viewer that reads the Chrome trace format.
+
+ On Apple platforms, the intervals are also emitted as signposts (in the "Layout" category of `signpostSubsystem`),
+ so that they appear in Instruments.
+
+ When no profiler is active, profiling costs one thread-local lookup per node.
+ A single profiler MAY be shared between threads (e.g. across reloads on `ReloadableViewLayoutAdapter.backgroundLayoutQueue`).
+ */
+public final class LayoutProfiler {
+
+    /// The pass of the layout algorithm that an interval measures.
+    public enum Phase: String {
+        case measurement
+        case arrangement
+    }
+
+    /// The time that one node took to measure or arrange, including its sublayouts.
+    public struct Interval {
+
+        /// The type of the layout.
+        public let layoutType: String
+
+        /// The reuse id of the layout's view.
+        public let viewReuseId: String?
+
+        public let phase: Phase
+
+        /// The start of the interval, in seconds since the profiler was created.
+        public let start: TimeInterval
+
+        /// The length of the interval in seconds.
+        public let duration: TimeInterval
+
+        /// Identifies the thread that the interval was recorded on, within the profiler.
+        public let thread: Int
+
+        /// Identifies the layout object if the layout is a class, so that repeated calls for the same node can be counted.
+        let node: ObjectIdentifier?
+    }
+
+    /// The intervals of all nodes of one layout type.
+    public struct Summary {
+        public let layoutType: String
+
+        /// The number of times that layouts of this type were measured.
+        public internal(set) var measurementCount = 0
+
+        /// The number of times that layouts of this type were arranged.
+        public internal(set) var arrangementCount = 0
+
+        /// The number of measurements of layout objects that had already been measured (within any size).
+        /// Value type layouts can't be told apart, so they never count as repeated.
+        public internal(set) var repeatedMeasurementCount = 0
+
+        /// The total time of the measurements in seconds, including sublayouts.
+        public internal(set) var measurementDuration: TimeInterval = 0
+
+        /// The total time of the arrangements in seconds, including sublayouts.
+        public internal(set) var arrangementDuration: TimeInterval = 0
+
+        init(layoutType: String) {
+            self.layoutType = layoutType
+        }
+    }
+
+    /// The subsystem of the signposts that profilers emit.
+    public static var signpostSubsystem = "com.linkedin.LayoutKit"
+
+    /// Whether the profiler emits signposts. Default is true.
+    public var emitsSignposts = true
+
+    private let startTime = DispatchTime.now().uptimeNanoseconds
+    private let lock = NSLock()
+    private var recordedIntervals = [Interval]()
+    private var threads = [ObjectIdentifier: Int]()
+
+    /// The `OSLog` of the signposts, if signposts are available.
+    private let signpostLog: Any?
+
+    public init() {
+        #if canImport(os)
+        if #available(iOS 12.0, tvOS 12.0, macOS 10.14, *) {
+            signpostLog = OSLog(subsystem: LayoutProfiler.signpostSubsystem, category: "Layout")
+        } else {
+            signpostLog = nil
+        }
+        #else
+        signpostLog = nil
+        #endif
+    }
+
+    /// The recorded intervals, in the order that they ended.
+    public var intervals: [Interval] {
+        lock.lock()
+        defer { lock.unlock() }
+        return recordedIntervals
+    }
+
+    /// Removes all recorded intervals.
+    public func removeAll() {
+        lock.lock()
+        defer { lock.unlock() }
+        recordedIntervals.removeAll()
+    }
+
+    /**
+     Makes this profiler the active profiler on the current thread while `body` runs.
+
+     Calls may be nested. The previously active profiler is restored when `body` returns.
+     */
+    public func perform<T>(_ body: () throws -> T) rethrows -> T {
+        let previous = LayoutProfiler.current
+        LayoutProfiler.current = self
+        defer {
+            LayoutProfiler.current = previous
+        }
+        return try body()
+    }
+
+    /// The recorded intervals summarized by layout type, slowest measurement first.
+    public var summaries: [Summary] {
+        var summaries = [String: Summary]()
+        var measuredNodes = Set<ObjectIdentifier>()
+        for interval in intervals {
+            var summary = summaries[interval.layoutType] ?? Summary(layoutType: interval.layoutType)
+            switch interval.phase {
+            case .measurement:
+                summary.measurementCount += 1
+                summary.measurementDuration += interval.duration
+                if let node = interval.node, !measuredNodes.insert(node).inserted {
+                    summary.repeatedMeasurementCount += 1
+                }
+            case .arrangement:
+                summary.arrangementCount += 1
+                summary.arrangementDuration += interval.duration
+            }
+            summaries[interval.layoutType] = summary
+        }
+        return summaries.values.sorted { $0.measurementDuration > $1.measurementDuration }
+    }
+
+    /**
+     Returns the recorded intervals in the Chrome trace event format, as JSON.
+
+     Each interval is a complete ("X") event named after its layout type, with the phase as its category.
+     */
+    public func chromeTrace() throws -> Data {
+        let events = intervals.map { interval -> [String: Any] in
+            var args: [String: Any] = ["phase": interval.phase.rawValue]
+            if let viewReuseId = interval.viewReuseId {
+                args["viewReuseId"] = viewReuseId
+            }
+            return [
+                "name": interval.layoutType,
+                "cat": interval.phase.rawValue,
+                "ph": "X",
+                "ts": interval.start * 1_000_000,
+                "dur": interval.duration * 1_000_000,
+                "pid": 1,
+                "tid": interval.thread,
+                "args": args
+            ]
+        }
+        let trace: [String: Any] = ["traceEvents": events, "displayTimeUnit": "ms"]
+        return try JSONSerialization.data(withJSONObject: trace, options: [])
+    }
+
+    /// Measures the duration of `body` as an interval of `layout`.
+    func record<T>(_ phase: Phase, of layout: Layout, _ body: () -> T) -> T {
+        let layoutType = String(describing: type(of: layout))
+        let signpost = beginSignpost(phase, layoutType: layoutType)
+        let start = DispatchTime.now().uptimeNanoseconds
+        let result = body()
+        let end = DispatchTime.now().uptimeNanoseconds
+        endSignpost(signpost, phase: phase)
+
+        let node = type(of: layout) is AnyClass ? ObjectIdentifier(layout as AnyObject) : nil
+        let threadId = ObjectIdentifier(Thread.current)
+        lock.lock()
+        defer { lock.unlock() }
+        let thread: Int
+        if let existing = threads[threadId] {
+            thread = existing
+        } else {
+            thread = threads.count + 1
+            threads[threadId] = thread
+        }
+        recordedIntervals.append(Interval(
+            layoutType: layoutType,
+            viewReuseId: layout.viewReuseId,
+            phase: phase,
+            start: TimeInterval(start - startTime) / 1e9,
+            duration: TimeInterval(end - start) / 1e9,
+            thread: thread,
+            node: node))
+        return result
+    }
+
+    // MARK: - Signposts
+
+    /// Begins a signpost interval and returns its id, or nil if no signpost was emitted.
+    private func beginSignpost(_ phase: Phase, layoutType: String) -> Any? {
+        #if canImport(os)
+        guard emitsSignposts else {
+            return nil
+        }
+        if #available(iOS 12.0, tvOS 12.0, macOS 10.14, *), let signpostLog = signpostLog as? OSLog {
+            let id = OSSignpostID(log: signpostLog)
+            switch phase {
+            case .measurement:
+                os_signpost(.begin, log: signpostLog, name: "Measurement", signpostID: id, "%{public}s", layoutType)
+            case .arrangement:
+                os_signpost(.begin, log: signpostLog, name: "Arrangement", signpostID: id, "%{public}s", layoutType)
+            }
+            return id
+        }
+        #endif
+        return nil
+    }
+
+    private func endSignpost(_ signpost: Any?, phase: Phase) {
+        #if canImport(os)
+        if #available(iOS 12.0, tvOS 12.0, macOS 10.14, *), let id = signpost as? OSSignpostID, let signpostLog = signpostLog as? OSLog {
+            switch phase {
+            case .measurement:
+                os_signpost(.end, log: signpostLog, name: "Measurement", signpostID: id)
+            case .arrangement:
+                os_signpost(.end, log: signpostLog, name: "Arrangement", signpostID: id)
+            }
+        }
+        #endif
+    }
+}
+
+// MARK: - Active profiler
+
+extension LayoutProfiler {
+
+    /// The slot that holds the active profiler of each thread.
+    private static let currentSlot = ThreadLocal<LayoutProfiler>(retainsValues: false)
+
+    /// The profiler that is active on the current thread, if any.
+    /// The profiler is not retained by this slot; `perform(_:)` keeps it alive while it is active.
+    static var current: LayoutProfiler? {
+        get {
+            return currentSlot.value
+        }
+        set {
+            currentSlot.value = newValue
+        }
+    }
+}
@@ -0,0 +1,95 @@
+// Copyright 2019 LinkedIn Corp.
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+
+import Foundation
+
+/**
+ Reusable buffers for the temporary arrays that layouts need while they measure and arrange their sublayouts.
+
+ Each thread has its own pool, so buffers are never shared between threads and no locking is needed.
+ A buffer is borrowed for the duration of a closure and returned to the pool (with its capacity) afterwards,
+ so once a pool has served a layout pass of a given shape, repeating that pass doesn't allocate any temporary arrays.
+
+ The counters can be used to verify that layout passes reuse buffers:
+
+ ```
+ let pool = LayoutScratchBufferPool.current
+ _ = layout.arrangement(width: 320)
+ pool.resetCounters()
+ _ = layout.arrangement(width: 320)
+ assert(pool.allocationCount == 0)
+ ```
+ */
+public final class LayoutScratchBufferPool {
+
+    /// The number of times that a buffer had to be allocated or grown because the pool didn't have a large enough one.
+    public private(set) var allocationCount = 0
+
+    /// The number of times that a pooled buffer was reused without allocating.
+    public private(set) var reuseCount = 0
+
+    private var measurementBuffers = [[LayoutMeasurement?]]()
+    private var sizeBuffers = [[CGSize]]()
+
+    init() {}
+
+    /// Resets the allocation and reuse counters to zero.
+    public func resetCounters() {
+        allocationCount = 0
+        reuseCount = 0
+    }
+
+    /// Calls `body` with a buffer of `count` nil measurements.
+    func withMeasurementBuffer<Result>(count: Int, _ body: (inout [LayoutMeasurement?]) -> Result) -> Result {
+        var buffer = borrow(from: &measurementBuffers, minimumCapacity: count)
+        buffer.append(contentsOf: repeatElement(nil, count: count))
+        let result = body(&buffer)
+        // Release the measurements but keep the capacity.
+        buffer.removeAll(keepingCapacity: true)
+        measurementBuffers.append(buffer)
+        return result
+    }
+
+    /// Calls `body` with an empty buffer that has capacity for `count` sizes.
+    func withSizeBuffer<Result>(count: Int, _ body: (inout [CGSize]) -> Result) -> Result {
+        var buffer = borrow(from: &sizeBuffers, minimumCapacity: count)
+        let result = body(&buffer)
+        buffer.removeAll(keepingCapacity: true)
+        sizeBuffers.append(buffer)
+        return result
+    }
+
+    private func borrow<Element>(from buffers: inout [[Element]], minimumCapacity: Int) -> [Element] {
+        guard var buffer = buffers.popLast() else {
+            allocationCount += 1
+            var buffer = [Element]()
+            buffer.reserveCapacity(minimumCapacity)
+            return buffer
+        }
+        if buffer.capacity < minimumCapacity {
+            allocationCount += 1
+            buffer.reserveCapacity(minimumCapacity)
+        } else {
+            reuseCount += 1
+        }
+        return buffer
+    }
+}
+
+// MARK: - Per-thread pool
+
+extension LayoutScratchBufferPool {
+
+    /// The slot that holds the pool of each thread. It retains the pool until the thread exits.
+    private static let currentSlot = ThreadLocal<LayoutScratchBufferPool>(retainsValues: true)
+
+    /// The pool of the current thread. It is created the first time that it is used on each thread.
+    public static var current: LayoutScratchBufferPool {
+        return currentSlot.value(orMake: { LayoutScratchBufferPool() })
+    }
+}
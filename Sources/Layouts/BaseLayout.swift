@@ -40,6 +40,7 @@ open class BaseLayout<V: View> {
         self.config = config
     }
 
+    /// Creates a layout whose views are instances of `viewClass`, which is a subclass of `V`.
     init(alignment: Alignment, flexibility: Flexibility, viewReuseId: String? = nil, viewClass: V.Type, config: ((V) -> Void)?) {
         self.alignment = alignment
         self.flexibility = flexibility
@@ -55,4 +56,23 @@ open class BaseLayout<V: View> {
     open func makeView() -> View {
         return viewClass.init()
     }
+
+    /// The class of the views that `makeView()` creates, if a view that another layout of the same class configured can be reused.
+    /// `ViewPool` only hands views between layouts that return the same class.
+    /// Subclasses return nil if configuring a view can't reset all of its state (e.g. the type of a `UIButton` is fixed when it is created).
+    open var reusableViewClass: View.Type? {
+        return viewClass
+    }
+
+    /// Layouts are immutable, so the identity of the layout is enough to identify its measurement.
+    /// Subclasses MAY return a content based key so that equivalent layouts share cached measurements.
+    open var measurementCacheKey: AnyHashable? {
+        return ObjectIdentifier(self)
+    }
+
+    /// Configurations (e.g. `config`) may have effects beyond the view, so views are configured each time by default.
+    /// Subclasses MAY return true if configuring a view only sets its state.
+    open var configuresViewsOnce: Bool {
+        return false
+    }
 }
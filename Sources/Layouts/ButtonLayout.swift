@@ -120,7 +120,7 @@ open class ButtonLayout<Button: UIButton>: BaseLayout<Button>, ConfigurableLayou
     }
 
     private func sizeOf(text: Text, maxSize: CGSize) -> CGSize {
-        return LabelLayout(text: text, font: fontForMeasurement, numberOfLines: 0).measurement(within: maxSize).size
+        return LabelLayout(text: text, font: fontForMeasurement, numberOfLines: 0).cachedMeasurement(within: maxSize).size
     }
 
     /**
@@ -224,10 +224,32 @@ open class ButtonLayout<Button: UIButton>: BaseLayout<Button>, ConfigurableLayou
         return LayoutArrangement(layout: self, frame: frame, sublayouts: [])
     }
 
+    /// Buttons with the same type, title and image size have the same measurement, so they can share cached measurements.
+    open override var measurementCacheKey: AnyHashable? {
+        let imageSize = sizeOf(image: image)
+        return LeafMeasurementCacheKey(layout: self, values: [
+            type,
+            title.measurementCacheKey,
+            font,
+            hasCustomImage,
+            imageSize.width,
+            imageSize.height,
+            contentEdgeInsets.top,
+            contentEdgeInsets.left,
+            contentEdgeInsets.bottom,
+            contentEdgeInsets.right
+        ])
+    }
+
     open override func makeView() -> View {
         return Button(type: type.buttonType)
     }
 
+    /// Buttons are not pooled because their type can't be changed after they are created.
+    open override var reusableViewClass: View.Type? {
+        return nil
+    }
+
     open override func configure(view: Button) {
         config?(view)
         view.contentEdgeInsets = contentEdgeInsets
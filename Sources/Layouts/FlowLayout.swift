@@ -0,0 +1,195 @@
+// Copyright 2019 LinkedIn Corp.
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+
+import Foundation
+
+/**
+ A layout that places sublayouts along an axis and wraps them onto a new line when a line is full (e.g. a tag cloud).
+
+ Each sublayout is measured once, within the whole available size, and lines are packed greedily in order.
+ Space along each line is distributed like the space along a `StackLayout` with the same distribution,
+ and each sublayout is aligned within the cross length of its line by its own alignment.
+
+ If there isn't enough space across the axis for a sublayout, then it and the sublayouts after it are dropped, and the ones after it aren't measured.
+ */
+open class FlowLayout<V: View>: BaseLayout<V>, ConfigurableLayout {
+
+    /// The axis of each line. Lines are stacked across it.
+    public let axis: Axis
+
+    /// The distance in points between adjacent sublayouts in a line.
+    /// For `.fillEqualSpacing`, this is a minimum spacing. For all other distributions it is an exact spacing.
+    public let spacing: CGFloat
+
+    /// The distance in points between adjacent lines.
+    public let lineSpacing: CGFloat
+
+    /// The distribution of space along each line.
+    public let distribution: StackLayoutDistribution
+
+    /// The layouts that flow along the lines.
+    public let sublayouts: [Layout]
+
+    public init(axis: Axis = .horizontal,
+                spacing: CGFloat = 0,
+                lineSpacing: CGFloat = 0,
+                distribution: StackLayoutDistribution = .leading,
+                alignment: Alignment = .fill,
+                flexibility: Flexibility? = nil,
+                viewReuseId: String? = nil,
+                sublayouts: [Layout],
+                config: ((V) -> Void)? = nil) {
+
+        self.axis = axis
+        self.spacing = spacing
+        self.lineSpacing = lineSpacing
+        self.distribution = distribution
+        self.sublayouts = sublayouts
+        super.init(alignment: alignment, flexibility: flexibility ?? .flexible, viewReuseId: viewReuseId, config: config)
+    }
+
+    // MARK: - Layout interface
+
+    open func measurement(within maxSize: CGSize) -> LayoutMeasurement {
+        let availableSize = AxisSize(axis: axis, size: maxSize)
+        var usedSize = AxisSize(axis: axis, size: .zero)
+        var sublayoutMeasurements = [LayoutMeasurement]()
+        guard availableSize.axisLength > 0 && availableSize.crossLength > 0 else {
+            return LayoutMeasurement(layout: self, size: usedSize.size, maxSize: maxSize, sublayouts: sublayoutMeasurements)
+        }
+        sublayoutMeasurements.reserveCapacity(sublayouts.count)
+
+        // The line that is being packed.
+        var line = AxisSize(axis: axis, size: .zero)
+        var lineCrossOffset: CGFloat = 0
+        for sublayout in sublayouts {
+            let sublayoutMeasurement = sublayout.cachedMeasurement(within: maxSize)
+            let sublayoutSize = AxisSize(axis: axis, size: sublayoutMeasurement.size)
+            var sublayoutCrossOffset = lineCrossOffset
+            let startsLine = !sublayoutMeasurements.isEmpty && line.axisLength + spacing + sublayoutSize.axisLength > availableSize.axisLength
+            if startsLine {
+                sublayoutCrossOffset += line.crossLength + lineSpacing
+            }
+            if sublayoutCrossOffset + sublayoutSize.crossLength > availableSize.crossLength {
+                // There is no more room across the axis so don't bother measuring the rest of the sublayouts.
+                break
+            }
+            if startsLine {
+                usedSize.axisLength = max(usedSize.axisLength, line.axisLength)
+                lineCrossOffset = sublayoutCrossOffset
+                line = AxisSize(axis: axis, size: .zero)
+            } else if !sublayoutMeasurements.isEmpty {
+                line.axisLength += spacing
+            }
+            line.axisLength += sublayoutSize.axisLength
+            line.crossLength = max(line.crossLength, sublayoutSize.crossLength)
+            sublayoutMeasurements.append(sublayoutMeasurement)
+        }
+        if !sublayoutMeasurements.isEmpty {
+            usedSize.axisLength = max(usedSize.axisLength, line.axisLength)
+            usedSize.crossLength = lineCrossOffset + line.crossLength
+        }
+        return LayoutMeasurement(layout: self, size: usedSize.size, maxSize: maxSize, sublayouts: sublayoutMeasurements)
+    }
+
+    open func arrangement(within rect: CGRect, measurement: LayoutMeasurement) -> LayoutArrangement {
+        let frame = alignment.position(size: measurement.size, in: rect)
+        let frameSize = AxisSize(axis: axis, size: frame.size)
+
+        // Lines are packed again within the measured length, which reproduces the measured lines
+        // because every measured line fits within it and no line could be extended within a shorter length.
+        let maxLineLength = AxisSize(axis: axis, size: measurement.size).axisLength
+        let sublayouts = measurement.sublayouts
+        var sublayoutArrangements = [LayoutArrangement]()
+        sublayoutArrangements.reserveCapacity(sublayouts.count)
+
+        // The sizes are copied relative to the axis (width is the axis length) into a pooled buffer so that packing reads contiguous memory.
+        LayoutScratchBufferPool.current.withSizeBuffer(count: sublayouts.count) { (sizes: inout [CGSize]) in
+            for sublayout in sublayouts {
+                let size = AxisSize(axis: axis, size: sublayout.size)
+                sizes.append(CGSize(width: size.axisLength, height: size.crossLength))
+            }
+
+            var lineStart = 0
+            var lineCrossOffset: CGFloat = 0
+            while lineStart < sizes.count {
+                var lineEnd = lineStart + 1
+                var lineLength = sizes[lineStart].width
+                var lineCrossLength = sizes[lineStart].height
+                while lineEnd < sizes.count && lineLength + spacing + sizes[lineEnd].width <= maxLineLength {
+                    lineLength += spacing + sizes[lineEnd].width
+                    lineCrossLength = max(lineCrossLength, sizes[lineEnd].height)
+                    lineEnd += 1
+                }
+
+                let line = lineStart..<lineEnd
+                let config = distributionConfig(line: line, excessAxisLength: frameSize.axisLength - lineLength)
+                let equalAxisLength = (frameSize.axisLength - spacing * CGFloat(line.count - 1)) / CGFloat(line.count)
+                var nextOrigin = AxisPoint(axis: axis, axisOffset: config.initialAxisOffset, crossOffset: lineCrossOffset)
+                for index in line {
+                    var sublayoutAxisLength = sizes[index].width
+                    if distribution == .fillEqualSize {
+                        sublayoutAxisLength = equalAxisLength
+                    } else if config.stretchIndex == index {
+                        sublayoutAxisLength += frameSize.axisLength - lineLength
+                    }
+                    let sublayoutSize = AxisSize(axis: axis, axisLength: sublayoutAxisLength, crossLength: lineCrossLength)
+                    sublayoutArrangements.append(sublayouts[index].arrangement(within: CGRect(origin: nextOrigin.point, size: sublayoutSize.size)))
+                    nextOrigin.axisOffset += sublayoutAxisLength + config.axisSpacing
+                }
+
+                lineCrossOffset += lineCrossLength + lineSpacing
+                lineStart = lineEnd
+            }
+        }
+        return LayoutArrangement(layout: self, frame: frame, sublayouts: sublayoutArrangements)
+    }
+
+    // MARK: - Distribution
+
+    private func distributionConfig(line: Range<Int>, excessAxisLength: CGFloat) -> FlowLayoutLineConfig {
+        switch distribution {
+        case .leading, .fillEqualSize:
+            return FlowLayoutLineConfig(initialAxisOffset: 0, axisSpacing: spacing, stretchIndex: nil)
+        case .trailing:
+            return FlowLayoutLineConfig(initialAxisOffset: excessAxisLength, axisSpacing: spacing, stretchIndex: nil)
+        case .center:
+            return FlowLayoutLineConfig(initialAxisOffset: excessAxisLength / 2.0, axisSpacing: spacing, stretchIndex: nil)
+        case .fillEqualSpacing:
+            guard line.count > 1 else {
+                return FlowLayoutLineConfig(initialAxisOffset: 0, axisSpacing: spacing, stretchIndex: nil)
+            }
+            let numberOfSpaces = CGFloat(line.count - 1)
+            let axisSpacing = (excessAxisLength + numberOfSpaces * spacing) / numberOfSpaces
+            return FlowLayoutLineConfig(initialAxisOffset: 0, axisSpacing: axisSpacing, stretchIndex: nil)
+        case .fillFlexing:
+            // Like a stack, the most flexible sublayout of the line is stretched, or the last one if several are equally flexible.
+            var stretchIndex: Int? = nil
+            var stretchFlex: Flexibility.Flex = nil
+            if excessAxisLength > 0 {
+                for index in line {
+                    guard let flex = sublayouts[index].flexibility.flex(axis) else {
+                        continue
+                    }
+                    if let maxFlex = stretchFlex, flex < maxFlex {
+                        continue
+                    }
+                    stretchIndex = index
+                    stretchFlex = flex
+                }
+            }
+            return FlowLayoutLineConfig(initialAxisOffset: 0, axisSpacing: spacing, stretchIndex: stretchIndex)
+        }
+    }
+}
+
+private struct FlowLayoutLineConfig {
+    let initialAxisOffset: CGFloat
+    let axisSpacing: CGFloat
+    let stretchIndex: Int?
+}
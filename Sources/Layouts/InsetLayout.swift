@@ -6,7 +6,6 @@
 // software distributed under the License is distributed on an "AS IS" BASIS,
 // WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 
-import CoreGraphics
 import Foundation
 
 /**
@@ -51,7 +50,7 @@ open class InsetLayout<V: View>: BaseLayout<V>, ConfigurableLayout {
 
     open func measurement(within maxSize: CGSize) -> LayoutMeasurement {
         let insetMaxSize = maxSize.decreased(by: insets)
-        let sublayoutMeasurement = sublayout.measurement(within: insetMaxSize)
+        let sublayoutMeasurement = sublayout.cachedMeasurement(within: insetMaxSize)
         let size = sublayoutMeasurement.size.increased(by: insets)
         return LayoutMeasurement(layout: self, size: size, maxSize: maxSize, sublayouts: [sublayoutMeasurement])
     }
@@ -19,11 +19,18 @@ open class LabelLayout<Label: UILabel>: BaseLayout<Label>, ConfigurableLayout {
     public let lineHeight: CGFloat
     public let lineBreakMode: NSLineBreakMode
 
+    /**
+     How the text is measured. `.textKit` makes the height of a label with a number of lines exact.
+     TextKit measures lines at the height of the font, so labels with a custom `lineHeight` are measured with `.boundingRect`.
+     */
+    public let measurementBackend: TextMeasurementBackend
+
     public init(text: Text,
                 font: UIFont = LabelLayoutDefaults.defaultFont,
                 lineHeight: CGFloat? = nil,
                 numberOfLines: Int = LabelLayoutDefaults.defaultNumberOfLines,
                 lineBreakMode: NSLineBreakMode = LabelLayoutDefaults.defaultLineBreakMode,
+                measurementBackend: TextMeasurementBackend = LabelLayoutDefaults.defaultMeasurementBackend,
                 alignment: Alignment = LabelLayoutDefaults.defaultAlignment,
                 flexibility: Flexibility = LabelLayoutDefaults.defaultFlexibility,
                 viewReuseId: String? = nil,
@@ -34,6 +41,7 @@ open class LabelLayout<Label: UILabel>: BaseLayout<Label>, ConfigurableLayout {
         self.font = font
         self.lineHeight = lineHeight ?? font.lineHeight
         self.lineBreakMode = lineBreakMode
+        self.measurementBackend = measurementBackend
         super.init(alignment: alignment, flexibility: flexibility, viewReuseId: viewReuseId, config: config)
     }
 
@@ -42,6 +50,7 @@ open class LabelLayout<Label: UILabel>: BaseLayout<Label>, ConfigurableLayout {
          lineHeight: CGFloat? = nil,
          numberOfLines: Int = LabelLayoutDefaults.defaultNumberOfLines,
          lineBreakMode: NSLineBreakMode = LabelLayoutDefaults.defaultLineBreakMode,
+         measurementBackend: TextMeasurementBackend = LabelLayoutDefaults.defaultMeasurementBackend,
          alignment: Alignment = LabelLayoutDefaults.defaultAlignment,
          flexibility: Flexibility = LabelLayoutDefaults.defaultFlexibility,
          viewReuseId: String? = nil,
@@ -53,6 +62,7 @@ open class LabelLayout<Label: UILabel>: BaseLayout<Label>, ConfigurableLayout {
         self.font = font
         self.lineHeight = lineHeight ?? font.lineHeight
         self.lineBreakMode = lineBreakMode
+        self.measurementBackend = measurementBackend
         super.init(alignment: alignment, flexibility: flexibility, viewReuseId: viewReuseId, viewClass: viewClass ?? Label.self, config: config)
     }
 
@@ -61,6 +71,7 @@ open class LabelLayout<Label: UILabel>: BaseLayout<Label>, ConfigurableLayout {
          lineHeight: CGFloat? = nil,
          numberOfLines: Int = LabelLayoutDefaults.defaultNumberOfLines,
          lineBreakMode: NSLineBreakMode = LabelLayoutDefaults.defaultLineBreakMode,
+         measurementBackend: TextMeasurementBackend = LabelLayoutDefaults.defaultMeasurementBackend,
          alignment: Alignment = LabelLayoutDefaults.defaultAlignment,
          flexibility: Flexibility = LabelLayoutDefaults.defaultFlexibility,
          viewReuseId: String? = nil,
@@ -72,6 +83,7 @@ open class LabelLayout<Label: UILabel>: BaseLayout<Label>, ConfigurableLayout {
         self.font = font
         self.lineHeight = lineHeight ?? font.lineHeight
         self.lineBreakMode = lineBreakMode
+        self.measurementBackend = measurementBackend
         super.init(alignment: alignment, flexibility: flexibility, viewReuseId: viewReuseId, viewClass: viewClass ?? Label.self, config: config)
     }
 
@@ -82,6 +94,7 @@ open class LabelLayout<Label: UILabel>: BaseLayout<Label>, ConfigurableLayout {
                             lineHeight: CGFloat? = nil,
                             numberOfLines: Int = LabelLayoutDefaults.defaultNumberOfLines,
                             lineBreakMode: NSLineBreakMode = LabelLayoutDefaults.defaultLineBreakMode,
+                            measurementBackend: TextMeasurementBackend = LabelLayoutDefaults.defaultMeasurementBackend,
                             alignment: Alignment = LabelLayoutDefaults.defaultAlignment,
                             flexibility: Flexibility = LabelLayoutDefaults.defaultFlexibility,
                             viewReuseId: String? = nil,
@@ -92,6 +105,7 @@ open class LabelLayout<Label: UILabel>: BaseLayout<Label>, ConfigurableLayout {
                   lineHeight: lineHeight,
                   numberOfLines: numberOfLines,
                   lineBreakMode: lineBreakMode,
+                  measurementBackend: measurementBackend,
                   alignment: alignment,
                   flexibility: flexibility,
                   viewReuseId: viewReuseId,
@@ -103,6 +117,7 @@ open class LabelLayout<Label: UILabel>: BaseLayout<Label>, ConfigurableLayout {
                             lineHeight: CGFloat? = nil,
                             numberOfLines: Int = LabelLayoutDefaults.defaultNumberOfLines,
                             lineBreakMode: NSLineBreakMode = LabelLayoutDefaults.defaultLineBreakMode,
+                            measurementBackend: TextMeasurementBackend = LabelLayoutDefaults.defaultMeasurementBackend,
                             alignment: Alignment = LabelLayoutDefaults.defaultAlignment,
                             flexibility: Flexibility = LabelLayoutDefaults.defaultFlexibility,
                             viewReuseId: String? = nil,
@@ -113,6 +128,7 @@ open class LabelLayout<Label: UILabel>: BaseLayout<Label>, ConfigurableLayout {
                   lineHeight: lineHeight,
                   numberOfLines: numberOfLines,
                   lineBreakMode: lineBreakMode,
+                  measurementBackend: measurementBackend,
                   alignment: alignment,
                   flexibility: flexibility,
                   viewReuseId: viewReuseId,
@@ -127,6 +143,10 @@ open class LabelLayout<Label: UILabel>: BaseLayout<Label>, ConfigurableLayout {
     }
 
     private func textSize(within maxSize: CGSize) -> CGSize {
+        if measurementBackend == .textKit && lineHeight == font.lineHeight {
+            // TextKit lays out at most `numberOfLines` lines, so the size doesn't need to be clamped.
+            return text.textSize(within: maxSize, font: font, lineBreakMode: lineBreakMode, numberOfLines: numberOfLines, backend: .textKit)
+        }
         var size = text.textSize(within: maxSize, font: font, lineBreakMode: lineBreakMode)
         if numberOfLines > 0 {
             let maxHeight = (CGFloat(numberOfLines) * lineHeight).roundedUpToFractionalPoint
@@ -142,6 +162,18 @@ open class LabelLayout<Label: UILabel>: BaseLayout<Label>, ConfigurableLayout {
         return LayoutArrangement(layout: self, frame: frame, sublayouts: [])
     }
 
+    /// Labels with the same text and text attributes have the same measurement, so they can share cached measurements.
+    open override var measurementCacheKey: AnyHashable? {
+        return LeafMeasurementCacheKey(layout: self, values: [
+            text.measurementCacheKey,
+            font,
+            numberOfLines,
+            lineHeight,
+            lineBreakMode.rawValue,
+            measurementBackend
+        ])
+    }
+
     open override func configure(view label: Label) {
         config?(label)
         label.numberOfLines = numberOfLines
@@ -155,6 +187,12 @@ open class LabelLayout<Label: UILabel>: BaseLayout<Label>, ConfigurableLayout {
         }
     }
 
+    /// Setting the text of a label invalidates its text layout, so a label is only configured again by another layout,
+    /// unless a configuration block, which may have other effects, is provided.
+    open override var configuresViewsOnce: Bool {
+        return config == nil
+    }
+
     open override var needsView: Bool {
         return true
     }
@@ -168,6 +206,7 @@ public class LabelLayoutDefaults {
     public static let defaultFont = UILabel().font ?? UIFont.systemFont(ofSize: 17)
     public static let defaultAlignment = Alignment.topLeading
     public static let defaultLineBreakMode = NSLineBreakMode.byTruncatingTail
+    public static let defaultMeasurementBackend = TextMeasurementBackend.boundingRect
     public static let defaultFlexibility = Flexibility.flexible
 }
 
@@ -6,7 +6,7 @@
 // software distributed under the License is distributed on an "AS IS" BASIS,
 // WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 
-import CoreGraphics
+import Foundation
 
 /**
  A layout that overlays others. Allows adding other layouts behind or above one or more primary layouts.
@@ -80,15 +80,25 @@ extension OverlayLayout: ConfigurableLayout {
      Measure all layouts and return the layout measurement with the size of the primary layout.
      */
     open func measurement(within maxSize: CGSize) -> LayoutMeasurement {
-        let measuredPrimaryLayouts = primary.map { $0.measurement(within: maxSize)}
-        let maxWidth = measuredPrimaryLayouts.map { $0.size.width }.max() ?? 0
-        let maxHeight = measuredPrimaryLayouts.map { $0.size.height }.max() ?? 0
-        let maxPrimarySize = CGSize(width: maxWidth, height: maxHeight)
+        // Measure straight into the array that the measurement retains, in arrangement order, to avoid temporary arrays.
+        var measuredSublayouts = [LayoutMeasurement]()
+        measuredSublayouts.reserveCapacity(background.count + primary.count + overlay.count)
+        for sublayout in background {
+            measuredSublayouts.append(sublayout.cachedMeasurement(within: maxSize))
+        }
 
-        // Measure the background and overlay layouts
-        let measuredBackgroundLayouts = background.map { $0.measurement(within: maxSize) }
-        let measuredOverlayLayouts = overlay.map { $0.measurement(within: maxSize) }
-        let measuredSublayouts = Array([measuredBackgroundLayouts, measuredPrimaryLayouts, measuredOverlayLayouts].joined())
+        var maxPrimarySize = CGSize.zero
+        for sublayout in primary {
+            let measurement = sublayout.cachedMeasurement(within: maxSize)
+            maxPrimarySize.width = max(maxPrimarySize.width, measurement.size.width)
+            maxPrimarySize.height = max(maxPrimarySize.height, measurement.size.height)
+            measuredSublayouts.append(measurement)
+        }
+
+        // Measure the overlay layouts
+        for sublayout in overlay {
+            measuredSublayouts.append(sublayout.cachedMeasurement(within: maxSize))
+        }
         return LayoutMeasurement(layout: self, size: maxPrimarySize, maxSize: maxSize, sublayouts: measuredSublayouts)
     }
 
@@ -103,7 +113,7 @@ extension OverlayLayout: ConfigurableLayout {
         let sublayoutRect = CGRect(origin: CGPoint.zero, size: frame.size)
         let sublayoutArrangements = measurement.sublayouts.map { $0.arrangement(within: sublayoutRect) }
 
-        return LayoutArrangement(layout: self, frame: frame, sublayouts: Array(sublayoutArrangements))
+        return LayoutArrangement(layout: self, frame: frame, sublayouts: sublayoutArrangements)
     }
 
 }
@@ -6,7 +6,7 @@
 // software distributed under the License is distributed on an "AS IS" BASIS,
 // WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 
-import CoreGraphics
+import Foundation
 
 /**
  A layout that has size constraints.
@@ -258,7 +258,7 @@ open class SizeLayout<V: View>: BaseLayout<V>, ConfigurableLayout {
         let availableSize = maxSize.decreasedToSize(CGSize(width: maxWidth ?? .greatestFiniteMagnitude, height: maxHeight ?? .greatestFiniteMagnitude))
 
         // Measure the sublayout if it exists.
-        let sublayoutMeasurement = sublayout?.measurement(within: availableSize)
+        let sublayoutMeasurement = sublayout?.cachedMeasurement(within: availableSize)
         let sublayoutSize = sublayoutMeasurement?.size ?? .zero
 
         // Make sure that our size is in the desired range.
@@ -6,7 +6,7 @@
 // software distributed under the License is distributed on an "AS IS" BASIS,
 // WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 
-import CoreGraphics
+import Foundation
 
 /**
  A layout that stacks sublayouts along an axis.
@@ -33,6 +33,9 @@ open class StackLayout<V: View>: BaseLayout<V> {
     /// The stacked layouts.
     public let sublayouts: [Layout]
 
+    /// The measurement order and stretch index, which only depend on the sublayouts so they are computed once.
+    private let flexing: StackLayoutFlexing
+
     public init(axis: Axis,
                 spacing: CGFloat = 0,
                 distribution: StackLayoutDistribution = .fillFlexing,
@@ -46,7 +49,9 @@ open class StackLayout<V: View>: BaseLayout<V> {
         self.spacing = spacing
         self.distribution = distribution
         self.sublayouts = sublayouts
-        let flexibility = flexibility ?? StackLayout.defaultFlexibility(axis: axis, sublayouts: sublayouts)
+        let flexing = StackLayoutFlexing(axis: axis, sublayouts: sublayouts)
+        self.flexing = flexing
+        let flexibility = flexibility ?? flexing.defaultFlexibility
         super.init(alignment: alignment, flexibility: flexibility, viewReuseId: viewReuseId, config: config)
     }
 
@@ -64,7 +69,9 @@ open class StackLayout<V: View>: BaseLayout<V> {
         self.spacing = spacing
         self.distribution = distribution
         self.sublayouts = sublayouts
-        let flexibility = flexibility ?? StackLayout.defaultFlexibility(axis: axis, sublayouts: sublayouts)
+        let flexing = StackLayoutFlexing(axis: axis, sublayouts: sublayouts)
+        self.flexing = flexing
+        let flexibility = flexibility ?? flexing.defaultFlexibility
         super.init(alignment: alignment, flexibility: flexibility, viewReuseId: viewReuseId, viewClass: viewClass ?? V.self, config: config)
     }
 }
@@ -74,8 +81,18 @@ open class StackLayout<V: View>: BaseLayout<V> {
 extension StackLayout: ConfigurableLayout {
 
     public func measurement(within maxSize: CGSize) -> LayoutMeasurement {
+        // Temporary arrays are borrowed from the thread's pool so that repeated passes don't allocate them.
+        let pool = LayoutScratchBufferPool.current
+        return pool.withMeasurementBuffer(count: sublayouts.count) { (sublayoutMeasurements: inout [LayoutMeasurement?]) -> LayoutMeasurement in
+            return measurement(within: maxSize, sublayoutMeasurements: &sublayoutMeasurements)
+        }
+    }
+
+    /**
+     Measures the sublayouts from least to most flexible into `sublayoutMeasurements`, which is indexed by sublayout index.
+     */
+    private func measurement(within maxSize: CGSize, sublayoutMeasurements: inout [LayoutMeasurement?]) -> LayoutMeasurement {
         var availableSize = AxisSize(axis: axis, size: maxSize)
-        var sublayoutMeasurements = [LayoutMeasurement?](repeating: nil, count: sublayouts.count)
         var usedSize = AxisSize(axis: axis, size: .zero)
 
         let sublayoutLengthForEqualSizeDistribution: CGFloat?
@@ -86,7 +103,7 @@ extension StackLayout: ConfigurableLayout {
             sublayoutLengthForEqualSizeDistribution = nil
         }
 
-        for (index, sublayout) in sublayoutsByAxisFlexibilityAscending() {
+        for index in flexing.measurementOrder {
             if availableSize.axisLength <= 0 || availableSize.crossLength <= 0 {
                 // There is no more room in the stack so don't bother measuring the rest of the sublayouts.
                 break
@@ -101,7 +118,7 @@ extension StackLayout: ConfigurableLayout {
                 sublayoutMasurementAvailableSize = availableSize.size
             }
 
-            let sublayoutMeasurement = sublayout.measurement(within: sublayoutMasurementAvailableSize)
+            let sublayoutMeasurement = sublayouts[index].cachedMeasurement(within: sublayoutMasurementAvailableSize)
             sublayoutMeasurements[index] = sublayoutMeasurement
             let sublayoutAxisSize = AxisSize(axis: axis, size: sublayoutMeasurement.size)
 
@@ -117,10 +134,16 @@ extension StackLayout: ConfigurableLayout {
             }
         }
 
-        let nonNilMeasuredSublayouts = sublayoutMeasurements.compactMap { $0 }
+        // This array is retained by the measurement, so it is the only one that is allocated.
+        var nonNilMeasuredSublayouts = [LayoutMeasurement]()
+        nonNilMeasuredSublayouts.reserveCapacity(sublayoutMeasurements.count)
+        var maxAxisLength: CGFloat = 0
+        for case let sublayoutMeasurement? in sublayoutMeasurements {
+            nonNilMeasuredSublayouts.append(sublayoutMeasurement)
+            maxAxisLength = max(maxAxisLength, AxisSize(axis: axis, size: sublayoutMeasurement.size).axisLength)
+        }
 
         if distribution == .fillEqualSize && !nonNilMeasuredSublayouts.isEmpty {
-            let maxAxisLength = nonNilMeasuredSublayouts.map({ AxisSize(axis: axis, size: $0.size).axisLength }).max() ?? 0
             usedSize.axisLength = (maxAxisLength + spacing) * CGFloat(nonNilMeasuredSublayouts.count) - spacing
         }
 
@@ -135,6 +158,7 @@ extension StackLayout: ConfigurableLayout {
 
         var nextOrigin = AxisPoint(axis: axis, axisOffset: config.initialAxisOffset, crossOffset: 0)
         var sublayoutArrangements = [LayoutArrangement]()
+        sublayoutArrangements.reserveCapacity(measurement.sublayouts.count)
         for (index, sublayout) in measurement.sublayouts.enumerated() {
             var sublayoutAvailableSize = AxisSize(axis: axis, size: sublayout.size)
             sublayoutAvailableSize.crossLength = availableSize.crossLength
@@ -246,61 +270,120 @@ extension StackLayout {
             axisSpacing = spacing
             initialAxisOffset = 0
             if excessAxisLength > 0 {
-                stretchIndex = stretchableSublayoutIndex()
+                stretchIndex = flexing.stretchIndex
             }
         }
         return DistributionConfig(initialAxisOffset: initialAxisOffset, axisSpacing: axisSpacing, stretchIndex: stretchIndex)
     }
+}
 
-    // MARK: - Axis flexing
+// MARK: - Axis flexing
 
-    /**
-     Returns the sublayouts sorted by flexibility ascending.
-     */
-    fileprivate func sublayoutsByAxisFlexibilityAscending() -> [(offset: Int, element: Layout)] {
-        return sublayouts.enumerated().sorted(by: layoutsFlexibilityAscending)
-    }
+/**
+ The order in which the sublayouts of a stack are measured.
+ Sublayouts are measured from least to most flexible along the axis so that the most flexible ones are the first to be dropped
+ if there isn't enough space. Sublayouts that are equally flexible are measured in order.
+ */
+private enum StackLayoutMeasurementOrder: Sequence {
 
-    /**
-     Returns the index of the most flexible sublayout.
-     It returns nil if there are no flexible sublayouts.
-     */
-    private func stretchableSublayoutIndex() -> Int? {
-        guard let (index, sublayout) = sublayouts.enumerated().max(by: layoutsFlexibilityAscending) else {
-            return nil
-        }
-        if sublayout.flexibility.flex(axis) == nil {
-            // The most flexible sublayout is still not flexible, so don't stretch it.
-            return nil
+    /// None or all but the last sublayout are inflexible, so the sublayouts are measured in order.
+    case inOrder(count: Int)
+
+    /// Only the sublayout at `flexibleIndex` is flexible, so it is measured after all of the others.
+    case flexibleLast(count: Int, flexibleIndex: Int)
+
+    /// The sublayouts are measured in the order of the sorted indexes.
+    case sorted([Int])
+
+    struct Iterator: IteratorProtocol {
+        let order: StackLayoutMeasurementOrder
+        var position = 0
+
+        mutating func next() -> Int? {
+            defer {
+                position += 1
+            }
+            switch order {
+            case .inOrder(let count):
+                return position < count ? position : nil
+            case .flexibleLast(let count, let flexibleIndex):
+                if position >= count {
+                    return nil
+                }
+                if position == count - 1 {
+                    return flexibleIndex
+                }
+                return position < flexibleIndex ? position : position + 1
+            case .sorted(let indexes):
+                return position < indexes.count ? indexes[position] : nil
+            }
         }
-        return index
     }
 
-    /**
-     Returns true iff the left layout is less flexible than the right layout.
-     If two sublayouts have the same flexibility, then sublayout with the higher index is considered more flexible.
-     Inflexible layouts are sorted before all flexible layouts.
-     */
-    private func layoutsFlexibilityAscending(left: (offset: Int, element: Layout), right: (offset: Int, element: Layout)) -> Bool {
-        let leftFlex = left.element.flexibility.flex(axis)
-        let rightFlex = right.element.flexibility.flex(axis)
-        if leftFlex == rightFlex {
-            return left.offset < right.offset
-        }
-        // nil is less than all integers
-        return leftFlex ?? .min < rightFlex ?? .min
+    func makeIterator() -> Iterator {
+        return Iterator(order: self, position: 0)
     }
+}
 
-    /**
-     Inherit the maximum flexibility of sublayouts along the axis and minimum flexibility of sublayouts across the axis.
-     */
-    fileprivate static func defaultFlexibility(axis: Axis, sublayouts: [Layout]) -> Flexibility {
-        let initial = AxisFlexibility(axis: axis, axisFlex: nil, crossFlex: .max)
-        return sublayouts.reduce(initial) { (flexibility: AxisFlexibility, sublayout: Layout) -> AxisFlexibility in
+/**
+ The properties of a stack that depend on the flexibility of its sublayouts.
+ Sublayouts are immutable, so these are computed once when the stack is created instead of on every measurement and arrangement.
+ */
+private struct StackLayoutFlexing {
+
+    let measurementOrder: StackLayoutMeasurementOrder
+
+    /// The index of the most flexible sublayout, which is stretched by `.fillFlexing`, or nil if no sublayout is flexible.
+    let stretchIndex: Int?
+
+    /// The maximum flexibility of the sublayouts along the axis and minimum flexibility of the sublayouts across the axis.
+    let defaultFlexibility: Flexibility
+
+    init(axis: Axis, sublayouts: [Layout]) {
+        var axisFlex: Flexibility.Flex = nil
+        var crossFlex: Flexibility.Flex = .max
+        var flexibleCount = 0
+        var lastFlexibleIndex: Int? = nil
+        for (index, sublayout) in sublayouts.enumerated() {
             let subflex = AxisFlexibility(axis: axis, flexibility: sublayout.flexibility)
-            let axisFlex = Flexibility.max(flexibility.axisFlex, subflex.axisFlex)
-            let crossFlex = Flexibility.min(flexibility.crossFlex, subflex.crossFlex)
-            return AxisFlexibility(axis: axis, axisFlex: axisFlex, crossFlex: crossFlex)
-        }.flexibility
+            axisFlex = Flexibility.max(axisFlex, subflex.axisFlex)
+            crossFlex = Flexibility.min(crossFlex, subflex.crossFlex)
+            if subflex.axisFlex != nil {
+                flexibleCount += 1
+                lastFlexibleIndex = index
+            }
+        }
+        defaultFlexibility = AxisFlexibility(axis: axis, axisFlex: axisFlex, crossFlex: crossFlex).flexibility
+
+        switch (flexibleCount, lastFlexibleIndex) {
+        case (0, _):
+            // The common case of a stack of inflexible sublayouts doesn't need to be sorted.
+            measurementOrder = .inOrder(count: sublayouts.count)
+            stretchIndex = nil
+        case (1, let flexibleIndex?) where flexibleIndex == sublayouts.count - 1:
+            measurementOrder = .inOrder(count: sublayouts.count)
+            stretchIndex = flexibleIndex
+        case (1, let flexibleIndex?):
+            measurementOrder = .flexibleLast(count: sublayouts.count, flexibleIndex: flexibleIndex)
+            stretchIndex = flexibleIndex
+        default:
+            // Inflexible layouts are sorted before all flexible layouts.
+            // If two sublayouts have the same flexibility, then the sublayout with the higher index is considered more flexible.
+            let flexes = sublayouts.map { $0.flexibility.flex(axis) }
+            let indexes = sublayouts.indices.sorted { (left: Int, right: Int) -> Bool in
+                if flexes[left] == flexes[right] {
+                    return left < right
+                }
+                guard let leftFlex = flexes[left] else {
+                    return true
+                }
+                guard let rightFlex = flexes[right] else {
+                    return false
+                }
+                return leftFlex < rightFlex
+            }
+            measurementOrder = .sorted(indexes)
+            stretchIndex = indexes.last
+        }
     }
 }
@@ -0,0 +1,59 @@
+// Copyright 2019 LinkedIn Corp.
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+
+import Foundation
+
+/**
+ Layout for text that is measured by a `TextMeasuring`.
+
+ Unlike `LabelLayout`, it doesn't depend on UIKit to measure text, so it can be laid out anywhere the measurer can run.
+ The view that displays the text is created and configured like any other `BaseLayout` view.
+ */
+open class TextLayout<Measurer: TextMeasuring, V: View>: BaseLayout<V>, ConfigurableLayout {
+
+    public let text: String
+    public let font: Measurer.Font
+    public let measurer: Measurer
+
+    public init(text: String,
+                font: Measurer.Font,
+                measurer: Measurer,
+                alignment: Alignment = .topLeading,
+                flexibility: Flexibility = .flexible,
+                viewReuseId: String? = nil,
+                config: ((V) -> Void)? = nil) {
+
+        self.text = text
+        self.font = font
+        self.measurer = measurer
+        super.init(alignment: alignment, flexibility: flexibility, viewReuseId: viewReuseId, config: config)
+    }
+
+    // MARK: - Layout protocol
+
+    open func measurement(within maxSize: CGSize) -> LayoutMeasurement {
+        let size: CGSize
+        if text.isEmpty {
+            size = .zero
+        } else {
+            let textSize = measurer.size(of: text, font: font, within: maxSize)
+            size = CGSize(width: textSize.width.roundedUpToFractionalPoint, height: textSize.height.roundedUpToFractionalPoint)
+        }
+        return LayoutMeasurement(layout: self, size: size.decreasedToSize(maxSize), maxSize: maxSize, sublayouts: [])
+    }
+
+    open func arrangement(within rect: CGRect, measurement: LayoutMeasurement) -> LayoutArrangement {
+        let frame = alignment.position(size: measurement.size, in: rect)
+        return LayoutArrangement(layout: self, frame: frame, sublayouts: [])
+    }
+
+    /// Layouts with the same text, font and measurer have the same measurement, so they can share cached measurements.
+    open override var measurementCacheKey: AnyHashable? {
+        return LeafMeasurementCacheKey(layout: self, values: [text, font, measurer])
+    }
+}
@@ -168,6 +168,19 @@ open class TextViewLayout<TextView: UITextView>: BaseLayout<TextView>, Configura
         return LayoutArrangement(layout: self, frame: frame, sublayouts: [])
     }
 
+    /// Text views with the same text and text attributes have the same measurement, so they can share cached measurements.
+    open override var measurementCacheKey: AnyHashable? {
+        return LeafMeasurementCacheKey(layout: self, values: [
+            text.measurementCacheKey,
+            font,
+            lineFragmentPadding,
+            textContainerInset.top,
+            textContainerInset.left,
+            textContainerInset.bottom,
+            textContainerInset.right
+        ])
+    }
+
     // MARK: - private helpers
 
     private func textSize(within maxSize: CGSize) -> CGSize {
@@ -0,0 +1,285 @@
+// Copyright 2019 LinkedIn Corp.
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+
+import Foundation
+
+/**
+ A layout that stacks a large number of items along an axis, in rows of `columnCount` items,
+ without measuring or arranging the items that aren't visible.
+
+ Unlike `StackLayout`, the layout doesn't hold its items. `itemLayout` is asked for the layout of an item when the item is arranged,
+ and the measurement and arrangement of the list itself only depend on the item sizes, so they have no sublayouts.
+ Arrange the items in a rect with `itemFrames(in:size:)` and `arrangement(ofItem:in:)`,
+ or show the list in a `VirtualListView`, which does that as it scrolls.
+
+ Rows of `.estimated` size are measured the first time that they are in the rect passed to `itemFrames(in:size:)`,
+ which moves the rows after them. The measured lengths are kept until the list is measured with a different cross length,
+ so create a new list when the items change.
+
+ Unlike other layouts, whose measurement only depends on the size that they are measured within,
+ the measurement of a list changes as its rows are measured, so it is never cached and a measurement goes stale
+ when items are arranged. Measure the list again after calling `itemFrames(in:size:)`, as `VirtualListView` does,
+ rather than keeping the arrangement of an enclosing layout. Item frames only depend on the cross length of `size`.
+
+ Finding the frame of an item or the items in a rect is O(1) for `.uniform` sizes and O(log n) for `.estimated` sizes.
+ */
+open class VirtualListLayout: BaseLayout<View>, ConfigurableLayout {
+
+    /// The length of the items along the axis.
+    public enum ItemSize {
+
+        /// Every item has this length, so items are never measured.
+        case uniform(CGFloat)
+
+        /// Items are measured when they are first arranged. Until then, their rows are assumed to have this length.
+        case estimated(CGFloat)
+    }
+
+    /// An item and its frame in the coordinate space of the list.
+    public struct Item {
+        public let index: Int
+        public let frame: CGRect
+    }
+
+    /// The axis along which rows are stacked.
+    public let axis: Axis
+
+    /// The number of items.
+    public let itemCount: Int
+
+    /// The length of the items along the axis.
+    public let itemSize: ItemSize
+
+    /// The number of items in each row. The cross length of the list is divided equally between them.
+    public let columnCount: Int
+
+    /// The distance in points between adjacent rows.
+    public let spacing: CGFloat
+
+    /// The distance in points between adjacent items in a row.
+    public let interitemSpacing: CGFloat
+
+    /// Returns the layout of the item at an index. It is called on the thread that arranges the item, every time it is arranged.
+    public let itemLayout: (Int) -> Layout
+
+    private let lock = NSLock()
+
+    /// The offsets of the rows. Guarded by `lock`.
+    private var rowOffsets: OffsetIndex
+
+    /// Whether each row of `.estimated` size has been measured, which is empty until a row is measured. Guarded by `lock`.
+    private var measuredRows = [Bool]()
+
+    /// The cross length that the rows in `measuredRows` were measured at. Guarded by `lock`.
+    private var measuredCrossLength: CGFloat?
+
+    public init(axis: Axis = .vertical,
+                itemCount: Int,
+                itemSize: ItemSize,
+                columnCount: Int = 1,
+                spacing: CGFloat = 0,
+                interitemSpacing: CGFloat = 0,
+                alignment: Alignment = .fill,
+                flexibility: Flexibility = .flexible,
+                viewReuseId: String? = nil,
+                config: ((View) -> Void)? = nil,
+                itemLayout: @escaping (Int) -> Layout) {
+
+        self.axis = axis
+        self.itemCount = max(itemCount, 0)
+        self.itemSize = itemSize
+        self.columnCount = max(columnCount, 1)
+        self.spacing = spacing
+        self.interitemSpacing = interitemSpacing
+        self.itemLayout = itemLayout
+        self.rowOffsets = VirtualListLayout.initialRowOffsets(itemCount: itemCount, columnCount: self.columnCount, itemSize: itemSize, spacing: spacing)
+        super.init(alignment: alignment, flexibility: flexibility, viewReuseId: viewReuseId, config: config)
+    }
+
+    /// The measurement of the list changes as rows are measured, so it is never cached.
+    open override var measurementCacheKey: AnyHashable? {
+        return nil
+    }
+
+    // MARK: - Layout interface
+
+    /**
+     The cross length of the list is the cross length of `maxSize`, or zero if it is unbounded.
+     The axis length is the total length of the rows, using the estimated length of the rows that haven't been measured.
+     */
+    open func measurement(within maxSize: CGSize) -> LayoutMeasurement {
+        let maxAxisSize = AxisSize(axis: axis, size: maxSize)
+        let crossLength = maxAxisSize.crossLength.isFinite && maxAxisSize.crossLength < .greatestFiniteMagnitude ? maxAxisSize.crossLength : 0
+        lock.lock()
+        invalidateMeasuredRows(ifCrossLengthChangedTo: crossLength)
+        let totalLength = rowOffsets.totalLength
+        lock.unlock()
+        let size = AxisSize(axis: axis, axisLength: min(totalLength, maxAxisSize.axisLength), crossLength: crossLength)
+        return LayoutMeasurement(layout: self, size: size.size, maxSize: maxSize, sublayouts: [])
+    }
+
+    open func arrangement(within rect: CGRect, measurement: LayoutMeasurement) -> LayoutArrangement {
+        let frame = alignment.position(size: measurement.size, in: rect)
+        return LayoutArrangement(layout: self, frame: frame, sublayouts: [])
+    }
+
+    // MARK: - Items
+
+    /// The frame of an item in a list of `size`, without measuring any rows.
+    public func frame(ofItem index: Int, size: CGSize) -> CGRect {
+        lock.lock()
+        defer {
+            lock.unlock()
+        }
+        return frame(ofItem: index, crossLength: AxisSize(axis: axis, size: size).crossLength)
+    }
+
+    /// The indexes of the items in rows that intersect `rect`, in the coordinate space of a list of `size`, without measuring any rows.
+    public func itemIndexes(in rect: CGRect, size: CGSize) -> Range<Int> {
+        lock.lock()
+        defer {
+            lock.unlock()
+        }
+        invalidateMeasuredRows(ifCrossLengthChangedTo: AxisSize(axis: axis, size: size).crossLength)
+        return itemIndexes(inRows: rows(in: rect))
+    }
+
+    /**
+     Measures the rows of `.estimated` size that intersect `rect` and returns the items in the rows that intersect it afterwards.
+     `rect` is in the coordinate space of a list of `size`.
+     */
+    public func itemFrames(in rect: CGRect, size: CGSize) -> [Item] {
+        let crossLength = AxisSize(axis: axis, size: size).crossLength
+        lock.lock()
+        invalidateMeasuredRows(ifCrossLengthChangedTo: crossLength)
+        var rows = self.rows(in: rect)
+        if case .estimated = itemSize {
+            // Measuring rows moves the rows after them, so repeat until every row in the rect has been measured.
+            var unmeasuredRows = self.unmeasuredRows(in: rows)
+            while !unmeasuredRows.isEmpty {
+                lock.unlock()
+                let lengths = unmeasuredRows.map { rowLength(ofRow: $0, crossLength: crossLength) }
+                lock.lock()
+                guard measuredCrossLength == crossLength else {
+                    // The list was measured at another cross length in the meantime.
+                    break
+                }
+                if measuredRows.isEmpty {
+                    measuredRows = Array(repeating: false, count: rowOffsets.count)
+                }
+                for (row, length) in zip(unmeasuredRows, lengths) {
+                    rowOffsets.setLength(length, at: row)
+                    measuredRows[row] = true
+                }
+                rows = self.rows(in: rect)
+                unmeasuredRows = self.unmeasuredRows(in: rows)
+            }
+        }
+        let items = itemIndexes(inRows: rows).map { index in
+            return Item(index: index, frame: frame(ofItem: index, crossLength: crossLength))
+        }
+        lock.unlock()
+        return items
+    }
+
+    /**
+     Arranges the item at `index` within `frame`, which is usually the frame returned by `itemFrames(in:size:)`.
+     The arrangement is relative to the origin of `frame`.
+     */
+    public func arrangement(ofItem index: Int, in frame: CGRect) -> LayoutArrangement {
+        let frameSize = AxisSize(axis: axis, size: frame.size)
+        let maxSize = itemMaxSize(crossLength: frameSize.crossLength, axisLength: frameSize.axisLength)
+        let measurement = itemLayout(index).cachedMeasurement(within: maxSize)
+        return measurement.arrangement(within: CGRect(origin: .zero, size: frame.size))
+    }
+
+    // MARK: - Rows
+
+    private static func initialRowOffsets(itemCount: Int, columnCount: Int, itemSize: ItemSize, spacing: CGFloat) -> OffsetIndex {
+        let rowCount = (max(itemCount, 0) + columnCount - 1) / columnCount
+        switch itemSize {
+        case .uniform(let length), .estimated(let length):
+            return OffsetIndex(count: rowCount, length: length, spacing: spacing)
+        }
+    }
+
+    /// Forgets the measured rows if they were measured at another cross length. MUST be called with `lock` held.
+    private func invalidateMeasuredRows(ifCrossLengthChangedTo crossLength: CGFloat) {
+        guard measuredCrossLength != crossLength else {
+            return
+        }
+        if !measuredRows.isEmpty {
+            rowOffsets = VirtualListLayout.initialRowOffsets(itemCount: itemCount, columnCount: columnCount, itemSize: itemSize, spacing: spacing)
+            measuredRows = []
+        }
+        measuredCrossLength = crossLength
+    }
+
+    /// The rows that intersect `rect` along the axis. MUST be called with `lock` held.
+    private func rows(in rect: CGRect) -> ClosedRange<Int>? {
+        let minOffset = AxisPoint(axis: axis, point: rect.origin).axisOffset
+        let maxOffset = minOffset + AxisSize(axis: axis, size: rect.size).axisLength
+        guard rowOffsets.count > 0 && !rect.isNull && maxOffset > 0 && minOffset < rowOffsets.totalLength else {
+            return nil
+        }
+        return rowOffsets.index(at: minOffset)...rowOffsets.index(at: maxOffset)
+    }
+
+    /// The rows in `rows` that haven't been measured. MUST be called with `lock` held.
+    private func unmeasuredRows(in rows: ClosedRange<Int>?) -> [Int] {
+        guard let rows = rows else {
+            return []
+        }
+        return rows.filter { measuredRows.isEmpty || !measuredRows[$0] }
+    }
+
+    private func itemIndexes(inRows rows: ClosedRange<Int>?) -> Range<Int> {
+        guard let rows = rows else {
+            return 0..<0
+        }
+        return (rows.lowerBound * columnCount)..<min((rows.upperBound + 1) * columnCount, itemCount)
+    }
+
+    /// The frame of an item. MUST be called with `lock` held.
+    private func frame(ofItem index: Int, crossLength: CGFloat) -> CGRect {
+        let row = index / columnCount
+        let column = index % columnCount
+        let itemCrossLength = self.itemCrossLength(crossLength: crossLength)
+        let origin = AxisPoint(axis: axis,
+                               axisOffset: rowOffsets.offset(at: row),
+                               crossOffset: CGFloat(column) * (itemCrossLength + interitemSpacing))
+        let size = AxisSize(axis: axis, axisLength: rowOffsets.length(at: row), crossLength: itemCrossLength)
+        return CGRect(origin: origin.point, size: size.size)
+    }
+
+    private func itemCrossLength(crossLength: CGFloat) -> CGFloat {
+        let spacing = interitemSpacing * CGFloat(columnCount - 1)
+        return max((crossLength - spacing) / CGFloat(columnCount), 0)
+    }
+
+    /// The size that an item is measured within. Items of `.estimated` size are unbounded along the axis.
+    private func itemMaxSize(crossLength: CGFloat, axisLength: CGFloat) -> CGSize {
+        switch itemSize {
+        case .uniform:
+            return AxisSize(axis: axis, axisLength: axisLength, crossLength: crossLength).size
+        case .estimated:
+            return AxisSize(axis: axis, axisLength: .greatestFiniteMagnitude, crossLength: crossLength).size
+        }
+    }
+
+    /// Measures the items in a row and returns the axis length of the longest one.
+    private func rowLength(ofRow row: Int, crossLength: CGFloat) -> CGFloat {
+        let maxSize = itemMaxSize(crossLength: itemCrossLength(crossLength: crossLength), axisLength: .greatestFiniteMagnitude)
+        var length: CGFloat = 0
+        for index in (row * columnCount)..<min((row + 1) * columnCount, itemCount) {
+            let size = itemLayout(index).cachedMeasurement(within: maxSize).size
+            length = max(length, AxisSize(axis: axis, size: size).axisLength)
+        }
+        return length
+    }
+}
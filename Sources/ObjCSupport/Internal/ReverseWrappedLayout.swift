@@ -14,8 +14,9 @@ class ReverseWrappedLayout: Layout {
     }
 
     func measurement(within maxSize: CGSize) -> LayoutMeasurement {
-        let measurement: LOKLayoutMeasurement = layout.measurement(within: maxSize)
-        return LayoutMeasurement(layout: self, size: measurement.size, maxSize: measurement.maxSize, sublayouts: measurement.sublayouts.map { $0.measurement })
+        // The sublayouts are read from the Swift measurement so that they don't need to be wrapped.
+        let measurement = layout.measurement(within: maxSize).measurement
+        return LayoutMeasurement(layout: self, size: measurement.size, maxSize: measurement.maxSize, sublayouts: measurement.sublayouts)
     }
 
     var needsView: Bool {
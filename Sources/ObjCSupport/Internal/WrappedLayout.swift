@@ -13,11 +13,11 @@ class WrappedLayout: LOKLayout {
         let a = layout.arrangement(
             within: rect,
             measurement: measurement.measurement)
-        return LOKLayoutArrangement(layoutArrangement: a)
+        return LOKLayoutArrangement(layoutArrangement: a, layout: self)
     }
 
     func measurement(within maxSize: CGSize) -> LOKLayoutMeasurement {
-        return LOKLayoutMeasurement(layoutMeasurement: layout.measurement(within: maxSize))
+        return LOKLayoutMeasurement(wrappedLayout: self, layoutMeasurement: layout.measurement(within: maxSize))
     }
 
     var needsView: Bool {
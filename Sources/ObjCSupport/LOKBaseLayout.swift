@@ -56,7 +56,7 @@ open class LOKBaseLayout: NSObject, LOKLayout {
         // in both the common and derived classes.
         let arrangementWithUpdatedLayout = LayoutArrangement(layout: unwrapped, frame: arrangement.frame, sublayouts: arrangement.sublayouts)
 
-        return LOKLayoutArrangement(layoutArrangement: arrangementWithUpdatedLayout)
+        return LOKLayoutArrangement(layoutArrangement: arrangementWithUpdatedLayout, layout: self)
     }
 
     /**
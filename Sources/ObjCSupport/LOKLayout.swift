@@ -115,40 +115,9 @@ extension LOKLayout {
          so that the methods of the class are called. We do this to make sure that if
          someone were to subclass one of the LayoutKit provided layouts, we would want
          to call their overriden methods instead of just the underlying layout object directly.
-
-         Certain platforms don't have certain layouts, so we make a different array for each platform
-         with only the layouts that it supports.
          */
-        let allLayoutClasses: [AnyClass]
-        #if os(OSX)
-            allLayoutClasses = [
-                LOKInsetLayout.self,
-                LOKOverlayLayout.self,
-                LOKSizeLayout.self,
-                LOKStackLayout.self
-            ]
-        #elseif os(tvOS)
-            allLayoutClasses = [
-                LOKInsetLayout.self,
-                LOKOverlayLayout.self,
-                LOKTextViewLayout.self,
-                LOKButtonLayout.self,
-                LOKSizeLayout.self,
-                LOKStackLayout.self
-            ]
-        #else
-            allLayoutClasses = [
-                LOKInsetLayout.self,
-                LOKOverlayLayout.self,
-                LOKTextViewLayout.self,
-                LOKButtonLayout.self,
-                LOKLabelLayout.self,
-                LOKSizeLayout.self,
-                LOKStackLayout.self
-            ]
-        #endif
         if let object = self as? NSObject {
-            if allLayoutClasses.contains(where: { object.isMember(of: $0) }) {
+            if providedLayoutClasses.contains(where: { object.isMember(of: $0) }) {
                 // Executes if `self` is one of the LayoutKit provided classes; not if it's a subclass
                 guard let layout = (self as? LOKBaseLayout)?.layout else {
                     assertionFailure("LayoutKit provided layout does not inherit from LOKBaseLayout")
@@ -160,3 +129,39 @@ extension LOKLayout {
         return (self as? WrappedLayout)?.layout ?? ReverseWrappedLayout(layout: self)
     }
 }
+
+/**
+ The layouts that LayoutKit provides, which `unwrapped` checks on every call, so the array is only made once.
+
+ Certain platforms don't have certain layouts, so we make a different array for each platform
+ with only the layouts that it supports.
+ */
+private let providedLayoutClasses: [AnyClass] = {
+    #if os(OSX)
+        return [
+            LOKInsetLayout.self,
+            LOKOverlayLayout.self,
+            LOKSizeLayout.self,
+            LOKStackLayout.self
+        ]
+    #elseif os(tvOS)
+        return [
+            LOKInsetLayout.self,
+            LOKOverlayLayout.self,
+            LOKTextViewLayout.self,
+            LOKButtonLayout.self,
+            LOKSizeLayout.self,
+            LOKStackLayout.self
+        ]
+    #else
+        return [
+            LOKInsetLayout.self,
+            LOKOverlayLayout.self,
+            LOKTextViewLayout.self,
+            LOKButtonLayout.self,
+            LOKLabelLayout.self,
+            LOKSizeLayout.self,
+            LOKStackLayout.self
+        ]
+    #endif
+}()
@@ -7,25 +7,55 @@
 // WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 
 import CoreGraphics
+import Foundation
 
 /**
  The frame of a layout and the frames of its sublayouts.
  */
 @objc open class LOKLayoutArrangement: NSObject {
     let layoutArrangement: LayoutArrangement
-    @objc public let layout: LOKLayout
-    @objc public let sublayouts: [LOKLayoutArrangement]
 
-    init(layoutArrangement: LayoutArrangement) {
+    /// The wrappers of the layout and of the sublayout arrangements, which are made the first time that they are accessed.
+    private var wrappedLayout: LOKLayout?
+    private var wrappedSublayouts: [LOKLayoutArrangement]?
+
+    @objc public var layout: LOKLayout {
+        materializationLock.lock()
+        defer { materializationLock.unlock() }
+        if let wrappedLayout = wrappedLayout {
+            return wrappedLayout
+        }
+        let layout = WrappedLayout.wrap(layout: layoutArrangement.layout)
+        wrappedLayout = layout
+        return layout
+    }
+
+    @objc public var sublayouts: [LOKLayoutArrangement] {
+        materializationLock.lock()
+        defer { materializationLock.unlock() }
+        if let wrappedSublayouts = wrappedSublayouts {
+            return wrappedSublayouts
+        }
+        let sublayouts = layoutArrangement.sublayouts.map { LOKLayoutArrangement(layoutArrangement: $0) }
+        wrappedSublayouts = sublayouts
+        return sublayouts
+    }
+
+    /**
+     Wraps a Swift arrangement without wrapping its sublayouts.
+     Only the nodes of the tree that Objective-C code visits are wrapped, so passing an arrangement through the bridge doesn't allocate per node.
+
+     - parameter layout: The Objective-C layout that was arranged, if the caller has it. Otherwise it is wrapped when it is accessed.
+     */
+    init(layoutArrangement: LayoutArrangement, layout: LOKLayout? = nil) {
         self.layoutArrangement = layoutArrangement
-        self.layout = WrappedLayout.wrap(layout: layoutArrangement.layout)
-        self.sublayouts = layoutArrangement.sublayouts.map { LOKLayoutArrangement(layoutArrangement: $0) }
+        self.wrappedLayout = layout
     }
 
     @objc public init(layout: LOKLayout, frame: CGRect, sublayouts: [LOKLayoutArrangement]) {
         self.layoutArrangement = LayoutArrangement(layout: layout.unwrapped, frame: frame, sublayouts: sublayouts.map { $0.layoutArrangement })
-        self.layout = layout
-        self.sublayouts = sublayouts
+        self.wrappedLayout = layout
+        self.wrappedSublayouts = sublayouts
     }
 
     @objc public class func arrangeLayout(_ layout: LOKLayout, width: CGFloat, height: CGFloat) -> LOKLayoutArrangement {
@@ -136,3 +166,9 @@ import CoreGraphics
     }
 }
 
+/**
+ Guards the wrappers that arrangements and measurements make lazily, since they may be accessed on any thread.
+ Wrapping only happens the first time that a node is visited, so one lock for all of them is not contended.
+ */
+let materializationLock = NSLock()
+
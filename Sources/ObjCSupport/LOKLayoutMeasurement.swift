@@ -7,14 +7,25 @@
 // WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 
 import CoreGraphics
+import Foundation
 
 @objc open class LOKLayoutMeasurement: NSObject {
     let measurement: LayoutMeasurement
-    private let wrappedLayout: LOKLayout
+
+    /// The wrappers of the layout and of the sublayout measurements, which are made the first time that they are accessed.
+    private var wrappedLayout: LOKLayout?
+    private var wrappedSublayouts: [LOKLayoutMeasurement]?
 
     /// The layout that was measured.
     @objc public var layout: LOKLayout {
-        return wrappedLayout
+        materializationLock.lock()
+        defer { materializationLock.unlock() }
+        if let wrappedLayout = wrappedLayout {
+            return wrappedLayout
+        }
+        let layout = WrappedLayout.wrap(layout: measurement.layout)
+        wrappedLayout = layout
+        return layout
     }
 
     /// The minimum size of the layout given the maximum size constraint.
@@ -29,16 +40,24 @@ import CoreGraphics
 
     /// The measurements of the layout's sublayouts.
     @objc public var sublayouts: [LOKLayoutMeasurement] {
-        return measurement.sublayouts.map { LOKLayoutMeasurement(layoutMeasurement: $0) }
+        materializationLock.lock()
+        defer { materializationLock.unlock() }
+        if let wrappedSublayouts = wrappedSublayouts {
+            return wrappedSublayouts
+        }
+        let sublayouts = measurement.sublayouts.map { LOKLayoutMeasurement(layoutMeasurement: $0) }
+        wrappedSublayouts = sublayouts
+        return sublayouts
     }
 
     @objc public init(layout: LOKLayout, size: CGSize, maxSize: CGSize, sublayouts: [LOKLayoutMeasurement]) {
         wrappedLayout = layout
+        wrappedSublayouts = sublayouts
         measurement = LayoutMeasurement(layout: layout.unwrapped, size: size, maxSize: maxSize, sublayouts: sublayouts.map { $0.measurement })
     }
 
+    /// Wraps a Swift measurement without wrapping its layout or its sublayouts until they are accessed.
     init(layoutMeasurement: LayoutMeasurement) {
-        wrappedLayout = WrappedLayout.wrap(layout: layoutMeasurement.layout)
         measurement = layoutMeasurement
     }
 
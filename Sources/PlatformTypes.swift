@@ -0,0 +1,75 @@
+// Copyright 2019 LinkedIn Corp.
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+
+// The platform types that layouts are declared in terms of.
+
+#if os(iOS) || os(tvOS)
+
+import UIKit
+
+public typealias View = UIView
+
+public typealias EdgeInsets = UIEdgeInsets
+
+public typealias UserInterfaceLayoutDirection = UIUserInterfaceLayoutDirection
+
+#elseif os(macOS)
+
+import AppKit
+
+public typealias View = NSView
+
+public typealias EdgeInsets = NSEdgeInsets
+
+public typealias UserInterfaceLayoutDirection = NSUserInterfaceLayoutDirection
+
+#else
+
+import Foundation
+
+/**
+ A stand-in for the view class on platforms that don't have UIKit or AppKit (e.g. Linux).
+
+ Layouts can be measured and arranged without views, so this lets the layout engine run headless,
+ for example to precompute arrangements on a server. Views are never created from it.
+ */
+open class View {
+
+    public var frame: CGRect
+
+    public required init() {
+        self.frame = .zero
+    }
+
+    public init(frame: CGRect) {
+        self.frame = frame
+    }
+}
+
+/// The same as `UIEdgeInsets`.
+public struct EdgeInsets: Equatable {
+    public var top: CGFloat
+    public var left: CGFloat
+    public var bottom: CGFloat
+    public var right: CGFloat
+
+    public init(top: CGFloat, left: CGFloat, bottom: CGFloat, right: CGFloat) {
+        self.top = top
+        self.left = left
+        self.bottom = bottom
+        self.right = right
+    }
+}
+
+/// The same as `UIUserInterfaceLayoutDirection`.
+public enum UserInterfaceLayoutDirection: Int {
+    case leftToRight
+    case rightToLeft
+}
+
+#endif
@@ -17,6 +17,45 @@ public enum Text {
     func textSize(within maxSize: CGSize,
                   font: UIFont,
                   lineBreakMode: NSLineBreakMode = .byTruncatingTail) -> CGSize {
+        if isEmpty {
+            return .zero
+        }
+        return TextMeasurementCache.shared.size(of: self, within: maxSize, font: font, lineBreakMode: lineBreakMode, measure: {
+            return uncachedTextSize(within: maxSize, font: font, lineBreakMode: lineBreakMode)
+        })
+    }
+
+    /// Calculate the text size within `maxSize` with the backend. `numberOfLines` is only applied by `.textKit`.
+    func textSize(within maxSize: CGSize,
+                  font: UIFont,
+                  lineBreakMode: NSLineBreakMode,
+                  numberOfLines: Int,
+                  backend: TextMeasurementBackend) -> CGSize {
+        switch backend {
+        case .boundingRect:
+            return textSize(within: maxSize, font: font, lineBreakMode: lineBreakMode)
+        case .textKit:
+            if isEmpty {
+                return .zero
+            }
+            return TextMeasurementCache.shared.size(of: self, within: maxSize, font: font, lineBreakMode: lineBreakMode,
+                                                    numberOfLines: numberOfLines, backend: backend, measure: {
+                return TextKitMeasurer.current.metrics(of: self, font: font, lineBreakMode: lineBreakMode, numberOfLines: numberOfLines, within: maxSize).size
+            })
+        }
+    }
+
+    private var isEmpty: Bool {
+        switch self {
+        case .attributed(let attributedText):
+            return attributedText.length == 0
+        case .unattributed(let text):
+            return text.isEmpty
+        }
+    }
+
+    /// Measures the text with `boundingRect`, without `TextMeasurementCache`.
+    func uncachedTextSize(within maxSize: CGSize, font: UIFont, lineBreakMode: NSLineBreakMode) -> CGSize {
         let options: NSStringDrawingOptions = [
             .usesLineFragmentOrigin
         ]
@@ -41,10 +80,6 @@ public enum Text {
         let size: CGSize
         switch self {
         case .attributed(let attributedText):
-            if attributedText.length == 0 {
-                return .zero
-            }
-
             // UILabel/UITextView uses a default font and lineBreakMode if one is not specified in the attributed string.
             // boundingRect(with:options:attributes:) does not appear to have the same logic,
             // so we need to ensure that our attributed string has a default font and lineBreakMode.
@@ -54,9 +89,6 @@ public enum Text {
 
             size = newAttributedString.boundingRect(with: maxSize, options: options, context: nil).size
         case .unattributed(let text):
-            if text.isEmpty {
-                return .zero
-            }
             size = text.boundingRect(with: maxSize, options: options, attributes: attributes, context: nil).size
         }
         // boundingRect(with:options:attributes:) returns size to a precision of hundredths of a point,
@@ -64,3 +96,32 @@ public enum Text {
         return CGSize(width: size.width.roundedUpToFractionalPoint, height: size.height.roundedUpToFractionalPoint)
     }
 }
+
+extension Text {
+
+    /// A hashable representation of the text for measurement cache keys.
+    var measurementCacheKey: AnyHashable {
+        switch self {
+        case .unattributed(let text):
+            return AnyHashable(text)
+        case .attributed(let attributedText):
+            // The key must not change if the caller mutates its string after the measurement, so it holds an immutable copy.
+            // Copying an immutable attributed string returns the same instance.
+            return AnyHashable(attributedText.copy() as! NSAttributedString)
+        }
+    }
+}
+
+/// Measures text with UIKit, the same way that `LabelLayout` does.
+public struct UIKitTextMeasurer: TextMeasuring {
+
+    public let lineBreakMode: NSLineBreakMode
+
+    public init(lineBreakMode: NSLineBreakMode = .byTruncatingTail) {
+        self.lineBreakMode = lineBreakMode
+    }
+
+    public func size(of text: String, font: UIFont, within maxSize: CGSize) -> CGSize {
+        return Text.unattributed(text).textSize(within: maxSize, font: font, lineBreakMode: lineBreakMode)
+    }
+}
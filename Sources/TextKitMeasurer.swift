@@ -0,0 +1,158 @@
+// Copyright 2019 LinkedIn Corp.
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+
+import UIKit
+
+/// How text is measured by layouts that support more than one way (e.g. `LabelLayout`).
+public enum TextMeasurementBackend {
+
+    /**
+     `boundingRect(with:options:attributes:context:)` on the string.
+     It doesn't know about a number of lines, so `LabelLayout` clamps the height to its number of lines times its line height.
+     */
+    case boundingRect
+
+    /**
+     A TextKit stack from `TextKitMeasurer.current`, which lays out at most the number of lines
+     and truncates the last one the same way that a label does, so the size of a label with a number of lines is exact.
+     */
+    case textKit
+}
+
+/// The size of laid out text and the number of lines it was laid out in.
+public struct TextMetrics: Equatable {
+
+    public let size: CGSize
+    public let lineCount: Int
+
+    public init(size: CGSize, lineCount: Int) {
+        self.size = size
+        self.lineCount = lineCount
+    }
+}
+
+/// A string to measure with `TextKitMeasurer.metrics(of:)`.
+public struct TextMeasurementRequest {
+
+    public let text: Text
+    public let font: UIFont
+    public let lineBreakMode: NSLineBreakMode
+
+    /// The maximum number of lines, or 0 for no maximum.
+    public let numberOfLines: Int
+
+    public let maxSize: CGSize
+
+    public init(text: Text,
+                font: UIFont,
+                lineBreakMode: NSLineBreakMode = .byTruncatingTail,
+                numberOfLines: Int = 0,
+                maxSize: CGSize) {
+
+        self.text = text
+        self.font = font
+        self.lineBreakMode = lineBreakMode
+        self.numberOfLines = numberOfLines
+        self.maxSize = maxSize
+    }
+}
+
+/**
+ Measures text with a reusable TextKit stack (`NSTextStorage`, `NSLayoutManager` and `NSTextContainer`).
+
+ Creating a TextKit stack is much more expensive than laying out a short string in one,
+ so each thread has its own measurer whose stack is reused for every measurement on that thread.
+ A measurer MUST only be used on the thread that it belongs to; get it with `TextKitMeasurer.current`.
+
+ Measurements are not cached. `LabelLayout` caches them in `TextMeasurementCache` when its backend is `.textKit`.
+ */
+public final class TextKitMeasurer {
+
+    private let textStorage = NSTextStorage()
+    private let layoutManager = NSLayoutManager()
+    private let textContainer = NSTextContainer(size: .zero)
+
+    init() {
+        // Labels don't pad their lines.
+        textContainer.lineFragmentPadding = 0
+        layoutManager.addTextContainer(textContainer)
+        textStorage.addLayoutManager(layoutManager)
+    }
+
+    /**
+     Lays out the text within the size and returns the size that it uses, rounded up to the display scale, and its number of lines.
+
+     - parameter numberOfLines: The maximum number of lines, or 0 for no maximum. The last line is truncated according to `lineBreakMode`.
+     */
+    public func metrics(of text: Text,
+                        font: UIFont,
+                        lineBreakMode: NSLineBreakMode = .byTruncatingTail,
+                        numberOfLines: Int = 0,
+                        within maxSize: CGSize) -> TextMetrics {
+
+        let attributedText = text.attributedText(font: font)
+        if attributedText.length == 0 {
+            return TextMetrics(size: .zero, lineCount: 0)
+        }
+        textContainer.size = maxSize
+        textContainer.maximumNumberOfLines = numberOfLines
+        textContainer.lineBreakMode = lineBreakMode
+        // The storage keeps the text until the next measurement on this thread, which is cheaper than emptying it every time.
+        textStorage.setAttributedString(attributedText)
+
+        // Asking for the glyph range of the container lays out the text.
+        let glyphRange = layoutManager.glyphRange(for: textContainer)
+        var lineCount = 0
+        layoutManager.enumerateLineFragments(forGlyphRange: glyphRange) { _, _, _, _, _ in
+            lineCount += 1
+        }
+        let usedSize = layoutManager.usedRect(for: textContainer).size
+        let size = CGSize(width: usedSize.width.roundedUpToFractionalPoint, height: usedSize.height.roundedUpToFractionalPoint)
+        return TextMetrics(size: size, lineCount: lineCount)
+    }
+
+    /// Measures the requests one after another in this measurer's stack and returns their metrics in the same order.
+    public func metrics(of requests: [TextMeasurementRequest]) -> [TextMetrics] {
+        var metrics = [TextMetrics]()
+        metrics.reserveCapacity(requests.count)
+        for request in requests {
+            metrics.append(self.metrics(of: request.text,
+                                        font: request.font,
+                                        lineBreakMode: request.lineBreakMode,
+                                        numberOfLines: request.numberOfLines,
+                                        within: request.maxSize))
+        }
+        return metrics
+    }
+}
+
+// MARK: - Per-thread measurer
+
+extension TextKitMeasurer {
+
+    /// The slot that holds the measurer of each thread. It retains the measurer until the thread exits.
+    private static let currentSlot = ThreadLocal<TextKitMeasurer>(retainsValues: true)
+
+    /// The measurer of the current thread. It is created the first time that it is used on each thread.
+    public static var current: TextKitMeasurer {
+        return currentSlot.value(orMake: { TextKitMeasurer() })
+    }
+}
+
+private extension Text {
+
+    /// The text with the font applied wherever the text doesn't have its own, like a label does.
+    func attributedText(font: UIFont) -> NSAttributedString {
+        switch self {
+        case .unattributed(let text):
+            return NSAttributedString(string: text, attributes: [NSAttributedString.Key.font: font])
+        case .attributed(let attributedText):
+            return attributedText.with(font: font)
+        }
+    }
+}
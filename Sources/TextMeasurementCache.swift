@@ -0,0 +1,181 @@
+// Copyright 2019 LinkedIn Corp.
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+
+import UIKit
+
+/**
+ A thread-safe cache of text sizes computed by `Text.textSize(within:font:lineBreakMode:)`.
+
+ Sizes are keyed by the text, the font, the line break mode, the measurement backend and number of lines, and the size that the text was measured within.
+ The cache is split into shards that each have their own lock so that concurrent layout threads rarely contend.
+ Each shard evicts its least recently used sizes when it exceeds its share of `totalCostLimit`.
+
+ The shared cache is emptied automatically when the preferred content size category (Dynamic Type) changes
+ and when the application receives a memory warning.
+ */
+public final class TextMeasurementCache {
+
+    /// The cache used by `LabelLayout`, `TextViewLayout` and `ButtonLayout`.
+    public static let shared = TextMeasurementCache()
+
+    /// The approximate number of bytes that the cache may hold before it starts evicting.
+    public let totalCostLimit: Int
+
+    private let shards: [Shard]
+
+    private var observers = [NSObjectProtocol]()
+
+    public init(totalCostLimit: Int = 2 * 1024 * 1024, shardCount: Int = 16) {
+        precondition(shardCount > 0, "shardCount must be positive")
+        self.totalCostLimit = totalCostLimit
+        let shardCostLimit = max(1, totalCostLimit / shardCount)
+        self.shards = (0..<shardCount).map { _ in Shard(costLimit: shardCostLimit) }
+
+        let invalidate: (Notification) -> Void = { [weak self] _ in
+            self?.removeAll()
+        }
+        let center = NotificationCenter.default
+        observers.append(center.addObserver(forName: UIContentSizeCategory.didChangeNotification, object: nil, queue: nil, using: invalidate))
+        observers.append(center.addObserver(forName: UIApplication.didReceiveMemoryWarningNotification, object: nil, queue: nil, using: invalidate))
+    }
+
+    deinit {
+        for observer in observers {
+            NotificationCenter.default.removeObserver(observer)
+        }
+    }
+
+    /// The number of sizes that were served from the cache.
+    public var hitCount: Int {
+        return shards.reduce(0) { $0 + $1.counters.hits }
+    }
+
+    /// The number of sizes that were computed because they were not in the cache.
+    public var missCount: Int {
+        return shards.reduce(0) { $0 + $1.counters.misses }
+    }
+
+    /// The number of sizes that were evicted to stay within `totalCostLimit`.
+    public var evictionCount: Int {
+        return shards.reduce(0) { $0 + $1.counters.evictions }
+    }
+
+    /// The approximate number of bytes currently held by the cache.
+    public var totalCost: Int {
+        return shards.reduce(0) { $0 + $1.counters.totalCost }
+    }
+
+    /**
+     Removes all sizes from the cache.
+
+     Call this if text metrics change in a way that the cache can't observe (e.g. a custom font is reloaded).
+     */
+    public func removeAll() {
+        for shard in shards {
+            shard.removeAll()
+        }
+    }
+
+    /**
+     Returns the cached size for the text, or computes and caches it with `measure`.
+     Sizes measured with different backends or numbers of lines are cached separately.
+     */
+    func size(of text: Text,
+              within maxSize: CGSize,
+              font: UIFont,
+              lineBreakMode: NSLineBreakMode,
+              numberOfLines: Int = 0,
+              backend: TextMeasurementBackend = .boundingRect,
+              measure: () -> CGSize) -> CGSize {
+
+        let key = Key(text: text.measurementCacheKey, font: font, lineBreakMode: lineBreakMode.rawValue,
+                      numberOfLines: numberOfLines, backend: backend, width: maxSize.width, height: maxSize.height)
+        let shard = shards[Int(UInt(bitPattern: key.hashValue) % UInt(shards.count))]
+        if let size = shard.size(forKey: key) {
+            return size
+        }
+        // Measure outside of the lock so that other threads using this shard are not blocked.
+        let size = measure()
+        shard.setSize(size, forKey: key, cost: text.approximateCacheCost)
+        return size
+    }
+
+    private struct Key: Hashable {
+        let text: AnyHashable
+        let font: UIFont
+        let lineBreakMode: Int
+        let numberOfLines: Int
+        let backend: TextMeasurementBackend
+        let width: CGFloat
+        let height: CGFloat
+    }
+
+    private struct Counters {
+        var hits = 0
+        var misses = 0
+        var evictions = 0
+        var totalCost = 0
+    }
+
+    private final class Shard {
+        private let lock = NSLock()
+        private var sizes: LRUCache<Key, CGSize>
+        private var _counters = Counters()
+
+        init(costLimit: Int) {
+            sizes = LRUCache(costLimit: costLimit)
+        }
+
+        var counters: Counters {
+            lock.lock()
+            defer { lock.unlock() }
+            var counters = _counters
+            counters.totalCost = sizes.totalCost
+            return counters
+        }
+
+        func size(forKey key: Key) -> CGSize? {
+            lock.lock()
+            defer { lock.unlock() }
+            guard let size = sizes.value(forKey: key) else {
+                _counters.misses += 1
+                return nil
+            }
+            _counters.hits += 1
+            return size
+        }
+
+        func setSize(_ size: CGSize, forKey key: Key, cost: Int) {
+            lock.lock()
+            defer { lock.unlock() }
+            _counters.evictions += sizes.setValue(size, forKey: key, cost: cost)
+        }
+
+        func removeAll() {
+            lock.lock()
+            defer { lock.unlock() }
+            sizes.removeAll()
+        }
+    }
+}
+
+private extension Text {
+
+    /// The approximate number of bytes that caching a size for this text retains.
+    var approximateCacheCost: Int {
+        // Key, entry and dictionary bucket overhead.
+        let overhead = 128
+        switch self {
+        case .unattributed(let text):
+            return overhead + text.utf16.count * 2
+        case .attributed(let attributedText):
+            // Attributed strings are retained, not copied, but they keep their attributes alive too.
+            return overhead + attributedText.length * 4
+        }
+    }
+}
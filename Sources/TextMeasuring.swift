@@ -0,0 +1,32 @@
+// Copyright 2019 LinkedIn Corp.
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+
+import Foundation
+
+/**
+ Measures text for `TextLayout`.
+
+ `UIKitTextMeasurer` measures text the same way as `LabelLayout`.
+ Where UIKit is not available (e.g. on a server that precomputes arrangements),
+ provide a measurer that is backed by another text engine or by font metrics.
+
+ Measurers are part of the measurement cache key of a `TextLayout`,
+ so equal measurers MUST measure text the same way.
+ They MUST be thread-safe because layouts are measured on background threads.
+ */
+public protocol TextMeasuring: Hashable {
+
+    /// The description of the font that text is measured in.
+    associatedtype Font: Hashable
+
+    /**
+     Returns the size of the text in the font, wrapped to the width of `maxSize`.
+     `TextLayout` rounds the size up to the display scale and clips it to `maxSize`.
+     */
+    func size(of text: String, font: Font, within maxSize: CGSize) -> CGSize
+}
@@ -8,12 +8,6 @@
 
 import UIKit
 
-public typealias View = UIView
-
-public typealias EdgeInsets = UIEdgeInsets
-
-public typealias UserInterfaceLayoutDirection = UIUserInterfaceLayoutDirection
-
 extension UIView {
 
     func convertToAbsoluteCoordinates(_ rect: CGRect) -> CGRect {
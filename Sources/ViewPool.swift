@@ -0,0 +1,137 @@
+// Copyright 2019 LinkedIn Corp.
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+
+import Foundation
+#if os(iOS) || os(tvOS)
+import UIKit
+#endif
+
+/**
+ A bounded pool of views that `makeViews` removed from one view hierarchy, so that they can be reused in another one.
+
+ `makeViews` only recycles views that are already in the view it is given.
+ When a cell is reused for an item with a different layout, the views that the new layout doesn't need are removed
+ and the views that it does need are created. With a pool, the removed views are parked in the pool
+ and later `makeViews` calls (e.g. for other cells) take views of the same class and `viewReuseId` from it instead of creating them.
+
+ Pooling is disabled by default. Enable it by setting the shared pool:
+
+ ```
+ ViewPool.shared = ViewPool(capacity: 200)
+ ```
+
+ Only views of layouts that have a `viewReuseId` and report a `reusableViewClass` are pooled (see `BaseLayout.reusableViewClass`).
+ Views without a `viewReuseId` may have been configured for any layout, so they are not handed to other layouts.
+ Parked views have their transform and anchor point reset, like views that are recycled within a hierarchy.
+ On iOS and tvOS, the pool is emptied when the application receives a memory warning.
+
+ MUST only be used on the main thread.
+ */
+public final class ViewPool {
+
+    /// The pool used by `makeViews`, or nil to disable pooling.
+    public static var shared: ViewPool?
+
+    /// The maximum number of views that the pool holds. Views that are purged while the pool is full are released.
+    public let capacity: Int
+
+    /// The number of views that were taken from the pool instead of being created.
+    public private(set) var reuseCount = 0
+
+    /// The number of poolable views that were created because the pool didn't have one.
+    public private(set) var createCount = 0
+
+    /// The number of views that were parked in the pool after they were removed from a view hierarchy.
+    public private(set) var purgeCount = 0
+
+    /// The number of views that were released instead of parked because the pool was full.
+    public private(set) var discardCount = 0
+
+    /// The number of views in the pool.
+    public private(set) var count = 0
+
+    private struct Key: Hashable {
+        let viewClass: ObjectIdentifier
+        let viewReuseId: String
+    }
+
+    private var viewsByKey = [Key: [View]]()
+
+    private var observer: NSObjectProtocol?
+
+    public init(capacity: Int = 100) {
+        precondition(capacity >= 0, "capacity must not be negative")
+        self.capacity = capacity
+        #if os(iOS) || os(tvOS)
+        observer = NotificationCenter.default.addObserver(forName: UIApplication.didReceiveMemoryWarningNotification, object: nil, queue: nil) { [weak self] _ in
+            self?.removeAll()
+        }
+        #endif
+    }
+
+    deinit {
+        if let observer = observer {
+            NotificationCenter.default.removeObserver(observer)
+        }
+    }
+
+    /// Releases all views in the pool.
+    public func removeAll() {
+        viewsByKey.removeAll()
+        count = 0
+    }
+
+    /// Resets the reuse, create, purge and discard counts to zero.
+    public func resetCounters() {
+        reuseCount = 0
+        createCount = 0
+        purgeCount = 0
+        discardCount = 0
+    }
+
+    /// Returns a parked view whose class is exactly `viewClass` and that was made for a layout with the same `viewReuseId`.
+    func dequeueView(ofClass viewClass: View.Type, viewReuseId: String) -> View? {
+        let key = Key(viewClass: ObjectIdentifier(viewClass), viewReuseId: viewReuseId)
+        guard let view = viewsByKey[key]?.popLast() else {
+            return nil
+        }
+        count -= 1
+        reuseCount += 1
+        return view
+    }
+
+    /// Counts a view that was created because `dequeueView(ofClass:viewReuseId:)` returned nil.
+    func recordCreatedView() {
+        createCount += 1
+    }
+
+    /// Parks a view that was removed from its superview.
+    func enqueue(_ view: View) {
+        guard view.isPoolable, let viewReuseId = view.viewReuseId else {
+            return
+        }
+        guard count < capacity else {
+            discardCount += 1
+            return
+        }
+        view.resetForReuse()
+        let key = Key(viewClass: ObjectIdentifier(type(of: view)), viewReuseId: viewReuseId)
+        viewsByKey[key, default: []].append(view)
+        count += 1
+        purgeCount += 1
+    }
+}
+
+/// A layout whose views can be pooled.
+protocol ViewPoolReusableLayout {
+
+    /// The class of the views that the layout makes, or nil if they can't be reused by other layouts.
+    var reusableViewClass: View.Type? { get }
+}
+
+extension BaseLayout: ViewPoolReusableLayout {}
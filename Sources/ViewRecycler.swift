@@ -19,18 +19,20 @@ import UIKit
  Call `makeView(layoutId:)` to recycle or create a view of the desired type and id.
  Call `purgeViews()` to remove all unrecycled views from the view hierarchy.
  Call `markViewsAsRoot(views:)` to mark the top level views of generated view hierarchy
+ Call `addPrewarmedViews(in:)` to use views that were made ahead of time for the same layouts.
  */
 class ViewRecycler {
 
     private var viewsById = [String: View]()
     private var unidentifiedViews = Set<View>()
-    #if os(iOS) || os(tvOS)
-    private let defaultLayerAnchorPoint = CGPoint(x: 0.5, y: 0.5)
-    private let defaultTransform = CGAffineTransform.identity
-    #endif
+    private var prewarmedViewsByLayout = [ObjectIdentifier: View]()
+    private var unusedPrewarmedViews = [View]()
+    private let pool: ViewPool?
 
     /// Retains all subviews of rootView for recycling.
-    init(rootView: View?) {
+    /// Views that are purged are parked in `pool`, and views that can't be recycled from rootView are taken from it.
+    init(rootView: View?, pool: ViewPool? = ViewPool.shared) {
+        self.pool = pool
         guard let rootView = rootView else {
             return
         }
@@ -50,45 +52,59 @@ class ViewRecycler {
         }
     }
 
+    /**
+     Adds the views that were made in `view` ahead of time (e.g. while the main run loop was idle),
+     so that layouts take the view that was made for them instead of creating one.
+     The views of the root view are still recycled first. Prewarmed views that are not taken are purged.
+     */
+    func addPrewarmedViews(in view: View) {
+        for subview in view.subviews where subview.type == .root {
+            subview.type = .managed
+        }
+        view.walkNonRootSubviews { (prewarmedView) in
+            // Only layout objects can be matched with the view that was made for them.
+            if let layout = prewarmedView.configuringLayout, self.prewarmedViewsByLayout[ObjectIdentifier(layout)] == nil {
+                self.prewarmedViewsByLayout[ObjectIdentifier(layout)] = prewarmedView
+            } else {
+                self.unusedPrewarmedViews.append(prewarmedView)
+            }
+        }
+    }
+
     /**
      Returns a view for the layout.
      It may recycle an existing view or create a new view.
+     If `layout` is provided, the view may be one that was prewarmed for it.
+     If `viewClass` and `viewReuseId` are provided, the view may also be taken from the pool.
      */
-    func makeOrRecycleView(havingViewReuseId viewReuseId: String?, viewProvider: () -> View) -> View? {
+    func makeOrRecycleView(havingViewReuseId viewReuseId: String?, viewClass: View.Type? = nil, layout: Layout? = nil, viewProvider: () -> View) -> View? {
         // If we have a recyclable view that matches type and id, then reuse it.
         if let viewReuseId = viewReuseId, let view = viewsById[viewReuseId] {
             viewsById[viewReuseId] = nil
+            view.resetForReuse()
+            return view
+        }
 
-            #if os(iOS) || os(tvOS)
-            // Reset affine transformation and layer anchor point to their default values.
-            // Without this there will be an issue when their current value is not the default.
-            // Take affine transformation for example, the issue goes like this.
-            // 1. View has a non-identity transform.
-            // 2. View gets retrieved from the viewsById map.
-            // 3. View's frame gets set under the assumption that its transform is identity.
-            // 4. View's transform gets set to a value.
-            // 5. View's frame gets changed automatically when its transform gets set. As a result, view's frame will not match its transform.
-            // Example:
-            // 1. View has a scale transform of (0.001, 0.001).
-            // 2. View gets reused so its transform is still (0.001, 0.001).
-            // 3. View's frame gets set to (0, 0, 100, 100) which is its original size.
-            // 4. View's transform gets set to identity in a config block.
-            // 5. One would expect view's frame to be (0, 0, 100, 100) since its transform is now identity. But actually its frame will be
-            //    (-49950, -49950, 100000, 100000) because its scale has just gone up 1000-fold, i.e. from 0.001 to 1.
-            if view.layer.anchorPoint != defaultLayerAnchorPoint {
-                view.layer.anchorPoint = defaultLayerAnchorPoint
-            }
+        // Otherwise, take the view that was prewarmed for the layout.
+        if let layout = layout, type(of: layout) is AnyClass,
+            let view = prewarmedViewsByLayout.removeValue(forKey: ObjectIdentifier(layout as AnyObject)) {
+            view.viewReuseId = viewReuseId
+            return view
+        }
 
-            if view.transform != defaultTransform {
-                view.transform = defaultTransform
+        // Otherwise, take a view that another hierarchy no longer needs.
+        if let pool = pool, let viewClass = viewClass, let viewReuseId = viewReuseId {
+            if let view = pool.dequeueView(ofClass: viewClass, viewReuseId: viewReuseId) {
+                view.type = .managed
+                view.viewReuseId = viewReuseId
+                return view
             }
-            #endif
-
-            return view
+            pool.recordCreatedView()
         }
 
         let providedView = viewProvider()
         providedView.type = .managed
+        providedView.isPoolable = viewClass != nil && viewReuseId != nil
 
         // Remove the provided view from the list of cached views.
         if let viewReuseId = providedView.viewReuseId, let oldView = viewsById[viewReuseId], oldView == providedView {
@@ -104,13 +120,32 @@ class ViewRecycler {
     func purgeViews() {
         for view in viewsById.values {
             view.removeFromSuperview()
+            pool?.enqueue(view)
         }
         viewsById.removeAll()
 
         for view in unidentifiedViews where view.type == .managed {
             view.removeFromSuperview()
+            pool?.enqueue(view)
         }
         unidentifiedViews.removeAll()
+
+        for view in prewarmedViewsByLayout.values {
+            view.removeFromSuperview()
+            pool?.enqueue(view)
+        }
+        prewarmedViewsByLayout.removeAll()
+        for view in unusedPrewarmedViews {
+            view.removeFromSuperview()
+            pool?.enqueue(view)
+        }
+        unusedPrewarmedViews.removeAll()
+    }
+
+    /// Returns a view for `layout`. See `makeOrRecycleView(havingViewReuseId:viewClass:layout:viewProvider:)`.
+    func makeOrRecycleView(for layout: Layout) -> View? {
+        let viewClass = (layout as? ViewPoolReusableLayout)?.reusableViewClass
+        return makeOrRecycleView(havingViewReuseId: layout.viewReuseId, viewClass: viewClass, layout: layout, viewProvider: layout.makeView)
     }
 
     func markViewsAsRoot(_ views: [View]) {
@@ -120,6 +155,18 @@ class ViewRecycler {
 
 private var viewReuseIdKey: UInt8 = 0
 private var typeKey: UInt8 = 0
+private var configuringLayoutKey: UInt8 = 0
+private var isPoolableKey: UInt8 = 0
+
+/// Holds the layout that configured a view weakly, so that a new layout at the same address can't be mistaken for it.
+/// A view keeps its reference once it has one, and only the layout in it changes.
+private final class ConfiguringLayoutReference {
+    weak var layout: AnyObject?
+
+    init(_ layout: AnyObject) {
+        self.layout = layout
+    }
+}
 
 extension View {
 
@@ -133,6 +180,41 @@ extension View {
         case root
     }
 
+    /**
+     Resets the affine transformation and layer anchor point of a view that is about to be reused to their default values.
+
+     Without this there will be an issue when their current value is not the default.
+     Take affine transformation for example, the issue goes like this.
+     1. View has a non-identity transform.
+     2. View gets retrieved from the viewsById map.
+     3. View's frame gets set under the assumption that its transform is identity.
+     4. View's transform gets set to a value.
+     5. View's frame gets changed automatically when its transform gets set. As a result, view's frame will not match its transform.
+
+     Example:
+     1. View has a scale transform of (0.001, 0.001).
+     2. View gets reused so its transform is still (0.001, 0.001).
+     3. View's frame gets set to (0, 0, 100, 100) which is its original size.
+     4. View's transform gets set to identity in a config block.
+     5. One would expect view's frame to be (0, 0, 100, 100) since its transform is now identity. But actually its frame will be
+        (-49950, -49950, 100000, 100000) because its scale has just gone up 1000-fold, i.e. from 0.001 to 1.
+     */
+    func resetForReuse() {
+        #if os(iOS) || os(tvOS)
+        let defaultLayerAnchorPoint = CGPoint(x: 0.5, y: 0.5)
+        if layer.anchorPoint != defaultLayerAnchorPoint {
+            layer.anchorPoint = defaultLayerAnchorPoint
+            // The configuration may have set the anchor point, so it needs to run again.
+            configuringLayout = nil
+        }
+
+        if transform != .identity {
+            transform = .identity
+            configuringLayout = nil
+        }
+        #endif
+    }
+
     /// Calls visitor for each transitive subview.
     func walkNonRootSubviews(visitor: (View) -> Void) {
         for subview in subviews where subview.type != .root {
@@ -151,6 +233,56 @@ extension View {
         }
     }
 
+    /// Whether the view was made by a layout that allows it to be reused by other layouts (see `ViewPool`).
+    var isPoolable: Bool {
+        get {
+            return objc_getAssociatedObject(self, &isPoolableKey) as? Bool ?? false
+        }
+        set {
+            objc_setAssociatedObject(self, &isPoolableKey, newValue ? true : nil, .OBJC_ASSOCIATION_RETAIN_NONATOMIC)
+        }
+    }
+
+    /// The layout object that last configured this view, if it still exists.
+    var configuringLayout: AnyObject? {
+        get {
+            return (objc_getAssociatedObject(self, &configuringLayoutKey) as? ConfiguringLayoutReference)?.layout
+        }
+        set {
+            // The reference is reused, so configuring a view doesn't allocate once it has one.
+            if let reference = objc_getAssociatedObject(self, &configuringLayoutKey) as? ConfiguringLayoutReference {
+                reference.layout = newValue
+            } else if let newValue = newValue {
+                objc_setAssociatedObject(self, &configuringLayoutKey, ConfiguringLayoutReference(newValue), .OBJC_ASSOCIATION_RETAIN_NONATOMIC)
+            }
+        }
+    }
+
+    /**
+     Sets the frame of the view and configures it with `layout`.
+
+     If the layout's `configuresViewsOnce` is true and the view was last configured by the same layout object,
+     it isn't configured again. This avoids reapplying configurations (e.g. setting the text of a label, which invalidates its text layout)
+     when an arrangement is applied to the same views again, e.g. when a cell is displayed again or an animation is applied.
+     The frame is only set if it changed.
+     */
+    func apply(_ layout: Layout, frame: CGRect) {
+        if self.frame != frame {
+            self.frame = frame
+        }
+        // Layouts that are value types have no identity, so they are always configured.
+        guard type(of: layout) is AnyClass else {
+            layout.configure(baseTypeView: self)
+            return
+        }
+        let layoutObject = layout as AnyObject
+        if !layout.configuresViewsOnce || configuringLayout !== layoutObject {
+            layout.configure(baseTypeView: self)
+        }
+        // The prewarmer matches views with the layout that configured them, whether or not it skips configurations.
+        configuringLayout = layoutObject
+    }
+
     var type: ViewType {
         get {
             return objc_getAssociatedObject(self, &typeKey) as? ViewType ?? .unmanaged
@@ -9,13 +9,16 @@
 import UIKit
 
 /**
- A UITableView that retains and uses a ReloadableViewLayoutAdapter as its delegate and data source.
+ A UITableView that retains and uses a ReloadableViewLayoutAdapter as its delegate, data source and prefetch data source.
  */
 open class LayoutAdapterTableView: UITableView {
     open lazy var layoutAdapter: ReloadableViewLayoutAdapter = {
         let adapter = ReloadableViewLayoutAdapter(reloadableView: self)
         self.dataSource = adapter
         self.delegate = adapter
+        if #available(iOS 10.0, tvOS 10.0, *) {
+            self.prefetchDataSource = adapter
+        }
         return adapter
     }()
 }
@@ -0,0 +1,376 @@
+// Copyright 2019 LinkedIn Corp.
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+
+import Foundation
+
+/// Receives the metrics of the reloads of a `ReloadableViewLayoutAdapter`.
+public protocol ReloadableViewLayoutAdapterMetricsDelegate: class {
+
+    /**
+     Called on the main thread once for every reload, after it completed or after it was cancelled by another reload.
+     Completed reloads are reported after their completion closure is called.
+     */
+    func layoutAdapter(_ layoutAdapter: ReloadableViewLayoutAdapter, didFinishReloadWith metrics: ReloadMetrics)
+}
+
+/// Where the time of one reload went.
+public struct ReloadMetrics {
+
+    public enum Outcome {
+        /// The reload applied its final arrangement.
+        case completed
+
+        /// The reload was cancelled by a later reload before it applied its final arrangement.
+        case cancelled
+    }
+
+    public let outcome: Outcome
+
+    /// Whether the reload was synchronous. Synchronous reloads do all of their work on the main thread.
+    public let isSynchronous: Bool
+
+    /// The time between the reload call and the start of the layout provider, which includes waiting on `backgroundLayoutQueue`.
+    public let queueWaitDuration: TimeInterval
+
+    /// The time that the layout provider took. Zero if the reload was cancelled before it was called.
+    public let layoutProviderDuration: TimeInterval
+
+    /// The time that each layout (item, header or footer) took to be arranged, in the order that the arrangements completed.
+    public let layoutDurations: [TimeInterval]
+
+    /// The total time of the blocks that updated the reloadable view on the main thread.
+    public let mainThreadUpdateDuration: TimeInterval
+
+    /// The number of blocks that updated the reloadable view on the main thread.
+    public let mainThreadUpdateCount: Int
+
+    /// The number of incremental updates that were skipped because the reloadable view was tracking or decelerating.
+    public let deferredUpdateCount: Int
+
+    /// The number of unfinished reloads that this reload cancelled.
+    public let cancelledReloadCount: Int
+
+    /// The time between the reload call and its completion or cancellation.
+    public let totalDuration: TimeInterval
+}
+
+/**
+ Collects the metrics of one reload.
+
+ Layout durations are recorded on background threads (concurrently if items are laid out concurrently),
+ so all state is guarded by a lock.
+ */
+final class ReloadMetricsCollector {
+
+    private enum State {
+        case running
+        case completed(end: CFAbsoluteTime)
+        case cancelled(end: CFAbsoluteTime)
+    }
+
+    private let lock = NSLock()
+    private let start = CFAbsoluteTimeGetCurrent()
+    private let isSynchronous: Bool
+    private let cancelledReloadCount: Int
+    private var state = State.running
+    private var queueWaitDuration: TimeInterval = 0
+    private var layoutProviderDuration: TimeInterval = 0
+    private var layoutDurations = [TimeInterval]()
+    private var mainThreadUpdateDuration: TimeInterval = 0
+    private var mainThreadUpdateCount = 0
+    private var deferredUpdateCount = 0
+
+    init(isSynchronous: Bool, cancelledReloadCount: Int) {
+        self.isSynchronous = isSynchronous
+        self.cancelledReloadCount = cancelledReloadCount
+    }
+
+    /// Calls the layout provider of the reload and records how long it waited and took.
+    func measureLayoutProvider<T>(_ layoutProvider: () -> T) -> T {
+        let providerStart = CFAbsoluteTimeGetCurrent()
+        let result = layoutProvider()
+        let providerEnd = CFAbsoluteTimeGetCurrent()
+        lock.lock()
+        defer { lock.unlock() }
+        queueWaitDuration = providerStart - start
+        layoutProviderDuration = providerEnd - providerStart
+        return result
+    }
+
+    func recordLayout(duration: TimeInterval) {
+        lock.lock()
+        defer { lock.unlock() }
+        layoutDurations.append(duration)
+    }
+
+    func recordMainThreadUpdate(duration: TimeInterval) {
+        lock.lock()
+        defer { lock.unlock() }
+        mainThreadUpdateDuration += duration
+        mainThreadUpdateCount += 1
+    }
+
+    func recordDeferredUpdate() {
+        lock.lock()
+        defer { lock.unlock() }
+        deferredUpdateCount += 1
+    }
+
+    /// Marks the reload as completed. Updates that are still running are included in `metrics`.
+    func complete() {
+        lock.lock()
+        defer { lock.unlock() }
+        if case .running = state {
+            state = .completed(end: CFAbsoluteTimeGetCurrent())
+        }
+    }
+
+    /// Marks the reload as cancelled and returns true, unless it already completed.
+    func cancel() -> Bool {
+        lock.lock()
+        defer { lock.unlock() }
+        guard case .running = state else {
+            return false
+        }
+        state = .cancelled(end: CFAbsoluteTimeGetCurrent())
+        return true
+    }
+
+    /// The metrics of the reload, or nil if it is still running.
+    var metrics: ReloadMetrics? {
+        lock.lock()
+        defer { lock.unlock() }
+        let outcome: ReloadMetrics.Outcome
+        let end: CFAbsoluteTime
+        switch state {
+        case .running:
+            return nil
+        case .completed(let completedEnd):
+            outcome = .completed
+            end = completedEnd
+        case .cancelled(let cancelledEnd):
+            outcome = .cancelled
+            end = cancelledEnd
+        }
+        return ReloadMetrics(
+            outcome: outcome,
+            isSynchronous: isSynchronous,
+            queueWaitDuration: queueWaitDuration,
+            layoutProviderDuration: layoutProviderDuration,
+            layoutDurations: layoutDurations,
+            mainThreadUpdateDuration: mainThreadUpdateDuration,
+            mainThreadUpdateCount: mainThreadUpdateCount,
+            deferredUpdateCount: deferredUpdateCount,
+            cancelledReloadCount: cancelledReloadCount,
+            totalDuration: end - start)
+    }
+}
+
+// MARK: - Aggregation
+
+/**
+ Counts durations in buckets whose upper bounds double from 0.25 ms to 4 s, plus an overflow bucket.
+
+ The bucket counts are small and have the same bounds on every device, so histograms can be uploaded and merged.
+ */
+public struct LatencyHistogram {
+
+    /// The upper bound of each bucket but the last one, in seconds. The last bucket counts all longer durations.
+    public static let upperBounds: [TimeInterval] = (0..<15).map { 0.000_25 * pow(2, Double($0)) }
+
+    /// The number of durations in each bucket. There is one more bucket than there are upper bounds.
+    public private(set) var bucketCounts = [Int](repeating: 0, count: LatencyHistogram.upperBounds.count + 1)
+
+    /// The number of recorded durations.
+    public private(set) var count = 0
+
+    /// The sum of the recorded durations.
+    public private(set) var sum: TimeInterval = 0
+
+    public init() {}
+
+    public mutating func record(_ duration: TimeInterval) {
+        var low = 0
+        var high = LatencyHistogram.upperBounds.count
+        while low < high {
+            let middle = (low + high) / 2
+            if duration <= LatencyHistogram.upperBounds[middle] {
+                high = middle
+            } else {
+                low = middle + 1
+            }
+        }
+        bucketCounts[low] += 1
+        count += 1
+        sum += duration
+    }
+
+    /// Adds the counts of another histogram.
+    public mutating func merge(_ other: LatencyHistogram) {
+        for index in bucketCounts.indices {
+            bucketCounts[index] += other.bucketCounts[index]
+        }
+        count += other.count
+        sum += other.sum
+    }
+
+    /**
+     Returns the upper bound of the bucket that contains the duration at `percentile` (between 0 and 100),
+     or nil if no durations were recorded. Durations in the overflow bucket are reported as infinite.
+     */
+    public func upperBound(atPercentile percentile: Double) -> TimeInterval? {
+        guard count > 0 else {
+            return nil
+        }
+        let rank = max(1, Int((percentile / 100 * Double(count)).rounded(.up)))
+        var cumulativeCount = 0
+        for (index, bucketCount) in bucketCounts.enumerated() {
+            cumulativeCount += bucketCount
+            if cumulativeCount >= rank {
+                return index < LatencyHistogram.upperBounds.count ? LatencyHistogram.upperBounds[index] : .infinity
+            }
+        }
+        return .infinity
+    }
+}
+
+/**
+ Aggregates the metrics of sampled reloads into histograms and counters that can be uploaded periodically.
+
+ ```
+ let aggregator = ReloadMetricsAggregator(sampleRate: 0.1)
+ layoutAdapter.metricsDelegate = aggregator
+ ...
+ upload(aggregator.takeSnapshot())
+ ```
+
+ The aggregator is only retained by the code that created it, since `metricsDelegate` is weak.
+ It MUST only be used on the main thread.
+ */
+public final class ReloadMetricsAggregator: ReloadableViewLayoutAdapterMetricsDelegate {
+
+    /// The metrics of the sampled reloads since the snapshot was last taken.
+    public struct Snapshot {
+        public internal(set) var completedReloadCount = 0
+        public internal(set) var cancelledReloadCount = 0
+        public internal(set) var synchronousReloadCount = 0
+        public internal(set) var deferredUpdateCount = 0
+        public internal(set) var queueWait = LatencyHistogram()
+        public internal(set) var layoutProvider = LatencyHistogram()
+
+        /// The durations of all layouts of all reloads.
+        public internal(set) var layout = LatencyHistogram()
+        public internal(set) var mainThreadUpdate = LatencyHistogram()
+
+        /// The total duration of completed reloads.
+        public internal(set) var completedReload = LatencyHistogram()
+    }
+
+    /// The fraction of reloads that are aggregated, between 0 and 1.
+    public let sampleRate: Double
+
+    /// Returns a random number between 0 and 1 to decide whether a reload is sampled. Tests replace it to sample deterministically.
+    var random: () -> Double = { Double.random(in: 0..<1) }
+
+    public private(set) var snapshot = Snapshot()
+
+    public init(sampleRate: Double = 1) {
+        precondition(sampleRate >= 0 && sampleRate <= 1, "sampleRate must be between 0 and 1")
+        self.sampleRate = sampleRate
+    }
+
+    /// Returns the snapshot and starts a new one.
+    public func takeSnapshot() -> Snapshot {
+        let taken = snapshot
+        snapshot = Snapshot()
+        return taken
+    }
+
+    public func layoutAdapter(_ layoutAdapter: ReloadableViewLayoutAdapter, didFinishReloadWith metrics: ReloadMetrics) {
+        guard sampleRate >= 1 || random() < sampleRate else {
+            return
+        }
+        switch metrics.outcome {
+        case .completed:
+            snapshot.completedReloadCount += 1
+            snapshot.completedReload.record(metrics.totalDuration)
+        case .cancelled:
+            snapshot.cancelledReloadCount += 1
+        }
+        if metrics.isSynchronous {
+            snapshot.synchronousReloadCount += 1
+        } else {
+            snapshot.queueWait.record(metrics.queueWaitDuration)
+        }
+        snapshot.deferredUpdateCount += metrics.deferredUpdateCount
+        snapshot.layoutProvider.record(metrics.layoutProviderDuration)
+        for duration in metrics.layoutDurations {
+            snapshot.layout.record(duration)
+        }
+        if metrics.mainThreadUpdateCount > 0 {
+            snapshot.mainThreadUpdate.record(metrics.mainThreadUpdateDuration)
+        }
+    }
+}
+
+// MARK: - Adapter support
+
+extension ReloadableViewLayoutAdapter {
+
+    /**
+     Starts collecting the metrics of a reload if there is a metrics delegate.
+     The metrics of an unfinished previous reload are reported as cancelled, so this MUST be called before its operations are cancelled.
+     */
+    func beginReloadMetrics(synchronous: Bool) -> ReloadMetricsCollector? {
+        let cancelledReloadCount = cancelActiveReloadMetrics()
+        guard metricsDelegate != nil else {
+            return nil
+        }
+        let metrics = ReloadMetricsCollector(isSynchronous: synchronous, cancelledReloadCount: cancelledReloadCount)
+        activeReloadMetrics = metrics
+        return metrics
+    }
+
+    /// Reports the metrics of the reload in progress as cancelled and returns the number of reloads that were cancelled.
+    @discardableResult
+    func cancelActiveReloadMetrics() -> Int {
+        defer {
+            activeReloadMetrics = nil
+        }
+        guard let active = activeReloadMetrics, active.cancel() else {
+            return 0
+        }
+        report(active)
+        return 1
+    }
+
+    /// Wraps the completion of a reload so that it completes `metrics`.
+    func completion(_ completion: (() -> Void)?, completing metrics: ReloadMetricsCollector?) -> (() -> Void)? {
+        guard let metrics = metrics else {
+            return completion
+        }
+        return { [weak self] in
+            metrics.complete()
+            completion?()
+            // Report once the update block that called the completion has finished, so that its duration is included.
+            DispatchQueue.main.async {
+                if self?.activeReloadMetrics === metrics {
+                    self?.activeReloadMetrics = nil
+                }
+                self?.report(metrics)
+            }
+        }
+    }
+
+    private func report(_ metrics: ReloadMetricsCollector) {
+        guard let reloadMetrics = metrics.metrics else {
+            return
+        }
+        metricsDelegate?.layoutAdapter(self, didFinishReloadWith: reloadMetrics)
+    }
+}
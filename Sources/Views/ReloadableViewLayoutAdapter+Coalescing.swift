@@ -0,0 +1,316 @@
+// Copyright 2019 LinkedIn Corp.
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+
+import UIKit
+
+/// How a reload that was requested with `requestReload` ended.
+public enum CoalescedReloadResult {
+
+    /// The reload was laid out and applied to the reloadable view.
+    case completed
+
+    /// A later request replaced the reload before it started, so it was never laid out.
+    case superseded
+
+    /// The reload was cancelled with `CoalescedReload.cancel()` or by a reload that isn't coalesced.
+    case cancelled
+}
+
+/// Counts of the coalesced reloads of an adapter, which show how much layout work rapid reload requests finish and waste.
+public struct CoalescedReloadStatistics {
+
+    /// The number of calls to `requestReload`.
+    public internal(set) var requestedCount = 0
+
+    /// The number of reloads that were laid out and applied.
+    public internal(set) var completedCount = 0
+
+    /// The number of requests that were dropped before they started because a later request replaced them.
+    public internal(set) var supersededCount = 0
+
+    /// The number of requests that were cancelled, before or after they started.
+    public internal(set) var cancelledCount = 0
+
+    /// The number of layouts that were arranged by reloads that completed.
+    public internal(set) var completedLayoutCount = 0
+
+    /// The number of layouts that were arranged by reloads that were cancelled after they started, whose work was thrown away.
+    public internal(set) var wastedLayoutCount = 0
+}
+
+/**
+ A reload that was requested with `requestReload`.
+ It MUST only be used on the main thread.
+ */
+public final class CoalescedReload {
+
+    /// The adapter cancels the request when it is deallocated, so the request never outlives it unfinished.
+    fileprivate weak var adapter: ReloadableViewLayoutAdapter?
+
+    /// Starts the reload on the adapter, with a completion that finishes this request.
+    fileprivate let start: (ReloadableViewLayoutAdapter, @escaping () -> Void) -> Void
+
+    fileprivate let completion: ((CoalescedReloadResult) -> Void)?
+
+    /// Layouts are counted on the background layout queue, so the count is guarded by a lock.
+    private let lock = NSLock()
+    private var layoutCount = 0
+
+    fileprivate init(adapter: ReloadableViewLayoutAdapter,
+                     start: @escaping (ReloadableViewLayoutAdapter, @escaping () -> Void) -> Void,
+                     completion: ((CoalescedReloadResult) -> Void)?) {
+        self.adapter = adapter
+        self.start = start
+        self.completion = completion
+    }
+
+    /**
+     Cancels the reload. If it is laying out, layout stops at the next item and the reloadable view keeps what was applied so far.
+     Does nothing if the reload already ended.
+     */
+    public func cancel() {
+        assert(Thread.isMainThread, "cancel must be called on the main thread")
+        adapter?.cancelCoalescedReload(self)
+    }
+
+    func recordLayout() {
+        lock.lock()
+        layoutCount += 1
+        lock.unlock()
+    }
+
+    fileprivate var arrangedLayoutCount: Int {
+        lock.lock()
+        defer {
+            lock.unlock()
+        }
+        return layoutCount
+    }
+}
+
+/// The state of the coalesced reloads of an adapter. MUST only be used on the main thread.
+final class ReloadCoalescer {
+
+    /// The latest request, which starts when the coalescing window closes and no reload is in progress.
+    var pending: CoalescedReload?
+
+    /// The request that is being started, whose layouts are counted.
+    var starting: CoalescedReload?
+
+    /// The request that is laying out.
+    var current: CoalescedReload?
+
+    /// Closes the coalescing window. It is nil while no window is open.
+    var flushWorkItem: DispatchWorkItem?
+
+    var statistics = CoalescedReloadStatistics()
+
+    /// Completes the request that is laying out and the request that is waiting with `.cancelled`, and closes the coalescing window.
+    func cancelAll() {
+        flushWorkItem?.cancel()
+        flushWorkItem = nil
+        if let current = current {
+            self.current = nil
+            statistics.cancelledCount += 1
+            statistics.wastedLayoutCount += current.arrangedLayoutCount
+            current.completion?(.cancelled)
+        }
+        if let pending = pending {
+            self.pending = nil
+            statistics.cancelledCount += 1
+            pending.completion?(.cancelled)
+        }
+    }
+}
+
+// MARK: - Coalesced reloads
+
+extension ReloadableViewLayoutAdapter {
+
+    /**
+     Requests an asynchronous reload that is coalesced with the requests that follow it, for sources of rapid updates
+     like typing in a search field.
+
+     The first request opens a window of `reloadCoalescingInterval`. When the window closes, only the latest request is laid out.
+     A request that arrives while a coalesced reload is laying out doesn't cancel it. It waits for that reload to finish
+     and replaces any request that was already waiting, so each reload finishes and at most one request waits (back-pressure).
+     Requests that are replaced complete with `.superseded` without calling their layout provider.
+
+     A reload that isn't coalesced (e.g. `reload(width:height:synchronous:batchUpdates:layoutProvider:completion:)`)
+     cancels the coalesced reload that is laying out and drops the request that is waiting.
+     If the adapter or its reloadable view is deallocated, the requests that didn't end are cancelled.
+     Every request completes exactly once.
+
+     It must be called on the main thread. See `reload(width:height:synchronous:batchUpdates:layoutProvider:completion:)` for the parameters.
+
+     - parameter completion: A closure that is called on the main thread with the result of the request.
+     - returns: The request, which can be cancelled.
+     */
+    @discardableResult
+    open func requestReload<T: Collection, U>(
+        width: CGFloat? = nil,
+        height: CGFloat? = nil,
+        layoutProvider: @escaping () -> T,
+        completion: ((CoalescedReloadResult) -> Void)? = nil) -> CoalescedReload where U.Iterator.Element == Layout, T.Iterator.Element == Section<U> {
+
+        assert(Thread.isMainThread, "requestReload must be called on the main thread")
+
+        let request = CoalescedReload(adapter: self, start: { adapter, completion in
+            adapter.reload(width: width, height: height, synchronous: false, batchUpdates: nil,
+                           showsVisibleItemsFirst: adapter.prioritizesVisibleItems, layoutProvider: layoutProvider, completion: completion)
+        }, completion: completion)
+
+        reloadCoalescer.statistics.requestedCount += 1
+        if let superseded = reloadCoalescer.pending {
+            reloadCoalescer.pending = nil
+            reloadCoalescer.statistics.supersededCount += 1
+            superseded.completion?(.superseded)
+        }
+        reloadCoalescer.pending = request
+
+        if reloadCoalescer.flushWorkItem == nil {
+            let flushWorkItem = DispatchWorkItem { [weak self] in
+                self?.reloadCoalescer.flushWorkItem = nil
+                self?.startPendingReload()
+            }
+            reloadCoalescer.flushWorkItem = flushWorkItem
+            DispatchQueue.main.asyncAfter(deadline: .now() + max(reloadCoalescingInterval, 0), execute: flushWorkItem)
+        }
+        return request
+    }
+
+    /// The counts of the coalesced reloads since the adapter was created or the counts were reset.
+    public var coalescedReloadStatistics: CoalescedReloadStatistics {
+        return reloadCoalescer.statistics
+    }
+
+    /// Resets the counts of `coalescedReloadStatistics` to zero.
+    public func resetCoalescedReloadStatistics() {
+        reloadCoalescer.statistics = CoalescedReloadStatistics()
+    }
+
+    /// Completes the coalesced reloads that didn't end with `.cancelled`, since they can't be applied to the reloadable view.
+    func reloadableViewWasDeallocated() {
+        reloadCoalescer.cancelAll()
+    }
+
+    /// Starts the pending request if the coalescing window is closed and no coalesced reload is laying out.
+    private func startPendingReload() {
+        guard reloadCoalescer.current == nil && reloadCoalescer.flushWorkItem == nil, let request = reloadCoalescer.pending else {
+            return
+        }
+        guard reloadableView != nil else {
+            reloadCoalescer.cancelAll()
+            return
+        }
+        reloadCoalescer.pending = nil
+        reloadCoalescer.starting = request
+        request.start(self, { [weak self, weak request] in
+            guard let request = request else {
+                return
+            }
+            self?.finish(request)
+        })
+        reloadCoalescer.starting = nil
+        reloadCoalescer.current = request
+    }
+
+    private func finish(_ request: CoalescedReload) {
+        guard reloadCoalescer.current === request else {
+            // The request was cancelled while its final arrangement was being applied.
+            return
+        }
+        reloadCoalescer.current = nil
+        reloadCoalescer.statistics.completedCount += 1
+        reloadCoalescer.statistics.completedLayoutCount += request.arrangedLayoutCount
+        request.completion?(.completed)
+        startPendingReload()
+    }
+
+    fileprivate func cancelCoalescedReload(_ request: CoalescedReload) {
+        if reloadCoalescer.pending === request {
+            reloadCoalescer.pending = nil
+            reloadCoalescer.statistics.cancelledCount += 1
+            request.completion?(.cancelled)
+        } else if reloadCoalescer.current === request {
+            cancelActiveReloadMetrics()
+            backgroundLayoutQueue.cancelAllOperations()
+            reloadCoalescer.current = nil
+            reloadCoalescer.statistics.cancelledCount += 1
+            reloadCoalescer.statistics.wastedLayoutCount += request.arrangedLayoutCount
+            request.completion?(.cancelled)
+            startPendingReload()
+        }
+    }
+
+    /**
+     Cancels the coalesced reload that is laying out and drops the request that is waiting,
+     because a reload that isn't coalesced replaces them. It is called by every reload before it cancels the operations in progress.
+     */
+    func interruptCoalescedReloads() {
+        if let current = reloadCoalescer.current {
+            reloadCoalescer.current = nil
+            reloadCoalescer.statistics.cancelledCount += 1
+            reloadCoalescer.statistics.wastedLayoutCount += current.arrangedLayoutCount
+            current.completion?(.cancelled)
+        }
+        if let pending = reloadCoalescer.pending {
+            reloadCoalescer.pending = nil
+            reloadCoalescer.statistics.supersededCount += 1
+            pending.completion?(.superseded)
+        }
+    }
+}
+
+// MARK: - Async/await
+
+#if compiler(>=5.5)
+@available(iOS 13.0, tvOS 13.0, *)
+extension ReloadableViewLayoutAdapter {
+
+    /**
+     Requests a coalesced reload (see `requestReload(width:height:layoutProvider:completion:)`) and returns its result.
+
+     Cancelling the task cancels the reload: if it is waiting it is dropped, and if it is laying out, layout stops at the next item.
+     The task always resumes: a request that is superseded, cancelled or can't be applied because the adapter
+     or its reloadable view was deallocated returns `.superseded` or `.cancelled`.
+     */
+    @MainActor
+    @discardableResult
+    public func reloadCoalesced<T: Collection, U>(
+        width: CGFloat? = nil,
+        height: CGFloat? = nil,
+        layoutProvider: @escaping () -> T) async -> CoalescedReloadResult where U.Iterator.Element == Layout, T.Iterator.Element == Section<U> {
+
+        let cancellation = CoalescedReloadCancellation()
+        let operation = { () async -> CoalescedReloadResult in
+            return await withCheckedContinuation { (continuation: CheckedContinuation<CoalescedReloadResult, Never>) in
+                cancellation.request = self.requestReload(width: width, height: height, layoutProvider: layoutProvider, completion: { result in
+                    continuation.resume(returning: result)
+                })
+            }
+        }
+        // The request is made synchronously on the main thread, so it exists by the time the cancellation reaches the main queue.
+        let onCancel: @Sendable () -> Void = {
+            DispatchQueue.main.async {
+                cancellation.request?.cancel()
+            }
+        }
+        #if compiler(>=5.7)
+        return await withTaskCancellationHandler(operation: operation, onCancel: onCancel)
+        #else
+        return await withTaskCancellationHandler(handler: onCancel, operation: operation)
+        #endif
+    }
+}
+
+/// Passes a request from the task that made it to its cancellation handler.
+private final class CoalescedReloadCancellation {
+    var request: CoalescedReload?
+}
+#endif
@@ -0,0 +1,455 @@
+// Copyright 2019 LinkedIn Corp.
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+
+import UIKit
+
+/// An item of a `reloadDiffing` reload, with an identity that persists across reloads.
+public struct IdentifiedLayout {
+
+    /// Identifies the item across reloads. Ids SHOULD be unique within a section.
+    public let id: AnyHashable
+
+    /// Two versions of an item with the same id and equal contents MUST have equivalent layouts, so the arrangement of the first is reused.
+    public let content: AnyHashable
+
+    /// Makes the layout of the item. It is only called if the item's arrangement can't be reused. It is called on a background thread.
+    public let makeLayout: () -> Layout
+
+    public init(id: AnyHashable, content: AnyHashable, makeLayout: @escaping () -> Layout) {
+        self.id = id
+        self.content = content
+        self.makeLayout = makeLayout
+    }
+}
+
+/// A section of a `reloadDiffing` reload, with an identity that persists across reloads.
+public struct IdentifiedSection {
+
+    /// Identifies the section across reloads. Ids MUST be unique.
+    public let id: AnyHashable
+
+    /// The header of the section. It is compared by content only.
+    public let header: IdentifiedLayout?
+
+    public let items: [IdentifiedLayout]
+
+    /// The footer of the section. It is compared by content only.
+    public let footer: IdentifiedLayout?
+
+    public init(id: AnyHashable, header: IdentifiedLayout? = nil, items: [IdentifiedLayout], footer: IdentifiedLayout? = nil) {
+        self.id = id
+        self.header = header
+        self.items = items
+        self.footer = footer
+    }
+}
+
+// MARK: - Diffing reload
+
+extension ReloadableViewLayoutAdapter {
+
+    /**
+     Reloads the view with identified items and animates the changes since the previous `reloadDiffing`.
+
+     The items are compared with the items of the previous diffing reload by id, and `BatchUpdates` are computed on the
+     background layout queue together with layout, so the main thread only applies the updates.
+     Items whose id and content are unchanged reuse their current arrangement (if the width and height are unchanged
+     and no other reload is in progress) without calling `makeLayout`. Items whose content changed are reloaded.
+
+     If the current arrangement wasn't applied by a diffing reload (e.g. the first time, or after `reload`),
+     all items are laid out and the data is reloaded without animation.
+
+     - parameter width: The width of the layout's arrangement. Nil means no constraint. Default is nil.
+     - parameter height: The height of the layout's arrangement. Nil means no constraint. Default is nil.
+     - parameter synchronous: If true, `reloadDiffing` will not return until the operation is complete. Default is false.
+     - parameter sectionProvider: A closure that produces the sections. It is called on a background thread so it must be threadsafe.
+     - parameter completion: A closure that is called on the main thread when the operation is complete.
+     */
+    open func reloadDiffing(
+        width: CGFloat? = nil,
+        height: CGFloat? = nil,
+        synchronous: Bool = false,
+        sectionProvider: @escaping () -> [IdentifiedSection],
+        completion: (() -> Void)? = nil) {
+
+        assert(Thread.isMainThread, "reloadDiffing must be called on the main thread")
+
+        let metrics = beginReloadMetrics(synchronous: synchronous)
+        interruptCoalescedReloads()
+        // Arrangements are only reused if they were applied for the same size and no other reload is replacing them.
+        let sizeConstraint = ReloadableViewLayoutAdapter.sizeConstraint(width: width, height: height)
+        let canReuseArrangements = currentArrangementSizeConstraint == sizeConstraint && backgroundLayoutQueue.operationCount == 0
+        backgroundLayoutQueue.cancelAllOperations()
+        let previous = currentIdentities.map { identities in
+            return DiffingReloadState(arrangement: currentArrangement, identities: identities, canReuseArrangements: canReuseArrangements)
+        }
+
+        let layoutFunc = self.layoutFunc(width: width, height: height)
+        let layoutItemsConcurrently = self.layoutItemsConcurrently
+        let layOut = { (layouts: [Layout], isCancelled: () -> Bool) -> [LayoutArrangement]? in
+            var arrangements = [LayoutArrangement]()
+            arrangements.reserveCapacity(layouts.count)
+            if layoutItemsConcurrently {
+                let completed = ReloadableViewLayoutAdapter.concurrentArrangements(of: layouts, layoutFunc: layoutFunc, isCancelled: isCancelled, batchCompleted: { batch in
+                    arrangements.append(contentsOf: batch)
+                })
+                return completed ? arrangements : nil
+            }
+            for layout in layouts {
+                if isCancelled() {
+                    return nil
+                }
+                arrangements.append(layoutFunc(layout))
+            }
+            return arrangements
+        }
+
+        let start = CFAbsoluteTimeGetCurrent()
+        let measuredCompletion = self.completion(completion, completing: metrics)
+        let completionAndLogEnd = { [weak self] in
+            let end = CFAbsoluteTimeGetCurrent()
+            self?.logger?("user: \((end-start).ms)")
+            measuredCompletion?()
+        }
+        let measuredSectionProvider = { () -> [IdentifiedSection] in
+            return metrics?.measureLayoutProvider(sectionProvider) ?? sectionProvider()
+        }
+
+        if synchronous {
+            let diffed = ReloadableViewLayoutAdapter.diffedArrangement(of: measuredSectionProvider(), from: previous, isCancelled: { false }, layOut: layOut)!
+            let canBatchUpdate = !currentArrangement.isEmpty
+            currentArrangement = diffed.arrangement
+            currentIdentities = diffed.identities
+            currentArrangementSizeConstraint = sizeConstraint
+            let updateStart = CFAbsoluteTimeGetCurrent()
+            if canBatchUpdate, let batchUpdates = diffed.batchUpdates {
+                reloadableView?.perform(batchUpdates: batchUpdates, completion: completionAndLogEnd)
+            } else {
+                reloadableView?.reloadDataSynchronously()
+                completionAndLogEnd()
+            }
+            metrics?.recordMainThreadUpdate(duration: CFAbsoluteTimeGetCurrent() - updateStart)
+            return
+        }
+
+        let operation = BlockOperation()
+        let updateManager = BatchUpdateManager(delegate: self, operation: operation, sizeConstraint: sizeConstraint)
+        operation.addExecutionBlock { [weak operation, weak self] in
+            let isCancelled = { operation?.isCancelled ?? true }
+            guard let diffed = ReloadableViewLayoutAdapter.diffedArrangement(of: measuredSectionProvider(), from: previous, isCancelled: isCancelled, layOut: layOut) else {
+                return
+            }
+            updateManager.didApplyFinalArrangement = {
+                self?.currentIdentities = diffed.identities
+            }
+            updateManager.apply(finalArrangement: diffed.arrangement, batchUpdates: diffed.batchUpdates, completion: completionAndLogEnd)
+        }
+        backgroundLayoutQueue.addOperation(operation)
+    }
+
+    /**
+     Lays out the sections, reusing the arrangements of unchanged items in `previous`, and computes the updates since `previous`.
+
+     - parameter layOut: Arranges layouts. It returns nil if the reload was cancelled.
+     - returns: nil if the reload was cancelled.
+     */
+    static func diffedArrangement(
+        of sections: [IdentifiedSection],
+        from previous: DiffingReloadState?,
+        isCancelled: () -> Bool,
+        layOut: ([Layout], () -> Bool) -> [LayoutArrangement]?) -> DiffedArrangement? {
+
+        let identities = sections.map { section in
+            return SectionIdentity(
+                id: section.id,
+                header: section.header?.content,
+                items: section.items.map { ItemIdentity(id: $0.id, content: $0.content) },
+                footer: section.footer?.content)
+        }
+
+        // The arrangements that can be reused, by item identity and by section id.
+        var reusableItems = [ItemIdentity: LayoutArrangement]()
+        var reusableSections = [AnyHashable: (identity: SectionIdentity, section: Section<[LayoutArrangement]>)]()
+        if let previous = previous, previous.canReuseArrangements, previous.identities.count == previous.arrangement.count {
+            for (identity, section) in zip(previous.identities, previous.arrangement) where identity.items.count == section.items.count {
+                reusableSections[identity.id] = (identity, section)
+                for (item, arrangement) in zip(identity.items, section.items) where reusableItems[item] == nil {
+                    reusableItems[item] = arrangement
+                }
+            }
+        }
+
+        // Collect the layouts of everything that can't be reused, so that they are laid out together.
+        var headers = [LayoutArrangement?](repeating: nil, count: sections.count)
+        var footers = [LayoutArrangement?](repeating: nil, count: sections.count)
+        var items = sections.map { [LayoutArrangement?](repeating: nil, count: $0.items.count) }
+        var pendingLayouts = [Layout]()
+        var pendingSlots = [DiffedSlot]()
+        for (sectionIndex, section) in sections.enumerated() {
+            if isCancelled() {
+                return nil
+            }
+            let reusableSection = reusableSections[section.id]
+            if let header = section.header {
+                if let reusable = reusableSection, reusable.identity.header == header.content, let arrangement = reusable.section.header {
+                    headers[sectionIndex] = arrangement
+                } else {
+                    pendingLayouts.append(header.makeLayout())
+                    pendingSlots.append(.header(section: sectionIndex))
+                }
+            }
+            if let footer = section.footer {
+                if let reusable = reusableSection, reusable.identity.footer == footer.content, let arrangement = reusable.section.footer {
+                    footers[sectionIndex] = arrangement
+                } else {
+                    pendingLayouts.append(footer.makeLayout())
+                    pendingSlots.append(.footer(section: sectionIndex))
+                }
+            }
+            for (itemIndex, item) in section.items.enumerated() {
+                if let arrangement = reusableItems[identities[sectionIndex].items[itemIndex]] {
+                    items[sectionIndex][itemIndex] = arrangement
+                } else {
+                    pendingLayouts.append(item.makeLayout())
+                    pendingSlots.append(.item(IndexPath(item: itemIndex, section: sectionIndex)))
+                }
+            }
+        }
+
+        guard let laidOut = layOut(pendingLayouts, isCancelled) else {
+            return nil
+        }
+        for (slot, arrangement) in zip(pendingSlots, laidOut) {
+            switch slot {
+            case .header(let section):
+                headers[section] = arrangement
+            case .footer(let section):
+                footers[section] = arrangement
+            case .item(let indexPath):
+                items[indexPath.section][indexPath.item] = arrangement
+            }
+        }
+
+        let arrangement = sections.indices.map { index in
+            return Section(header: headers[index], items: items[index].map { $0! }, footer: footers[index])
+        }
+        let batchUpdates = previous.map { batchUpdatesFrom($0.identities, to: identities) }
+        return DiffedArrangement(arrangement: arrangement, identities: identities, batchUpdates: batchUpdates)
+    }
+
+    /**
+     Returns the updates that turn sections with the `old` identities into sections with the `new` identities.
+
+     Sections and items are matched by id. Matched items whose content changed are reloaded.
+     Matched sections that moved are deleted and inserted instead if anything in them changed,
+     because a reloadable view can't move a section and update its items at the same time.
+     For the same reason, items that moved and changed are deleted and inserted.
+     Sections whose header or footer changed are reloaded.
+     */
+    static func batchUpdatesFrom(_ old: [SectionIdentity], to new: [SectionIdentity]) -> BatchUpdates {
+        let batchUpdates = BatchUpdates()
+        let sectionDiff = ListDiff(old: old.map { $0.id }, new: new.map { $0.id })
+        batchUpdates.deleteSections = IndexSet(sectionDiff.deletedIndexes)
+        batchUpdates.insertSections = IndexSet(sectionDiff.insertedIndexes)
+
+        for (newSectionIndex, match) in sectionDiff.matches.enumerated() {
+            guard let match = match else {
+                continue
+            }
+            let oldSectionIndex = match.oldIndex
+            let oldSection = old[oldSectionIndex]
+            let newSection = new[newSectionIndex]
+
+            if match.isMoved {
+                if oldSection == newSection {
+                    batchUpdates.moveSections.append(SectionMove(from: oldSectionIndex, to: newSectionIndex))
+                } else {
+                    batchUpdates.deleteSections.insert(oldSectionIndex)
+                    batchUpdates.insertSections.insert(newSectionIndex)
+                }
+                continue
+            }
+            if oldSection.header != newSection.header || oldSection.footer != newSection.footer {
+                batchUpdates.reloadSections.insert(oldSectionIndex)
+                continue
+            }
+
+            let itemDiff = ListDiff(old: oldSection.items.map { $0.id }, new: newSection.items.map { $0.id })
+            batchUpdates.deleteItems += itemDiff.deletedIndexes.map { IndexPath(item: $0, section: oldSectionIndex) }
+            batchUpdates.insertItems += itemDiff.insertedIndexes.map { IndexPath(item: $0, section: newSectionIndex) }
+            for (newItemIndex, itemMatch) in itemDiff.matches.enumerated() {
+                guard let itemMatch = itemMatch else {
+                    continue
+                }
+                let from = IndexPath(item: itemMatch.oldIndex, section: oldSectionIndex)
+                let to = IndexPath(item: newItemIndex, section: newSectionIndex)
+                let isChanged = oldSection.items[itemMatch.oldIndex].content != newSection.items[newItemIndex].content
+                switch (itemMatch.isMoved, isChanged) {
+                case (true, true):
+                    batchUpdates.deleteItems.append(from)
+                    batchUpdates.insertItems.append(to)
+                case (true, false):
+                    batchUpdates.moveItems.append(ItemMove(from: from, to: to))
+                case (false, true):
+                    batchUpdates.reloadItems.append(from)
+                case (false, false):
+                    break
+                }
+            }
+        }
+        return batchUpdates
+    }
+}
+
+/// The identity of an item of a diffing reload.
+struct ItemIdentity: Hashable {
+    let id: AnyHashable
+    let content: AnyHashable
+}
+
+/// The identity of a section of a diffing reload.
+struct SectionIdentity: Equatable {
+    let id: AnyHashable
+    let header: AnyHashable?
+    let items: [ItemIdentity]
+    let footer: AnyHashable?
+}
+
+/// The current arrangement that a diffing reload compares with.
+struct DiffingReloadState {
+    let arrangement: [Section<[LayoutArrangement]>]
+    let identities: [SectionIdentity]
+
+    /// Whether the arrangements were arranged within the same size as the reload.
+    let canReuseArrangements: Bool
+}
+
+/// The result of a diffing reload.
+struct DiffedArrangement {
+    let arrangement: [Section<[LayoutArrangement]>]
+    let identities: [SectionIdentity]
+
+    /// The updates since the previous diffing reload, or nil if there was none.
+    let batchUpdates: BatchUpdates?
+}
+
+/// Where a layout that is laid out by a diffing reload goes.
+private enum DiffedSlot {
+    case header(section: Int)
+    case footer(section: Int)
+    case item(IndexPath)
+}
+
+/**
+ Matches two lists of ids with Paul Heckel's algorithm and finds the fewest matches that have to move.
+
+ Ids that occur exactly once in both lists are matched, and matches are extended to equal neighbors.
+ Matches that keep their relative order are the longest increasing subsequence of their old indexes;
+ all other matches are moves. Matching is linear and finding moves is O(n log n) in the number of ids.
+ */
+struct ListDiff {
+
+    struct Match {
+        let oldIndex: Int
+        let isMoved: Bool
+    }
+
+    /// The match of each new index, or nil if the id at the new index is inserted.
+    private(set) var matches: [Match?]
+
+    /// The old indexes whose ids are deleted.
+    private(set) var deletedIndexes = [Int]()
+
+    /// The new indexes whose ids are inserted.
+    private(set) var insertedIndexes = [Int]()
+
+    init<ID: Hashable>(old: [ID], new: [ID]) {
+        struct Entry {
+            var oldCount = 0
+            var newCount = 0
+            var oldIndex = 0
+        }
+
+        var entries = [ID: Entry](minimumCapacity: max(old.count, new.count))
+        for id in new {
+            entries[id, default: Entry()].newCount += 1
+        }
+        for (index, id) in old.enumerated() {
+            entries[id, default: Entry()].oldCount += 1
+            entries[id]?.oldIndex = index
+        }
+
+        var oldIndexes = [Int?](repeating: nil, count: new.count)
+        var newIndexes = [Int?](repeating: nil, count: old.count)
+        for (newIndex, id) in new.enumerated() {
+            if let entry = entries[id], entry.oldCount == 1 && entry.newCount == 1 {
+                oldIndexes[newIndex] = entry.oldIndex
+                newIndexes[entry.oldIndex] = newIndex
+            }
+        }
+        // Extend matches to neighbors with equal ids that aren't unique.
+        if new.count > 1 {
+            for newIndex in 0..<(new.count - 1) {
+                if let oldIndex = oldIndexes[newIndex], oldIndex + 1 < old.count, oldIndexes[newIndex + 1] == nil, newIndexes[oldIndex + 1] == nil, new[newIndex + 1] == old[oldIndex + 1] {
+                    oldIndexes[newIndex + 1] = oldIndex + 1
+                    newIndexes[oldIndex + 1] = newIndex + 1
+                }
+            }
+            for newIndex in (1..<new.count).reversed() {
+                if let oldIndex = oldIndexes[newIndex], oldIndex > 0, oldIndexes[newIndex - 1] == nil, newIndexes[oldIndex - 1] == nil, new[newIndex - 1] == old[oldIndex - 1] {
+                    oldIndexes[newIndex - 1] = oldIndex - 1
+                    newIndexes[oldIndex - 1] = newIndex - 1
+                }
+            }
+        }
+
+        let stationary = ListDiff.longestIncreasingSubsequence(of: oldIndexes)
+        matches = oldIndexes.enumerated().map { newIndex, oldIndex in
+            return oldIndex.map { Match(oldIndex: $0, isMoved: !stationary.contains(newIndex)) }
+        }
+        deletedIndexes = newIndexes.indices.filter { newIndexes[$0] == nil }
+        insertedIndexes = oldIndexes.indices.filter { oldIndexes[$0] == nil }
+    }
+
+    /// Returns the positions of the longest increasing subsequence of the non-nil values.
+    private static func longestIncreasingSubsequence(of values: [Int?]) -> Set<Int> {
+        // tails[length - 1] is the position of the smallest value that ends an increasing subsequence of that length.
+        var tails = [Int]()
+        var predecessors = [Int](repeating: -1, count: values.count)
+        for (position, value) in values.enumerated() {
+            guard let value = value else {
+                continue
+            }
+            var low = 0
+            var high = tails.count
+            while low < high {
+                let middle = (low + high) / 2
+                if values[tails[middle]]! < value {
+                    low = middle + 1
+                } else {
+                    high = middle
+                }
+            }
+            if low > 0 {
+                predecessors[position] = tails[low - 1]
+            }
+            if low == tails.count {
+                tails.append(position)
+            } else {
+                tails[low] = position
+            }
+        }
+        var positions = Set<Int>(minimumCapacity: tails.count)
+        var position = tails.last ?? -1
+        while position >= 0 {
+            positions.insert(position)
+            position = predecessors[position]
+        }
+        return positions
+    }
+}
@@ -0,0 +1,378 @@
+// Copyright 2019 LinkedIn Corp.
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+
+import UIKit
+
+// MARK: - Evicting arrangements
+
+extension ReloadableViewLayoutAdapter {
+
+    /**
+     Replaces the arrangements of items far from the visible bounds with arrangements that only have their frames,
+     so that the current arrangement holds at most `budget` full arrangements of items.
+
+     This is a pass over all items, which runs after the current arrangement changes and on memory warnings.
+     Items within the visible bounds and one screen of items on each side of them are never evicted.
+     The other items are evicted farthest first. Evicted items near the visible bounds are restored in the background.
+     The items that keep their arrangements are then tracked from the farthest to the nearest,
+     so that `evictLeastRecentlyUsedArrangements` can evict later overruns without looking at every item.
+     Nothing is evicted while a reload is in progress, if the size that the items were arranged within is unknown,
+     or if `itemLayoutProvider` is nil.
+
+     - parameter budget: The number of items that may keep their full arrangement. If nil, only items near the visible bounds are restored.
+     */
+    func evictArrangements(keepingAtMost budget: Int?) {
+        assert(Thread.isMainThread, "evictArrangements must be called on the main thread")
+
+        guard let evictedLayout = makeEvictedLayout else {
+            return
+        }
+        let retainedRange = retainedItemRange()
+
+        var retainedIndexPaths = [IndexPath]()
+        var candidates = [(indexPath: IndexPath, distance: Int)]()
+        var restorableIndexPaths = [IndexPath]()
+        var flatIndex = 0
+        for (sectionIndex, section) in currentArrangement.enumerated() {
+            for (itemIndex, item) in section.items.enumerated() {
+                let indexPath = IndexPath(item: itemIndex, section: sectionIndex)
+                let isEvicted = item.layout is EvictedLayout
+                let isArranged = !isEvicted && !(item.layout is PlaceholderLayout)
+                if let range = retainedRange, range.contains(flatIndex) {
+                    if isEvicted {
+                        restorableIndexPaths.append(indexPath)
+                    } else if isArranged {
+                        retainedIndexPaths.append(indexPath)
+                    }
+                } else if isArranged {
+                    let distance = retainedRange.map { flatIndex < $0.lowerBound ? $0.lowerBound - flatIndex : flatIndex - $0.upperBound } ?? flatIndex
+                    candidates.append((indexPath, distance))
+                }
+                flatIndex += 1
+            }
+        }
+        needsFullArrangementEviction = false
+
+        restoreArrangements(at: restorableIndexPaths)
+
+        let arrangedCount = retainedIndexPaths.count + candidates.count
+        let evictedCount = budget.map { max(arrangedCount - $0, 0) } ?? 0
+        let sortedCandidates = candidates.sorted { $0.distance > $1.distance }
+        replaceItems(at: sortedCandidates.prefix(evictedCount).map { $0.indexPath }) { _, item in
+            return LayoutArrangement(layout: evictedLayout(item.frame.size), frame: item.frame, sublayouts: [])
+        }
+
+        // The nearest items are the most recently used.
+        recentlyUsedItems.removeAll()
+        for candidate in sortedCandidates.dropFirst(evictedCount) {
+            recentlyUsedItems.setValue((), forKey: candidate.indexPath)
+        }
+        for indexPath in retainedIndexPaths {
+            recentlyUsedItems.setValue((), forKey: indexPath)
+        }
+    }
+
+    /**
+     Evicts the arrangements of the least recently shown or restored items until at most `budget` items keep their full arrangements.
+     Items near the visible bounds are kept and count as used. Only the items that are evicted or kept are looked at.
+     */
+    func evictLeastRecentlyUsedArrangements(keepingAtMost budget: Int) {
+        assert(Thread.isMainThread, "evictLeastRecentlyUsedArrangements must be called on the main thread")
+
+        guard let evictedLayout = makeEvictedLayout else {
+            return
+        }
+        let retainedRange = retainedItemRange()
+        let sectionStartIndexes = self.sectionStartIndexes()
+
+        var evictedIndexPaths = [IndexPath]()
+        var retainedIndexPaths = [IndexPath]()
+        while recentlyUsedItems.count > budget, let indexPath = recentlyUsedItems.removeLeastRecentlyUsed() {
+            guard let item = itemArrangement(at: indexPath), !(item.layout is EvictedLayout), !(item.layout is PlaceholderLayout) else {
+                continue
+            }
+            if let range = retainedRange, range.contains(sectionStartIndexes[indexPath.section] + indexPath.item) {
+                retainedIndexPaths.append(indexPath)
+            } else {
+                evictedIndexPaths.append(indexPath)
+            }
+        }
+        for indexPath in retainedIndexPaths {
+            recentlyUsedItems.setValue((), forKey: indexPath)
+        }
+        replaceItems(at: evictedIndexPaths) { _, item in
+            return LayoutArrangement(layout: evictedLayout(item.frame.size), frame: item.frame, sublayouts: [])
+        }
+    }
+
+    /**
+     Schedules an eviction for the next turn of the main run loop, unless one is already scheduled.
+     It passes over all items if the current arrangement changed, and otherwise only runs if more items than the budget are arranged.
+     */
+    func scheduleArrangementEviction() {
+        guard let budget = maxArrangedItemCount, !isArrangementEvictionScheduled,
+            needsFullArrangementEviction || recentlyUsedItems.count > budget else {
+            return
+        }
+        isArrangementEvictionScheduled = true
+        DispatchQueue.main.async { [weak self] in
+            guard let strongSelf = self else {
+                return
+            }
+            strongSelf.isArrangementEvictionScheduled = false
+            guard let budget = strongSelf.maxArrangedItemCount else {
+                return
+            }
+            if strongSelf.needsFullArrangementEviction {
+                strongSelf.evictArrangements(keepingAtMost: budget)
+            } else {
+                strongSelf.evictLeastRecentlyUsedArrangements(keepingAtMost: budget)
+            }
+        }
+    }
+
+    /// Marks the item as the most recently used one and schedules an eviction if that exceeds the budget.
+    func markItemUsed(at indexPath: IndexPath) {
+        guard maxArrangedItemCount != nil, let item = itemArrangement(at: indexPath),
+            !(item.layout is EvictedLayout), !(item.layout is PlaceholderLayout) else {
+            return
+        }
+        recentlyUsedItems.setValue((), forKey: indexPath)
+        scheduleArrangementEviction()
+    }
+
+    /// Releases prewarmed views and, if `maxArrangedItemCount` is set, evicts the arrangements of all items that are not near the visible bounds.
+    @objc func handleMemoryWarning(_ notification: Notification) {
+        viewPrewarmer.removeAll()
+        guard maxArrangedItemCount != nil else {
+            return
+        }
+        evictArrangements(keepingAtMost: 0)
+    }
+
+    /**
+     Whether the arrangement of the item was evicted (see `maxArrangedItemCount`).
+     The entry of an evicted item in `currentArrangement` has the frame of the item but no sublayouts and no views.
+     Must be called on the main thread.
+     */
+    public func isArrangementEvicted(ofItemAt indexPath: IndexPath) -> Bool {
+        return evictedLayout(at: indexPath) != nil
+    }
+
+    /// Makes the stand-in for an evicted item of a size, or nil if arrangements can't be evicted now.
+    private var makeEvictedLayout: ((CGSize) -> EvictedLayout)? {
+        guard itemLayoutProvider != nil, let sizeConstraint = currentArrangementSizeConstraint, backgroundLayoutQueue.operationCount == 0 else {
+            return nil
+        }
+        let width: CGFloat? = sizeConstraint.width == .greatestFiniteMagnitude ? nil : sizeConstraint.width
+        let height: CGFloat? = sizeConstraint.height == .greatestFiniteMagnitude ? nil : sizeConstraint.height
+        return { size in
+            return EvictedLayout(size: size, width: width, height: height)
+        }
+    }
+
+    /// The index of the first item of each section, counting the items of all sections in order.
+    private func sectionStartIndexes() -> [Int] {
+        var sectionStartIndexes = [Int]()
+        var itemCount = 0
+        for section in currentArrangement {
+            sectionStartIndexes.append(itemCount)
+            itemCount += section.items.count
+        }
+        return sectionStartIndexes
+    }
+
+    /// The range of indexes, counting the items of all sections in order, that are within the visible bounds
+    /// or within as many items again on each side. Nil if no items are visible.
+    private func retainedItemRange() -> ClosedRange<Int>? {
+        let visibleIndexPaths = self.visibleIndexPaths()
+        guard !visibleIndexPaths.isEmpty else {
+            return nil
+        }
+        let sectionStartIndexes = self.sectionStartIndexes()
+        let flatIndexes = visibleIndexPaths
+            .filter { $0.section < sectionStartIndexes.count }
+            .map { sectionStartIndexes[$0.section] + $0.item }
+        guard let first = flatIndexes.min(), let last = flatIndexes.max() else {
+            return nil
+        }
+        let margin = last - first + 1
+        return max(0, first - margin)...(last + margin)
+    }
+
+    /// The index paths of the items that the reloadable view shows.
+    private func visibleIndexPaths() -> [IndexPath] {
+        if let tableView = reloadableView as? UITableView {
+            return tableView.indexPathsForVisibleRows ?? []
+        }
+        if let collectionView = reloadableView as? UICollectionView {
+            return collectionView.indexPathsForVisibleItems
+        }
+        guard let reloadableView = reloadableView else {
+            return []
+        }
+        // Other reloadable views are assumed to stack their items along the axis that is not constrained.
+        let axis: Axis = currentArrangementSizeConstraint?.width == .greatestFiniteMagnitude ? .horizontal : .vertical
+        let bounds = reloadableView.bounds
+        let origin = AxisPoint(axis: axis, point: bounds.origin).axisOffset
+        let length = AxisSize(axis: axis, size: bounds.size).axisLength
+        return ReloadableViewLayoutAdapter.itemIndexPaths(from: origin, to: origin + length, in: currentArrangement, axis: axis)
+    }
+}
+
+// MARK: - Restoring arrangements
+
+extension ReloadableViewLayoutAdapter {
+
+    /**
+     Recomputes the arrangements of the evicted items at the index paths on a background queue
+     and puts them back into the current arrangement on the main thread.
+     The layouts of the items are provided by `itemLayoutProvider` on the background queue.
+
+     - parameter completion: Called on the main thread with the index paths of the items that were restored.
+     */
+    func restoreArrangements(at indexPaths: [IndexPath], completion: (([IndexPath]) -> Void)? = nil) {
+        guard let itemLayoutProvider = itemLayoutProvider else {
+            return
+        }
+        var evictedItems = [(indexPath: IndexPath, layout: EvictedLayout)]()
+        for indexPath in indexPaths {
+            guard let evicted = evictedLayout(at: indexPath), !restoringLayouts.contains(ObjectIdentifier(evicted)) else {
+                continue
+            }
+            restoringLayouts.insert(ObjectIdentifier(evicted))
+            evictedItems.append((indexPath, evicted))
+        }
+        guard !evictedItems.isEmpty else {
+            return
+        }
+
+        let measurementCache = self.measurementCache
+        arrangementRestorationQueue.async { [weak self] in
+            let restored = evictedItems.map { item in
+                return (item.indexPath, item.layout, item.layout.restoredArrangement(of: itemLayoutProvider(item.indexPath), measurementCache: measurementCache))
+            }
+            DispatchQueue.main.async {
+                guard let strongSelf = self else {
+                    return
+                }
+                var restoredIndexPaths = [IndexPath]()
+                var arrangements = [IndexPath: LayoutArrangement]()
+                for (indexPath, evicted, arrangement) in restored {
+                    strongSelf.restoringLayouts.remove(ObjectIdentifier(evicted))
+                    // The item may have been restored, replaced or moved in the meantime.
+                    if strongSelf.evictedLayout(at: indexPath) === evicted {
+                        arrangements[indexPath] = arrangement
+                        restoredIndexPaths.append(indexPath)
+                    }
+                }
+                strongSelf.replaceItems(at: restoredIndexPaths) { indexPath, _ in
+                    arrangements[indexPath]!
+                }
+                for indexPath in restoredIndexPaths {
+                    strongSelf.markItemUsed(at: indexPath)
+                }
+                completion?(restoredIndexPaths)
+            }
+        }
+    }
+
+    /**
+     Makes the views of the item at the index path in the content view of its cell.
+
+     Prefetching restores evicted items in the background before their cells are needed.
+     If an evicted item wasn't prefetched in time, only that item is arranged again on the main thread.
+     */
+    func makeViews(ofItemAt indexPath: IndexPath, in contentView: UIView) {
+        var item = currentArrangement[indexPath.section].items[indexPath.item]
+        if let evicted = item.layout as? EvictedLayout, let itemLayoutProvider = itemLayoutProvider {
+            let restored = evicted.restoredArrangement(of: itemLayoutProvider(indexPath), measurementCache: measurementCache)
+            replaceItems(at: [indexPath]) { _, _ in restored }
+            item = restored
+        }
+        makeViews(of: item, at: indexPath, in: contentView)
+        markItemUsed(at: indexPath)
+    }
+
+    /// The arrangement with the arrangements of evicted items recomputed. It may be called on any thread.
+    static func arrangementRestoringEvictedItems(_ arrangement: [Section<[LayoutArrangement]>],
+                                                 itemLayoutProvider: ((IndexPath) -> Layout)?,
+                                                 measurementCache: LayoutMeasurementCache?) -> [Section<[LayoutArrangement]>] {
+        guard let itemLayoutProvider = itemLayoutProvider else {
+            return arrangement
+        }
+        return arrangement.enumerated().map { sectionIndex, section in
+            Section(header: section.header, items: section.items.enumerated().map { itemIndex, item in
+                guard let evicted = item.layout as? EvictedLayout else {
+                    return item
+                }
+                let layout = itemLayoutProvider(IndexPath(item: itemIndex, section: sectionIndex))
+                return evicted.restoredArrangement(of: layout, measurementCache: measurementCache)
+            }, footer: section.footer)
+        }
+    }
+
+    private func evictedLayout(at indexPath: IndexPath) -> EvictedLayout? {
+        return itemArrangement(at: indexPath)?.layout as? EvictedLayout
+    }
+
+    /**
+     Replaces the items at the index paths without changing the number of items.
+     The identities of the current arrangement, the size that it was arranged within
+     and which of its items were recently used still describe it, so they are kept.
+     */
+    private func replaceItems(at indexPaths: [IndexPath], with replacement: (IndexPath, LayoutArrangement) -> LayoutArrangement) {
+        guard !indexPaths.isEmpty else {
+            return
+        }
+        var arrangement = currentArrangement
+        for (sectionIndex, sectionIndexPaths) in Dictionary(grouping: indexPaths, by: { $0.section }) {
+            let section = arrangement[sectionIndex]
+            var items = section.items
+            for indexPath in sectionIndexPaths {
+                items[indexPath.item] = replacement(indexPath, items[indexPath.item])
+            }
+            arrangement[sectionIndex] = Section(header: section.header, items: items, footer: section.footer)
+        }
+        let identities = currentIdentities
+        let sizeConstraint = currentArrangementSizeConstraint
+        let needsFullArrangementEviction = self.needsFullArrangementEviction
+        currentArrangement = arrangement
+        currentIdentities = identities
+        currentArrangementSizeConstraint = sizeConstraint
+        self.needsFullArrangementEviction = needsFullArrangementEviction
+    }
+}
+
+/**
+ Stands in for the root layout of an item whose arrangement was evicted. It has the size of the item and no view.
+
+ It only keeps the size that the item was arranged within. The item's layout and arrangement are released,
+ and `ReloadableViewLayoutAdapter.itemLayoutProvider` provides the layout again when the item is restored.
+ */
+final class EvictedLayout: SizeLayout<View> {
+
+    let width: CGFloat?
+    let height: CGFloat?
+
+    init(size: CGSize, width: CGFloat?, height: CGFloat?) {
+        self.width = width
+        self.height = height
+        super.init(minWidth: size.width, maxWidth: size.width, minHeight: size.height, maxHeight: size.height)
+    }
+
+    /// Arranges the item's layout again, like the reload that evicted it did. It may be called on any thread.
+    func restoredArrangement(of layout: Layout, measurementCache: LayoutMeasurementCache?) -> LayoutArrangement {
+        guard let measurementCache = measurementCache else {
+            return layout.arrangement(width: width, height: height)
+        }
+        return measurementCache.perform {
+            return layout.arrangement(width: width, height: height)
+        }
+    }
+}
@@ -0,0 +1,194 @@
+// Copyright 2019 LinkedIn Corp.
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+
+import UIKit
+
+// MARK: - Incremental reload
+
+extension ReloadableViewLayoutAdapter {
+
+    /**
+     Reloads the view with the new layout, only laying out the items that `batchUpdates` inserts or reloads.
+
+     The arrangements of all other items are carried over from `currentArrangement` to their new index paths,
+     following the deletes and moves in `batchUpdates`. The headers and footers of sections that are not inserted
+     or reloaded are carried over too. The layout provider is still called, but the layouts of items that are
+     carried over are not measured, so the cost of the reload is proportional to the number of changed items.
+
+     `batchUpdates` MUST describe every change between the current arrangement and the layouts returned by `layoutProvider`,
+     using the same index path semantics as `UICollectionView.performBatchUpdates`.
+     Sections whose item count doesn't match `batchUpdates` are laid out completely.
+     If the width or height is different from the previous reload, or if another reload is still in progress, all items are laid out.
+
+     - parameter width: The width of the layout's arrangement. Nil means no constraint. Default is nil.
+     - parameter height: The height of the layout's arrangement. Nil means no constraint. Default is nil.
+     - parameter synchronous: If true, `reloadIncrementally` will not return until the operation is complete. Default is false.
+     - parameter batchUpdates: The changes since the current arrangement. They are applied to the reloadable view after the layout is computed.
+     - parameter layoutProvider: A closure that produces the layout. It is called on a background thread so it must be threadsafe.
+     - parameter completion: A closure that is called on the main thread when the operation is complete.
+     */
+    open func reloadIncrementally<T: Collection, U>(
+        width: CGFloat? = nil,
+        height: CGFloat? = nil,
+        synchronous: Bool = false,
+        batchUpdates: BatchUpdates,
+        layoutProvider: @escaping () -> T,
+        completion: (() -> Void)? = nil) where U.Iterator.Element == Layout, T.Iterator.Element == Section<U> {
+
+        assert(Thread.isMainThread, "reloadIncrementally must be called on the main thread")
+
+        let previousArrangement = currentArrangement
+        let sizeConstraint = ReloadableViewLayoutAdapter.sizeConstraint(width: width, height: height)
+        // While another reload is in progress, the current arrangement may not be the one that `batchUpdates` describes changes to.
+        guard !previousArrangement.isEmpty && currentArrangementSizeConstraint == sizeConstraint && backgroundLayoutQueue.operationCount == 0 else {
+            reload(width: width, height: height, synchronous: synchronous, batchUpdates: batchUpdates, layoutProvider: layoutProvider, completion: completion)
+            return
+        }
+
+        let carriedOverLayoutProvider = { () -> [Section<[Layout]>] in
+            let sectionLayouts = layoutProvider().map { Section(header: $0.header, items: Array($0.items), footer: $0.footer) }
+            let carriedOverSections = ReloadableViewLayoutAdapter.carriedOverArrangements(
+                from: previousArrangement,
+                through: batchUpdates,
+                itemCounts: sectionLayouts.map { $0.items.count })
+
+            return zip(sectionLayouts, carriedOverSections).map { sectionAndCarriedOver -> Section<[Layout]> in
+                let (sectionLayout, carriedOver) = sectionAndCarriedOver
+                // A header or footer that was added is laid out.
+                let header = sectionLayout.header.map { CarriedOverLayout.layout($0, carryingOver: carriedOver.header) }
+                let footer = sectionLayout.footer.map { CarriedOverLayout.layout($0, carryingOver: carriedOver.footer) }
+                let items = zip(sectionLayout.items, carriedOver.items).map { layoutAndArrangement -> Layout in
+                    return CarriedOverLayout.layout(layoutAndArrangement.0, carryingOver: layoutAndArrangement.1)
+                }
+                return Section(header: header, items: items, footer: footer)
+            }
+        }
+
+        reload(width: width, height: height, synchronous: synchronous, batchUpdates: batchUpdates, layoutProvider: carriedOverLayoutProvider, completion: completion)
+    }
+
+    /// The maximum size that layouts are arranged within for the width and height passed to `reload`.
+    static func sizeConstraint(width: CGFloat?, height: CGFloat?) -> CGSize {
+        return CGSize(width: width ?? .greatestFiniteMagnitude, height: height ?? .greatestFiniteMagnitude)
+    }
+
+    /**
+     Returns the arrangements of the items in `arrangement` at the index paths that they have after `batchUpdates`.
+
+     Items that are inserted or reloaded, and items in sections that are inserted or reloaded, are nil.
+     Deletes and reloads refer to index paths before the updates. Inserts refer to index paths after the updates.
+
+     - parameter itemCounts: The number of items in each section after the updates.
+     */
+    static func carriedOverArrangements(
+        from arrangement: [Section<[LayoutArrangement]>],
+        through batchUpdates: BatchUpdates,
+        itemCounts: [Int]) -> [CarriedOverSection] {
+
+        let notCarriedOver = itemCounts.map { CarriedOverSection(header: nil, items: [LayoutArrangement?](repeating: nil, count: $0), footer: nil) }
+
+        // Find the section before the updates that each section after the updates shows.
+        var oldSectionIndexes = [Int?](repeating: nil, count: itemCounts.count)
+        var takenSectionIndexes = batchUpdates.insertSections
+        for move in batchUpdates.moveSections {
+            if move.to < oldSectionIndexes.count {
+                oldSectionIndexes[move.to] = move.from
+            }
+            takenSectionIndexes.insert(move.to)
+        }
+        let movedSectionIndexes = IndexSet(batchUpdates.moveSections.map { $0.from })
+        var remainingSectionIndexes = arrangement.indices.filter { oldSectionIndex in
+            return !batchUpdates.deleteSections.contains(oldSectionIndex) && !movedSectionIndexes.contains(oldSectionIndex)
+        }.makeIterator()
+        for newSectionIndex in oldSectionIndexes.indices where !takenSectionIndexes.contains(newSectionIndex) {
+            guard let oldSectionIndex = remainingSectionIndexes.next() else {
+                // The updates don't match the number of sections.
+                return notCarriedOver
+            }
+            oldSectionIndexes[newSectionIndex] = oldSectionIndex
+        }
+        if remainingSectionIndexes.next() != nil {
+            return notCarriedOver
+        }
+
+        let reloadedIndexPaths = Set(batchUpdates.reloadItems)
+        func carriedOverItem(at indexPath: IndexPath) -> LayoutArrangement? {
+            guard indexPath.section < arrangement.count,
+                indexPath.item < arrangement[indexPath.section].items.count,
+                !batchUpdates.reloadSections.contains(indexPath.section),
+                !batchUpdates.deleteSections.contains(indexPath.section),
+                !reloadedIndexPaths.contains(indexPath) else {
+                    return nil
+            }
+            return arrangement[indexPath.section].items[indexPath.item]
+        }
+
+        return oldSectionIndexes.indices.map { newSectionIndex -> CarriedOverSection in
+            guard let oldSectionIndex = oldSectionIndexes[newSectionIndex],
+                oldSectionIndex < arrangement.count,
+                !batchUpdates.reloadSections.contains(oldSectionIndex) else {
+                    return notCarriedOver[newSectionIndex]
+            }
+
+            let itemCount = itemCounts[newSectionIndex]
+            var items = [LayoutArrangement?](repeating: nil, count: itemCount)
+            var takenItemIndexes = IndexSet(batchUpdates.insertItems.filter({ $0.section == newSectionIndex }).map({ $0.item }))
+            for move in batchUpdates.moveItems where move.to.section == newSectionIndex {
+                if move.to.item < itemCount {
+                    items[move.to.item] = carriedOverItem(at: move.from)
+                }
+                takenItemIndexes.insert(move.to.item)
+            }
+
+            let removedItemIndexes = IndexSet(
+                batchUpdates.deleteItems.filter({ $0.section == oldSectionIndex }).map({ $0.item }) +
+                batchUpdates.moveItems.filter({ $0.from.section == oldSectionIndex }).map({ $0.from.item }))
+            var remainingItemIndexes = arrangement[oldSectionIndex].items.indices.filter({ !removedItemIndexes.contains($0) }).makeIterator()
+            for newItemIndex in 0..<itemCount where !takenItemIndexes.contains(newItemIndex) {
+                guard let oldItemIndex = remainingItemIndexes.next() else {
+                    // The updates don't match the number of items in this section.
+                    return notCarriedOver[newSectionIndex]
+                }
+                items[newItemIndex] = carriedOverItem(at: IndexPath(item: oldItemIndex, section: oldSectionIndex))
+            }
+            if remainingItemIndexes.next() != nil {
+                return notCarriedOver[newSectionIndex]
+            }
+
+            let oldSection = arrangement[oldSectionIndex]
+            return CarriedOverSection(header: oldSection.header, items: items, footer: oldSection.footer)
+        }
+    }
+}
+
+/// The arrangements of a section that are carried over from the current arrangement by an incremental reload.
+struct CarriedOverSection {
+    let header: LayoutArrangement?
+    let items: [LayoutArrangement?]
+    let footer: LayoutArrangement?
+}
+
+/// Stands in for a layout whose arrangement is carried over from the current arrangement, so that it isn't laid out again.
+final class CarriedOverLayout: SizeLayout<View> {
+
+    let arrangement: LayoutArrangement
+
+    init(arrangement: LayoutArrangement) {
+        self.arrangement = arrangement
+        let size = arrangement.frame.size
+        super.init(minWidth: size.width, maxWidth: size.width, minHeight: size.height, maxHeight: size.height)
+    }
+
+    /// Returns a layout that stands in for `layout` if there is an arrangement to carry over, or `layout` itself.
+    static func layout(_ layout: Layout, carryingOver arrangement: LayoutArrangement?) -> Layout {
+        guard let arrangement = arrangement else {
+            return layout
+        }
+        return CarriedOverLayout(arrangement: arrangement)
+    }
+}
@@ -0,0 +1,254 @@
+// Copyright 2019 LinkedIn Corp.
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+
+import UIKit
+
+// MARK: - UICollectionViewDataSourcePrefetching
+
+@available(iOS 10.0, tvOS 10.0, *)
+extension ReloadableViewLayoutAdapter: UICollectionViewDataSourcePrefetching {
+
+    /// - Warning: Subclasses that override this method must call super
+    open func collectionView(_ collectionView: UICollectionView, prefetchItemsAt indexPaths: [IndexPath]) {
+        prefetchItems(at: indexPaths)
+    }
+
+    /// - Warning: Subclasses that override this method must call super
+    open func collectionView(_ collectionView: UICollectionView, cancelPrefetchingForItemsAt indexPaths: [IndexPath]) {
+        viewPrewarmer.cancel(indexPaths)
+    }
+}
+
+// MARK: - UITableViewDataSourcePrefetching
+
+@available(iOS 10.0, tvOS 10.0, *)
+extension ReloadableViewLayoutAdapter: UITableViewDataSourcePrefetching {
+
+    /// - Warning: Subclasses that override this method must call super
+    open func tableView(_ tableView: UITableView, prefetchRowsAt indexPaths: [IndexPath]) {
+        prefetchItems(at: indexPaths)
+    }
+
+    /// - Warning: Subclasses that override this method must call super
+    open func tableView(_ tableView: UITableView, cancelPrefetchingForRowsAt indexPaths: [IndexPath]) {
+        viewPrewarmer.cancel(indexPaths)
+    }
+}
+
+// MARK: - Prewarming
+
+extension ReloadableViewLayoutAdapter {
+
+    /**
+     Prepares items that the reloadable view is about to display.
+     Evicted arrangements are restored in the background first, then the views of the items are prewarmed.
+     */
+    func prefetchItems(at indexPaths: [IndexPath]) {
+        let evictedIndexPaths = indexPaths.filter { itemArrangement(at: $0)?.layout is EvictedLayout }
+        restoreArrangements(at: evictedIndexPaths, completion: { [weak self] restoredIndexPaths in
+            self?.prewarmViews(at: restoredIndexPaths)
+        })
+        prewarmViews(at: indexPaths.filter { !evictedIndexPaths.contains($0) })
+    }
+
+    /// Schedules the views of the items to be made while the main run loop is idle.
+    func prewarmViews(at indexPaths: [IndexPath]) {
+        guard prewarmsViews else {
+            return
+        }
+        viewPrewarmer.enqueue(indexPaths)
+    }
+
+    /**
+     Makes the views of an item in the content view of its cell.
+     The views of the cell are recycled first. The other views are taken from the prewarmer if it made them for the same arrangement.
+     */
+    func makeViews(of item: LayoutArrangement, at indexPath: IndexPath, in contentView: UIView) {
+        if let views = viewPrewarmer.takeViews(at: indexPath, for: item, in: contentView) {
+            views.attach(to: contentView)
+        } else {
+            item.makeViews(in: contentView)
+        }
+    }
+
+    /// The arrangement of the item at the index path, or nil if the current arrangement doesn't have it.
+    func itemArrangement(at indexPath: IndexPath) -> LayoutArrangement? {
+        guard indexPath.section < currentArrangement.count, indexPath.item < currentArrangement[indexPath.section].items.count else {
+            return nil
+        }
+        return currentArrangement[indexPath.section].items[indexPath.item]
+    }
+}
+
+/**
+ Makes the views of items that are about to be displayed while the main run loop is idle,
+ so that displaying their cells doesn't need to create and configure the views that the cells don't already have.
+
+ Each time the main run loop is about to wait for events, views are made for pending items until `frameBudget` is used up.
+ At most `capacity` items keep prewarmed views. When there are more, the views that were prewarmed first are released.
+
+ MUST only be used on the main thread.
+ */
+final class ViewPrewarmer {
+
+    /// The views of an item that were made for an arrangement.
+    final class PrewarmedViews {
+
+        let arrangement: LayoutArrangement
+
+        /// Holds the root views of the arrangement until they are attached to a cell.
+        let container: UIView
+
+        init(arrangement: LayoutArrangement, container: UIView) {
+            self.arrangement = arrangement
+            self.container = container
+        }
+
+        /// Whether the views were made for `arrangement` and are flipped the same way as views made in `view` would be.
+        func matches(_ arrangement: LayoutArrangement, in view: UIView) -> Bool {
+            return self.arrangement.frame == arrangement.frame
+                && ViewPrewarmer.isSameLayout(self.arrangement.layout, arrangement.layout)
+                && container.userInterfaceLayoutDirection == view.userInterfaceLayoutDirection
+        }
+
+        /**
+         Makes the views of the arrangement in `view`, like `makeViews` does.
+         The views that `view` already has are recycled, and the prewarmed views are used instead of creating views.
+         */
+        func attach(to view: UIView) {
+            arrangement.makeViews(in: view, prewarmedIn: container)
+        }
+    }
+
+    /// The longest time that prewarming may take each time the main run loop is idle.
+    var frameBudget: CFTimeInterval
+
+    /// The maximum number of items whose prewarmed views are kept.
+    var capacity: Int
+
+    /// Returns the current arrangement of an item.
+    var arrangementProvider: (IndexPath) -> LayoutArrangement? = { _ in nil }
+
+    /// The current time. Tests replace it to control the budget.
+    var clock: () -> CFTimeInterval = CFAbsoluteTimeGetCurrent
+
+    private var pendingIndexPaths = [IndexPath]()
+    private var prewarmedViews = [IndexPath: PrewarmedViews]()
+    private var prewarmedOrder = [IndexPath]()
+    private var observer: CFRunLoopObserver?
+
+    init(frameBudget: CFTimeInterval, capacity: Int) {
+        self.frameBudget = frameBudget
+        self.capacity = capacity
+    }
+
+    deinit {
+        if let observer = observer {
+            CFRunLoopObserverInvalidate(observer)
+        }
+    }
+
+    /// The number of items that are waiting to be prewarmed.
+    var pendingCount: Int {
+        return pendingIndexPaths.count
+    }
+
+    /// The number of items that have prewarmed views.
+    var prewarmedCount: Int {
+        return prewarmedViews.count
+    }
+
+    /// Schedules the items to be prewarmed.
+    func enqueue(_ indexPaths: [IndexPath]) {
+        for indexPath in indexPaths where prewarmedViews[indexPath] == nil && !pendingIndexPaths.contains(indexPath) {
+            pendingIndexPaths.append(indexPath)
+        }
+        scheduleIfNeeded()
+    }
+
+    /// Stops prewarming the items and releases their prewarmed views.
+    func cancel(_ indexPaths: [IndexPath]) {
+        let cancelled = Set(indexPaths)
+        pendingIndexPaths.removeAll { cancelled.contains($0) }
+        for indexPath in indexPaths {
+            prewarmedViews[indexPath] = nil
+        }
+        prewarmedOrder.removeAll { cancelled.contains($0) }
+    }
+
+    /// Releases all prewarmed views and stops prewarming.
+    func removeAll() {
+        pendingIndexPaths.removeAll()
+        prewarmedViews.removeAll()
+        prewarmedOrder.removeAll()
+    }
+
+    /// Returns the prewarmed views of the item if they can be attached to `view` for `arrangement`. Either way, the item's views are released.
+    func takeViews(at indexPath: IndexPath, for arrangement: LayoutArrangement, in view: UIView) -> PrewarmedViews? {
+        guard let views = prewarmedViews.removeValue(forKey: indexPath) else {
+            return nil
+        }
+        if let index = prewarmedOrder.firstIndex(of: indexPath) {
+            prewarmedOrder.remove(at: index)
+        }
+        return views.matches(arrangement, in: view) ? views : nil
+    }
+
+    /// Makes the views of pending items until `budget` seconds have passed. At least one item is prewarmed so that prewarming always progresses.
+    func prewarmPendingItems(within budget: CFTimeInterval) {
+        let deadline = clock() + budget
+        repeat {
+            guard !pendingIndexPaths.isEmpty else {
+                return
+            }
+            prewarm(pendingIndexPaths.removeFirst())
+        } while clock() < deadline
+    }
+
+    private func prewarm(_ indexPath: IndexPath) {
+        guard let arrangement = arrangementProvider(indexPath) else {
+            return
+        }
+        // Views are flipped within the bounds of the container, so it has the size of the cell.
+        let container = UIView(frame: CGRect(origin: .zero, size: arrangement.frame.size))
+        arrangement.makeViews(in: container)
+        prewarmedViews[indexPath] = PrewarmedViews(arrangement: arrangement, container: container)
+        prewarmedOrder.append(indexPath)
+        while prewarmedOrder.count > capacity {
+            prewarmedViews[prewarmedOrder.removeFirst()] = nil
+        }
+    }
+
+    private func scheduleIfNeeded() {
+        guard observer == nil, !pendingIndexPaths.isEmpty else {
+            return
+        }
+        // The run loop is idle when it is about to wait for events. Common modes include scrolling.
+        let observer = CFRunLoopObserverCreateWithHandler(kCFAllocatorDefault, CFRunLoopActivity.beforeWaiting.rawValue, true, 0) { [weak self] _, _ in
+            self?.runLoopWillWait()
+        }
+        CFRunLoopAddObserver(CFRunLoopGetMain(), observer, CFRunLoopMode.commonModes)
+        self.observer = observer
+    }
+
+    private func runLoopWillWait() {
+        prewarmPendingItems(within: frameBudget)
+        if pendingIndexPaths.isEmpty, let observer = observer {
+            CFRunLoopObserverInvalidate(observer)
+            self.observer = nil
+        }
+    }
+
+    /// Layouts that are objects are the same if they are identical. Value type layouts can't be compared.
+    static func isSameLayout(_ layout: Layout, _ otherLayout: Layout) -> Bool {
+        guard type(of: layout) is AnyClass else {
+            return false
+        }
+        return (layout as AnyObject) === (otherLayout as AnyObject)
+    }
+}
@@ -0,0 +1,213 @@
+// Copyright 2019 LinkedIn Corp.
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+
+import Foundation
+
+extension ArrangementSnapshot.Builder {
+
+    /// Appends the sections of an arrangement.
+    public mutating func append(_ arrangement: [Section<[LayoutArrangement]>]) {
+        for section in arrangement {
+            appendSection(header: section.header, items: section.items, footer: section.footer)
+        }
+    }
+}
+
+extension ArrangementSnapshot {
+
+    /**
+     Restores the arrangement of every header, item and footer for the layouts in `sections`.
+     Returns nil if the number of sections or items differs from the snapshot or if any layout doesn't match its frames.
+     */
+    public func arrangement<T: Collection, U>(of sections: T) -> [Section<[LayoutArrangement]>]? where U.Iterator.Element == Layout, T.Iterator.Element == Section<U> {
+        guard sections.count == sectionCount else {
+            return nil
+        }
+        var arrangement = [Section<[LayoutArrangement]>]()
+        arrangement.reserveCapacity(sectionCount)
+        for (sectionIndex, section) in sections.enumerated() {
+            guard section.items.count == itemCount(inSection: sectionIndex) else {
+                return nil
+            }
+            var header: LayoutArrangement?
+            if let headerLayout = section.header {
+                guard let restored = self.arrangement(of: headerLayout, forHeaderInSection: sectionIndex) else {
+                    return nil
+                }
+                header = restored
+            }
+            var footer: LayoutArrangement?
+            if let footerLayout = section.footer {
+                guard let restored = self.arrangement(of: footerLayout, forFooterInSection: sectionIndex) else {
+                    return nil
+                }
+                footer = restored
+            }
+            var items = [LayoutArrangement]()
+            items.reserveCapacity(section.items.count)
+            for (itemIndex, itemLayout) in section.items.enumerated() {
+                guard let restored = self.arrangement(of: itemLayout, forItem: itemIndex, inSection: sectionIndex) else {
+                    return nil
+                }
+                items.append(restored)
+            }
+            arrangement.append(Section(header: header, items: items, footer: footer))
+        }
+        return arrangement
+    }
+
+    /**
+     Restores the arrangements of every header and footer and of the items that are within `window` along `axis`,
+     assuming that headers, items and footers are stacked along the axis without spacing.
+
+     The other items are placeholders. Items before the window have their frames from the snapshot,
+     and items after it have the average size of the restored items, so that their frames and layouts are not read.
+     If `sections` has lazy items, only the layouts of the items within the window are evaluated.
+     Returns nil if the number of sections or items differs from the snapshot or if a restored layout doesn't match its frames.
+     */
+    func arrangement<T: Collection, U>(
+        of sections: T,
+        restoringItemsWithin window: ClosedRange<CGFloat>,
+        axis: Axis) -> [Section<[LayoutArrangement]>]? where U.Iterator.Element == Layout, T.Iterator.Element == Section<U> {
+
+        guard sections.count == sectionCount else {
+            return nil
+        }
+        var restoredSections = [(header: LayoutArrangement?, items: [LayoutArrangement?], footer: LayoutArrangement?)]()
+        restoredSections.reserveCapacity(sectionCount)
+        var offset: CGFloat = 0
+        for (sectionIndex, section) in sections.enumerated() {
+            guard section.items.count == itemCount(inSection: sectionIndex) else {
+                return nil
+            }
+            var header: LayoutArrangement?
+            if let headerLayout = section.header {
+                guard let restored = self.arrangement(of: headerLayout, forHeaderInSection: sectionIndex) else {
+                    return nil
+                }
+                header = restored
+                offset += AxisSize(axis: axis, size: restored.frame.size).axisLength
+            }
+            var items = [LayoutArrangement?]()
+            items.reserveCapacity(section.items.count)
+            for (itemIndex, index) in section.items.indices.enumerated() {
+                guard offset <= window.upperBound, let frame = self.frame(ofItem: itemIndex, inSection: sectionIndex) else {
+                    // Past the window, or corrupted. Either way, the background reload lays it out.
+                    items.append(nil)
+                    continue
+                }
+                let itemLength = AxisSize(axis: axis, size: frame.size).axisLength
+                if offset + itemLength < window.lowerBound {
+                    items.append(LayoutArrangement(layout: PlaceholderLayout(), frame: frame, sublayouts: []))
+                } else {
+                    guard let restored = self.arrangement(of: section.items[index], forItem: itemIndex, inSection: sectionIndex) else {
+                        return nil
+                    }
+                    items.append(restored)
+                }
+                offset += itemLength
+            }
+            var footer: LayoutArrangement?
+            if let footerLayout = section.footer {
+                guard let restored = self.arrangement(of: footerLayout, forFooterInSection: sectionIndex) else {
+                    return nil
+                }
+                footer = restored
+                offset += AxisSize(axis: axis, size: restored.frame.size).axisLength
+            }
+            restoredSections.append((header, items, footer))
+        }
+
+        let restoredItems = restoredSections.flatMap { $0.items.compactMap { $0 } }.filter { !($0.layout is PlaceholderLayout) }
+        let placeholderSize = restoredItems.isEmpty ? .zero : CGSize(
+            width: restoredItems.reduce(0) { $0 + $1.frame.width } / CGFloat(restoredItems.count),
+            height: restoredItems.reduce(0) { $0 + $1.frame.height } / CGFloat(restoredItems.count))
+        let placeholder = LayoutArrangement(layout: PlaceholderLayout(), frame: CGRect(origin: .zero, size: placeholderSize), sublayouts: [])
+        return restoredSections.map { section in
+            return Section(header: section.header, items: section.items.map { $0 ?? placeholder }, footer: section.footer)
+        }
+    }
+}
+
+// MARK: - Snapshots
+
+extension ReloadableViewLayoutAdapter {
+
+    /**
+     Makes a snapshot of the current arrangement and passes it to `completion` on the main thread,
+     or nil if the current arrangement wasn't arranged within the size of `key`.
+
+     The arrangements of evicted items (see `maxArrangedItemCount`) are recomputed and the snapshot is encoded in the background.
+     Persist the snapshot and pass it to `reload(width:height:restoringFrom:contentVersion:layoutProvider:completion:)` on the next launch.
+     It must be called on the main thread.
+     */
+    open func snapshotData(for key: ArrangementSnapshot.Key, completion: @escaping (Data?) -> Void) {
+        assert(Thread.isMainThread, "snapshotData must be called on the main thread")
+        guard currentArrangementSizeConstraint == ReloadableViewLayoutAdapter.sizeConstraint(width: key.width, height: key.height) else {
+            completion(nil)
+            return
+        }
+        let arrangement = currentArrangement
+        let itemLayoutProvider = self.itemLayoutProvider
+        let measurementCache = self.measurementCache
+        arrangementRestorationQueue.async {
+            var builder = ArrangementSnapshot.Builder(key: key)
+            builder.append(ReloadableViewLayoutAdapter.arrangementRestoringEvictedItems(arrangement,
+                                                                                         itemLayoutProvider: itemLayoutProvider,
+                                                                                         measurementCache: measurementCache))
+            let data = builder.data()
+            DispatchQueue.main.async {
+                completion(data)
+            }
+        }
+    }
+
+    /**
+     Shows the arrangement in `snapshot` immediately and then reloads in the background to reconcile it with a fresh layout.
+
+     The snapshot is only shown if its key matches `contentVersion`, `width` and `height`,
+     and if the layouts that `layoutProvider` returns match its frames (see `ArrangementSnapshot`).
+     To pair them, `layoutProvider` is called on the main thread before it is called again in the background.
+     Only the items within the visible bounds and `visibleItemsPrefetchFactor` times their length on each side are restored
+     on the main thread. The other items are placeholders until the background reload lays them out.
+     If `layoutProvider` returns lazy collections of items, only the layouts of the restored items are evaluated on the main thread.
+     Either way, the reload then proceeds like `reload(width:height:layoutProvider:completion:)`,
+     except that the items near the visible bounds aren't shown first when the snapshot was shown.
+
+     - returns: true if the snapshot was shown.
+     */
+    @discardableResult
+    open func reload<T: Collection, U>(
+        width: CGFloat? = nil,
+        height: CGFloat? = nil,
+        restoringFrom snapshot: ArrangementSnapshot,
+        contentVersion: String,
+        layoutProvider: @escaping () -> T,
+        completion: (() -> Void)? = nil) -> Bool where U.Iterator.Element == Layout, T.Iterator.Element == Section<U> {
+
+        assert(Thread.isMainThread, "reload must be called on the main thread")
+
+        var restored = false
+        if snapshot.key == ArrangementSnapshot.Key(contentVersion: contentVersion, width: width, height: height) {
+            // Items are stacked along the axis that is not constrained.
+            let axis: Axis = (width == nil && height != nil) ? .horizontal : .vertical
+            let bounds = reloadableView?.bounds ?? .zero
+            let origin = AxisPoint(axis: axis, point: bounds.origin).axisOffset
+            let length = AxisSize(axis: axis, size: bounds.size).axisLength
+            let margin = length * visibleItemsPrefetchFactor
+            let window = (origin - margin)...(origin + length + margin)
+            if let arrangement = snapshot.arrangement(of: layoutProvider(), restoringItemsWithin: window, axis: axis) {
+                reload(arrangement: arrangement)
+                restored = true
+            }
+        }
+        reload(width: width, height: height, synchronous: false, batchUpdates: nil,
+               showsVisibleItemsFirst: prioritizesVisibleItems && !restored, layoutProvider: layoutProvider, completion: completion)
+        return restored
+    }
+}
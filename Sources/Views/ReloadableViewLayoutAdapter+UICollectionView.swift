@@ -44,9 +44,8 @@ extension ReloadableViewLayoutAdapter: UICollectionViewDataSource {
 
     /// - Warning: Subclasses that override this method must call super
     open func collectionView(_ collectionView: UICollectionView, cellForItemAt indexPath: IndexPath) -> UICollectionViewCell {
-        let item = currentArrangement[indexPath.section].items[indexPath.item]
         let cell = collectionView.dequeueReusableCell(withReuseIdentifier: reuseIdentifier, for: indexPath)
-        item.makeViews(in: cell.contentView)
+        makeViews(ofItemAt: indexPath, in: cell.contentView)
         return cell
     }
 
@@ -71,9 +71,8 @@ extension ReloadableViewLayoutAdapter: UITableViewDataSource {
 
     /// - Warning: Subclasses that override this method must call super
     open func tableView(_ tableView: UITableView, cellForRowAt indexPath: IndexPath) -> UITableViewCell {
-        let item = currentArrangement[indexPath.section].items[indexPath.item]
         let cell = tableView.dequeueReusableCell(withIdentifier: reuseIdentifier, for: indexPath)
-        item.makeViews(in: cell.contentView)
+        makeViews(ofItemAt: indexPath, in: cell.contentView)
         return cell
     }
 }
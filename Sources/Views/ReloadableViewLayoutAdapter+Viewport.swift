@@ -0,0 +1,541 @@
+// Copyright 2019 LinkedIn Corp.
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+
+import UIKit
+
+// MARK: - Visible items first
+
+extension ReloadableViewLayoutAdapter {
+
+    /**
+     Lays out the items near the visible bounds of the reloadable view first and shows them
+     with placeholders of an estimated size for all of the other items.
+     The remaining items are then laid out in the background, nearest to the visible bounds first.
+     Whenever items that have scrolled into view are laid out, they replace their placeholders.
+     */
+    func reloadVisibleItemsFirst<T: Collection, U>(
+        width: CGFloat?,
+        height: CGFloat?,
+        layoutProvider: @escaping () -> T,
+        layoutFunc: @escaping (Layout) -> LayoutArrangement,
+        completion: (() -> Void)?) where U.Iterator.Element == Layout, T.Iterator.Element == Section<U> {
+
+        let start = CFAbsoluteTimeGetCurrent()
+        let operation = BlockOperation()
+
+        // Items are stacked along the axis that is not constrained.
+        let axis: Axis = (width == nil && height != nil) ? .horizontal : .vertical
+        let bounds = reloadableView?.bounds ?? .zero
+        let crossLength = (axis == .vertical ? width : height) ?? AxisSize(axis: axis, size: bounds.size).crossLength
+        let estimatedItemLength = estimatedItemSize.map({ AxisSize(axis: axis, size: $0).axisLength })
+            ?? ReloadableViewLayoutAdapter.averageItemLength(in: currentArrangement, axis: axis)
+        let prefetchFactor = visibleItemsPrefetchFactor
+        let layoutItemsConcurrently = self.layoutItemsConcurrently
+        let viewport = ViewportTracker(viewport: ReloadableViewLayoutAdapter.viewport(of: bounds, in: currentArrangement, axis: axis))
+        let updateManager = ViewportUpdateManager(delegate: self, operation: operation,
+                                                  sizeConstraint: ReloadableViewLayoutAdapter.sizeConstraint(width: width, height: height),
+                                                  axis: axis, viewport: viewport)
+
+        operation.addExecutionBlock { [weak operation, weak self] in
+            let isCancelled = { operation?.isCancelled ?? true }
+
+            let sectionLayouts = layoutProvider().map { Section(header: $0.header, items: Array($0.items), footer: $0.footer) }
+            let headers = sectionLayouts.map { $0.header.map(layoutFunc) }
+            let footers = sectionLayouts.map { $0.footer.map(layoutFunc) }
+
+            // The index path of every item, in order, so that items can be visited outwards from the visible bounds.
+            var indexPaths = [IndexPath]()
+            var sectionStartIndexes = [Int]()
+            for (sectionIndex, section) in sectionLayouts.enumerated() {
+                sectionStartIndexes.append(indexPaths.count)
+                indexPaths.append(contentsOf: section.items.indices.map { IndexPath(item: $0, section: sectionIndex) })
+            }
+
+            func sections(from items: [[LayoutArrangement]]) -> [Section<[LayoutArrangement]>] {
+                return items.indices.map { Section(header: headers[$0], items: items[$0], footer: footers[$0]) }
+            }
+
+            var items = sectionLayouts.map { [LayoutArrangement?](repeating: nil, count: $0.items.count) }
+            var remainingCount = indexPaths.count
+
+            // Without an estimate, the first item is representative of the others.
+            var itemLength = estimatedItemLength ?? 0
+            if estimatedItemLength == nil, let first = indexPaths.first {
+                if isCancelled() {
+                    return
+                }
+                let item = layoutFunc(sectionLayouts[first.section].items[first.item])
+                items[first.section][first.item] = item
+                remainingCount -= 1
+                itemLength = AxisSize(axis: axis, size: item.frame.size).axisLength
+            }
+            if itemLength <= 0 {
+                // The default row height of UITableView.
+                itemLength = 44
+            }
+            let placeholder = LayoutArrangement(
+                layout: PlaceholderLayout(),
+                frame: CGRect(origin: .zero, size: AxisSize(axis: axis, axisLength: itemLength, crossLength: crossLength).size),
+                sublayouts: [])
+
+            // The offsets of the current arrangement, which are updated as items replace their placeholders.
+            var offsets = StackedItemOffsets(headers: headers, itemCounts: items.map { $0.count }, footers: footers, itemLength: itemLength, axis: axis)
+            if estimatedItemLength == nil, let first = indexPaths.first, let item = items[first.section][first.item] {
+                offsets.setLength(of: item, at: first)
+            }
+
+            func layOut(_ indexPaths: [IndexPath]) -> Bool {
+                let layouts = indexPaths.map { sectionLayouts[$0.section].items[$0.item] }
+                var laidOut = [LayoutArrangement]()
+                if layoutItemsConcurrently {
+                    let completed = ReloadableViewLayoutAdapter.concurrentArrangements(of: layouts, layoutFunc: layoutFunc, isCancelled: isCancelled, batchCompleted: { batch in
+                        laidOut.append(contentsOf: batch)
+                    })
+                    if !completed {
+                        return false
+                    }
+                } else {
+                    for layout in layouts {
+                        if isCancelled() {
+                            return false
+                        }
+                        laidOut.append(layoutFunc(layout))
+                    }
+                }
+                for (indexPath, item) in zip(indexPaths, laidOut) {
+                    items[indexPath.section][indexPath.item] = item
+                    offsets.setLength(of: item, at: indexPath)
+                }
+                remainingCount -= laidOut.count
+                return true
+            }
+
+            func currentArrangement() -> [Section<[LayoutArrangement]>] {
+                return sections(from: items.map { $0.map { $0 ?? placeholder } })
+            }
+
+            // Items that are not laid out yet and are within the visible bounds plus the prefetch margin.
+            func missingVisibleIndexPaths(in viewport: Viewport) -> [IndexPath] {
+                let origin = offsets.origin(of: viewport)
+                let margin = viewport.length * prefetchFactor
+                let visibleIndexPaths = offsets.itemIndexPaths(from: origin - margin, to: origin + viewport.length + margin)
+                return visibleIndexPaths.filter { items[$0.section][$0.item] == nil }
+            }
+
+            // Show the visible items as soon as they are laid out.
+            guard layOut(missingVisibleIndexPaths(in: viewport.viewport)) else {
+                return
+            }
+            updateManager.apply(partialArrangement: currentArrangement(), offsets: offsets, insertedIndexPaths: [])
+
+            // Lay out the remaining items, visiting them outwards from the visible bounds.
+            var focusIndex: Int?
+            var lowerIndex = 0
+            var upperIndex = 0
+            while remainingCount > 0 {
+                if isCancelled() {
+                    return
+                }
+
+                // Sample the visible bounds so that the items that are scrolled to are laid out next.
+                viewport.scheduleSample(of: { [weak self] in self?.reloadableView })
+
+                let currentViewport = viewport.viewport
+                let missingVisible = missingVisibleIndexPaths(in: currentViewport)
+                if !missingVisible.isEmpty {
+                    guard layOut(missingVisible) else {
+                        return
+                    }
+                    updateManager.apply(partialArrangement: currentArrangement(), offsets: offsets, insertedIndexPaths: missingVisible)
+                    continue
+                }
+
+                let origin = offsets.origin(of: currentViewport)
+                let anchor = offsets.itemIndexPaths(from: origin, to: origin).first
+                let anchorIndex = anchor.map { sectionStartIndexes[$0.section] + $0.item } ?? 0
+                if anchorIndex != focusIndex {
+                    focusIndex = anchorIndex
+                    lowerIndex = anchorIndex - 1
+                    upperIndex = anchorIndex
+                }
+
+                var chunk = [IndexPath]()
+                while chunk.count < ReloadableViewLayoutAdapter.visibleItemsFirstChunkSize && (lowerIndex >= 0 || upperIndex < indexPaths.count) {
+                    if upperIndex < indexPaths.count {
+                        let indexPath = indexPaths[upperIndex]
+                        if items[indexPath.section][indexPath.item] == nil {
+                            chunk.append(indexPath)
+                        }
+                        upperIndex += 1
+                    }
+                    if lowerIndex >= 0 {
+                        let indexPath = indexPaths[lowerIndex]
+                        if items[indexPath.section][indexPath.item] == nil {
+                            chunk.append(indexPath)
+                        }
+                        lowerIndex -= 1
+                    }
+                }
+                if chunk.isEmpty {
+                    // Both cursors are exhausted, so this should not happen, but don't leave any item behind.
+                    chunk = indexPaths.filter { items[$0.section][$0.item] == nil }
+                }
+                guard layOut(chunk) else {
+                    return
+                }
+            }
+
+            let finalArrangement = sections(from: items.map { $0.map { $0! } })
+            updateManager.apply(finalArrangement: finalArrangement, batchUpdates: nil, completion: {
+                let end = CFAbsoluteTimeGetCurrent()
+                self?.logger?("user: \((end-start).ms)")
+                completion?()
+            })
+        }
+
+        backgroundLayoutQueue.addOperation(operation)
+    }
+
+    /// The average length of the items in the arrangement along the axis, or nil if there are no items.
+    static func averageItemLength(in arrangement: [Section<[LayoutArrangement]>], axis: Axis) -> CGFloat? {
+        var totalLength: CGFloat = 0
+        var count = 0
+        for section in arrangement {
+            for item in section.items where !(item.layout is PlaceholderLayout) {
+                totalLength += AxisSize(axis: axis, size: item.frame.size).axisLength
+                count += 1
+            }
+        }
+        return count > 0 ? totalLength / CGFloat(count) : nil
+    }
+
+    /**
+     Returns the index paths of the items that intersect the range of offsets along the axis.
+
+     Offsets assume that the headers, items and footers of all sections are stacked along the axis without spacing,
+     which is how UITableView and single column collection views present them.
+     */
+    static func itemIndexPaths(from minOffset: CGFloat, to maxOffset: CGFloat, in arrangement: [Section<[LayoutArrangement]>], axis: Axis) -> [IndexPath] {
+        var indexPaths = [IndexPath]()
+        var offset: CGFloat = 0
+        for (sectionIndex, section) in arrangement.enumerated() {
+            offset += length(of: section.header, axis: axis)
+            for (itemIndex, item) in section.items.enumerated() {
+                if offset > maxOffset {
+                    return indexPaths
+                }
+                let itemLength = length(of: item, axis: axis)
+                if offset + itemLength > minOffset {
+                    indexPaths.append(IndexPath(item: itemIndex, section: sectionIndex))
+                }
+                offset += itemLength
+            }
+            offset += length(of: section.footer, axis: axis)
+        }
+        return indexPaths
+    }
+
+    /// Returns the offset of the item along the axis, or nil if the arrangement doesn't contain the item.
+    static func offset(of indexPath: IndexPath, in arrangement: [Section<[LayoutArrangement]>], axis: Axis) -> CGFloat? {
+        guard indexPath.section < arrangement.count, indexPath.item < arrangement[indexPath.section].items.count else {
+            return nil
+        }
+        var offset: CGFloat = 0
+        for section in arrangement[0..<indexPath.section] {
+            offset += length(of: section.header, axis: axis)
+            offset += section.items.reduce(0) { $0 + length(of: $1, axis: axis) }
+            offset += length(of: section.footer, axis: axis)
+        }
+        let section = arrangement[indexPath.section]
+        offset += length(of: section.header, axis: axis)
+        offset += section.items[0..<indexPath.item].reduce(0) { $0 + length(of: $1, axis: axis) }
+        return offset
+    }
+
+    /// Describes the visible bounds relative to the item at the start of the bounds, so that it survives changes to the size of other items.
+    static func viewport(of bounds: CGRect, in arrangement: [Section<[LayoutArrangement]>], axis: Axis) -> Viewport {
+        let origin = AxisPoint(axis: axis, point: bounds.origin).axisOffset
+        let length = AxisSize(axis: axis, size: bounds.size).axisLength
+        guard let anchor = itemIndexPaths(from: origin, to: origin, in: arrangement, axis: axis).first,
+            let anchorOffset = offset(of: anchor, in: arrangement, axis: axis) else {
+            return Viewport(origin: origin, length: length, anchor: nil)
+        }
+        return Viewport(origin: origin, length: length, anchor: (anchor, origin - anchorOffset))
+    }
+
+    /// Returns the offset of the start of the viewport along the axis in the arrangement.
+    static func origin(of viewport: Viewport, in arrangement: [Section<[LayoutArrangement]>], axis: Axis) -> CGFloat {
+        guard let anchor = viewport.anchor, let anchorOffset = offset(of: anchor.indexPath, in: arrangement, axis: axis) else {
+            return viewport.origin
+        }
+        return anchorOffset + anchor.offset
+    }
+
+    private static func length(of arrangement: LayoutArrangement?, axis: Axis) -> CGFloat {
+        guard let arrangement = arrangement else {
+            return 0
+        }
+        return AxisSize(axis: axis, size: arrangement.frame.size).axisLength
+    }
+}
+
+/// The visible bounds of a reloadable view along its scrolling axis.
+struct Viewport {
+
+    /// The offset of the start of the visible bounds.
+    let origin: CGFloat
+
+    /// The length of the visible bounds.
+    let length: CGFloat
+
+    /// The item at the start of the visible bounds and the distance from the start of that item to the start of the visible bounds.
+    let anchor: (indexPath: IndexPath, offset: CGFloat)?
+}
+
+/**
+ The offsets of the headers, items and footers of sections that are stacked along an axis without spacing,
+ like `ReloadableViewLayoutAdapter.itemIndexPaths(from:to:in:axis:)` assumes.
+
+ Offsets are kept in an `OffsetIndex`, so changing the length of an item, finding the offset of an item
+ and finding the items at an offset are O(log n) instead of a walk over the arrangement.
+ */
+struct StackedItemOffsets {
+
+    let axis: Axis
+
+    /// The header, the items and the footer of each section, in order. Missing headers and footers have no length.
+    private var rows: OffsetIndex
+
+    /// The row of the header of each section, followed by the number of rows.
+    private let sectionStartRows: [Int]
+
+    init(headers: [LayoutArrangement?], itemCounts: [Int], footers: [LayoutArrangement?], itemLength: CGFloat, axis: Axis) {
+        var sectionStartRows = [Int]()
+        var rowCount = 0
+        for itemCount in itemCounts {
+            sectionStartRows.append(rowCount)
+            rowCount += itemCount + 2
+        }
+        sectionStartRows.append(rowCount)
+        self.axis = axis
+        self.sectionStartRows = sectionStartRows
+        rows = OffsetIndex(count: rowCount, length: itemLength, spacing: 0)
+        for section in itemCounts.indices {
+            rows.setLength(headers[section].map { AxisSize(axis: axis, size: $0.frame.size).axisLength } ?? 0, at: sectionStartRows[section])
+            rows.setLength(footers[section].map { AxisSize(axis: axis, size: $0.frame.size).axisLength } ?? 0, at: sectionStartRows[section + 1] - 1)
+        }
+    }
+
+    /// Sets the length of the item at the index path to the length of its arrangement.
+    mutating func setLength(of item: LayoutArrangement, at indexPath: IndexPath) {
+        rows.setLength(AxisSize(axis: axis, size: item.frame.size).axisLength, at: row(of: indexPath))
+    }
+
+    /// Returns the offset of the item, or nil if there is no such item.
+    func offset(of indexPath: IndexPath) -> CGFloat? {
+        guard indexPath.section < sectionStartRows.count - 1, indexPath.item < itemCount(inSection: indexPath.section) else {
+            return nil
+        }
+        return rows.offset(at: row(of: indexPath))
+    }
+
+    /// Returns the index paths of the items that intersect the range of offsets, like `ReloadableViewLayoutAdapter.itemIndexPaths(from:to:in:axis:)`.
+    func itemIndexPaths(from minOffset: CGFloat, to maxOffset: CGFloat) -> [IndexPath] {
+        var indexPaths = [IndexPath]()
+        guard rows.count > 0 else {
+            return indexPaths
+        }
+        var row = rows.index(at: minOffset)
+        var offset = rows.offset(at: row)
+        var section = self.section(ofRow: row)
+        while row < rows.count && offset <= maxOffset {
+            while row >= sectionStartRows[section + 1] {
+                section += 1
+            }
+            let length = rows.length(at: row)
+            let item = row - sectionStartRows[section] - 1
+            if item >= 0 && item < itemCount(inSection: section) && offset + length > minOffset {
+                indexPaths.append(IndexPath(item: item, section: section))
+            }
+            offset += length
+            row += 1
+        }
+        return indexPaths
+    }
+
+    /// Describes the bounds relative to the item at their start, like `ReloadableViewLayoutAdapter.viewport(of:in:axis:)`.
+    func viewport(of bounds: CGRect) -> Viewport {
+        let origin = AxisPoint(axis: axis, point: bounds.origin).axisOffset
+        let length = AxisSize(axis: axis, size: bounds.size).axisLength
+        guard let anchor = itemIndexPaths(from: origin, to: origin).first, let anchorOffset = offset(of: anchor) else {
+            return Viewport(origin: origin, length: length, anchor: nil)
+        }
+        return Viewport(origin: origin, length: length, anchor: (anchor, origin - anchorOffset))
+    }
+
+    /// Returns the offset of the start of the viewport, like `ReloadableViewLayoutAdapter.origin(of:in:axis:)`.
+    func origin(of viewport: Viewport) -> CGFloat {
+        guard let anchor = viewport.anchor, let anchorOffset = offset(of: anchor.indexPath) else {
+            return viewport.origin
+        }
+        return anchorOffset + anchor.offset
+    }
+
+    private func itemCount(inSection section: Int) -> Int {
+        return sectionStartRows[section + 1] - sectionStartRows[section] - 2
+    }
+
+    private func row(of indexPath: IndexPath) -> Int {
+        return sectionStartRows[indexPath.section] + 1 + indexPath.item
+    }
+
+    /// The section of the row, found by binary search.
+    private func section(ofRow row: Int) -> Int {
+        var lower = 0
+        var upper = sectionStartRows.count - 2
+        while lower < upper {
+            let middle = (lower + upper + 1) / 2
+            if sectionStartRows[middle] <= row {
+                lower = middle
+            } else {
+                upper = middle - 1
+            }
+        }
+        return lower
+    }
+}
+
+/// Holds the viewport of a reloadable view. It is written on the main thread and read on the background layout queue.
+final class ViewportTracker {
+
+    private let lock = NSLock()
+    private var _viewport: Viewport
+    private var isSampleScheduled = false
+
+    /// The offsets of the partial arrangement that the reloadable view shows, once it shows one. Only used on the main thread.
+    var shownOffsets: StackedItemOffsets?
+
+    init(viewport: Viewport) {
+        _viewport = viewport
+    }
+
+    /**
+     Samples the viewport from the bounds of the reloadable view on the main thread, unless a sample is already scheduled.
+     The bounds are located in `shownOffsets`, so sampling doesn't walk the arrangement.
+     */
+    func scheduleSample(of reloadableView: @escaping () -> ReloadableView?) {
+        lock.lock()
+        defer { lock.unlock() }
+        guard !isSampleScheduled else {
+            return
+        }
+        isSampleScheduled = true
+        DispatchQueue.main.async {
+            self.lock.lock()
+            self.isSampleScheduled = false
+            self.lock.unlock()
+            guard let bounds = reloadableView()?.bounds, let offsets = self.shownOffsets else {
+                return
+            }
+            self.viewport = offsets.viewport(of: bounds)
+        }
+    }
+
+    var viewport: Viewport {
+        get {
+            lock.lock()
+            defer { lock.unlock() }
+            return _viewport
+        }
+        set {
+            lock.lock()
+            defer { lock.unlock() }
+            _viewport = newValue
+        }
+    }
+}
+
+/**
+ Replaces the whole arrangement of the reloadable view each time more items are laid out,
+ keeping the item at the start of the visible bounds where it is.
+ */
+class ViewportUpdateManager: BaseReloadableViewUpdateManager, ReloadableViewUpdateManager {
+
+    private let axis: Axis
+    private let viewport: ViewportTracker
+    private var hasAppliedArrangement = false
+
+    init(delegate: ReloadableViewUpdateManagerDelegate, operation: Operation, sizeConstraint: CGSize, axis: Axis, viewport: ViewportTracker) {
+        self.axis = axis
+        self.viewport = viewport
+        super.init(delegate: delegate, operation: operation, sizeConstraint: sizeConstraint)
+    }
+
+    func apply(partialArrangement arrangement: [Section<[LayoutArrangement]>], insertedIndexPaths: [IndexPath]) {
+        apply(partialArrangement: arrangement, offsets: nil, insertedIndexPaths: insertedIndexPaths)
+    }
+
+    /// Shows a partial arrangement, unless the user is scrolling. Its offsets, if known, let the viewport be sampled without walking it.
+    func apply(partialArrangement arrangement: [Section<[LayoutArrangement]>], offsets: StackedItemOffsets?, insertedIndexPaths: [IndexPath]) {
+        updateReloadableView(waitUntilFinished: false) { (reloadableView: ReloadableView) in
+            // Don't move the content while the user is scrolling.
+            // The next partial arrangement or the final arrangement will include these items.
+            if self.hasAppliedArrangement && (reloadableView.isTracking || reloadableView.isDecelerating) {
+                self.metrics?.recordDeferredUpdate()
+                return
+            }
+            self.replaceArrangement(with: arrangement, offsets: offsets, reloadableView: reloadableView)
+        }
+    }
+
+    func apply(finalArrangement arrangement: [Section<[LayoutArrangement]>], batchUpdates: BatchUpdates?, completion: (() -> Void)?) {
+        updateReloadableView(waitUntilFinished: true) { (reloadableView: ReloadableView) in
+            self.replaceArrangement(with: arrangement, offsets: nil, reloadableView: reloadableView)
+            self.delegate?.currentArrangementSizeConstraint = self.sizeConstraint
+            completion?()
+        }
+    }
+
+    /// Replaces the arrangement. The offsets of the arrangements, if known, locate the visible item without walking the arrangements.
+    private func replaceArrangement(with arrangement: [Section<[LayoutArrangement]>], offsets: StackedItemOffsets?, reloadableView: ReloadableView) {
+        assert(Thread.isMainThread, "replaceArrangement must be called on the main thread")
+
+        guard let delegate = self.delegate else {
+            return
+        }
+
+        let viewport = self.viewport.shownOffsets?.viewport(of: reloadableView.bounds)
+            ?? ReloadableViewLayoutAdapter.viewport(of: reloadableView.bounds, in: delegate.currentArrangement, axis: axis)
+        delegate.currentArrangement = arrangement
+        self.viewport.shownOffsets = offsets
+        hasAppliedArrangement = true
+        reloadableView.reloadDataSynchronously()
+
+        guard let scrollView = reloadableView as? UIScrollView, viewport.anchor != nil else {
+            return
+        }
+        let origin = offsets?.origin(of: viewport) ?? ReloadableViewLayoutAdapter.origin(of: viewport, in: arrangement, axis: axis)
+        if origin == viewport.origin {
+            return
+        }
+        let contentLength = AxisSize(axis: axis, size: scrollView.contentSize).axisLength
+        let minOrigin = -AxisPoint(axis: axis, point: CGPoint(x: scrollView.contentInset.left, y: scrollView.contentInset.top)).axisOffset
+        let maxOrigin = contentLength - viewport.length + AxisPoint(axis: axis, point: CGPoint(x: scrollView.contentInset.right, y: scrollView.contentInset.bottom)).axisOffset
+        var contentOffset = AxisPoint(axis: axis, point: scrollView.contentOffset)
+        contentOffset.axisOffset = max(minOrigin, min(origin, maxOrigin))
+        scrollView.contentOffset = contentOffset.point
+    }
+}
+
+/// Stands in for an item that has not been laid out yet. It doesn't have a view.
+final class PlaceholderLayout: SizeLayout<View> {
+
+    init() {
+        super.init(minWidth: 0, maxWidth: 0, minHeight: 0, maxHeight: 0)
+    }
+}
@@ -15,14 +15,50 @@ import UIKit
  */
 open class ReloadableViewLayoutAdapter: NSObject, ReloadableViewUpdateManagerDelegate {
 
-    static let incrementalUpdateChunkSize = 16
-    static let incrementalUpdateChunkingThreshold = 4 * incrementalUpdateChunkSize
+    /// The number of consecutive items that a single core lays out when `layoutItemsConcurrently` is true.
+    static let concurrentLayoutChunkSize = 8
+
+    /// The number of items that are laid out between checks of the visible bounds when `prioritizesVisibleItems` is true.
+    static let visibleItemsFirstChunkSize = 64
+
+    /// The duration of a frame of the main screen. It must be read on the main thread.
+    static var frameInterval: CFTimeInterval {
+        if #available(iOS 10.3, tvOS 10.3, *) {
+            return 1 / CFTimeInterval(max(UIScreen.main.maximumFramesPerSecond, 1))
+        }
+        return 1.0 / 60
+    }
 
     let reuseIdentifier = String(describing: ReloadableViewLayoutAdapter.self)
 
-    /// The current layout arrangement.
+    /**
+     The current layout arrangement.
+     The items whose arrangements were evicted (see `maxArrangedItemCount`) only have their frames.
+     Use `isArrangementEvicted(ofItemAt:)` to tell them apart.
+     Must be accessed from the main thread only.
+     */
+    open internal(set) var currentArrangement = [Section<[LayoutArrangement]>]() {
+        didSet {
+            // The identities only describe the arrangement that a diffing reload applied.
+            currentIdentities = nil
+            // Whoever sets a complete arrangement sets the size that it was arranged within afterwards.
+            currentArrangementSizeConstraint = nil
+            needsFullArrangementEviction = true
+            scheduleArrangementEviction()
+        }
+    }
+
+    /// The identities of the items in the current arrangement if it was applied by `reloadDiffing`, otherwise nil.
     /// Must be accessed from the main thread only.
-    open internal(set) var currentArrangement = [Section<[LayoutArrangement]>]()
+    var currentIdentities: [SectionIdentity]?
+
+    /**
+     The size that the items of the current arrangement were arranged within,
+     or nil if it is unknown or if the current arrangement is a partial arrangement of a reload that is in progress.
+     It is set when a reload applies its final arrangement, not when the reload starts.
+     Must be accessed from the main thread only.
+     */
+    var currentArrangementSizeConstraint: CGSize?
 
     /// The queue that layouts are computed on.
     public let backgroundLayoutQueue: OperationQueue = {
@@ -40,9 +76,179 @@ open class ReloadableViewLayoutAdapter: NSObject, ReloadableViewUpdateManagerDel
     /// Logs messages.
     open var logger: ((String) -> Void)? = nil
 
+    /**
+     An optional cache of measurements that is shared by all reloads.
+     
+     When set, measurements of layouts that are equivalent to layouts measured by a previous reload at the same size
+     are reused instead of being recomputed (e.g. when reloading after a rotation back to a previous width).
+     */
+    open var measurementCache: LayoutMeasurementCache? = nil
+
+    /**
+     An optional profiler that records the time of every node of every layout that reloads lay out.
+
+     Profiling has a cost, so it should only be set while investigating slow layouts (see `LayoutProfiler`).
+     */
+    open var profiler: LayoutProfiler? = nil
+
+    /**
+     Receives the phase timings and counters of every reload (see `ReloadMetrics`).
+
+     Metrics are only collected while a delegate is set. `ReloadMetricsAggregator` aggregates them into histograms.
+     */
+    open weak var metricsDelegate: ReloadableViewLayoutAdapterMetricsDelegate? = nil
+
+    /// The metrics of the reload that is in progress, if they are collected.
+    /// Must be accessed from the main thread only.
+    var activeReloadMetrics: ReloadMetricsCollector?
+
+    /**
+     If true, the items of each section are laid out concurrently on all available cores instead of one at a time.
+
+     Layouts MUST be thread-safe, so this is safe for any layout, but the layout provider's layouts are retained
+     until the whole reload completes and completed arrangements are delivered in batches instead of one by one.
+     The operations on `backgroundLayoutQueue` are still serial, so cancellation works the same way as for serial layout.
+     Defaults to false.
+     */
+    open var layoutItemsConcurrently = false
+
+    /**
+     If true, asynchronous reloads without batch updates lay out the items near the visible bounds of the reloadable view first.
+
+     The reloadable view is shown as soon as those items are laid out, with placeholders of `estimatedItemSize` for all other items.
+     The remaining items are laid out in the background, nearest to the visible bounds first,
+     and they replace their placeholders as they scroll into view and when the reload completes.
+     The item at the start of the visible bounds is kept in place when placeholders are replaced.
+
+     Positions are estimated as if all items were stacked along the scrolling axis,
+     which is how UITableView and single column UICollectionViews present them.
+     Defaults to false.
+     */
+    open var prioritizesVisibleItems = false
+
+    /**
+     The size of items that have not been laid out yet when `prioritizesVisibleItems` is true.
+
+     If nil, the average size of the items in the current arrangement is used,
+     or the size of the first item if there is no current arrangement.
+     */
+    open var estimatedItemSize: CGSize? = nil
+
+    /// How far beyond the visible bounds items are laid out first when `prioritizesVisibleItems` is true,
+    /// as a multiple of the length of the visible bounds. Defaults to 1.
+    open var visibleItemsPrefetchFactor: CGFloat = 1
+
+    /**
+     If true, the views of items that the reloadable view prefetches are made while the main run loop is idle.
+     The cells of those items still recycle their own views, and take the prewarmed views instead of creating the views that they don't have.
+     This helps when cells are new or show items whose views differ, and costs extra views when cells are reused for similar items.
+
+     Prewarming takes at most `prewarmingFrameBudget` each time the main run loop is idle.
+     `LayoutAdapterCollectionView` and `LayoutAdapterTableView` set the adapter as their prefetch data source (iOS 10 and tvOS 10 or later).
+     Defaults to false.
+     */
+    open var prewarmsViews = false
+
+    /// The longest time that prewarming views may take each time the main run loop is idle. Defaults to 4 ms.
+    open var prewarmingFrameBudget: CFTimeInterval {
+        get {
+            return viewPrewarmer.frameBudget
+        }
+        set {
+            viewPrewarmer.frameBudget = newValue
+        }
+    }
+
+    /// Makes the views of prefetched items.
+    lazy var viewPrewarmer: ViewPrewarmer = {
+        let prewarmer = ViewPrewarmer(frameBudget: 0.004, capacity: 16)
+        prewarmer.arrangementProvider = { [weak self] indexPath in
+            return self?.itemArrangement(at: indexPath)
+        }
+        return prewarmer
+    }()
+
+    /**
+     The longest time that inserting the items of each partial update of an incremental reload should take on the main thread.
+
+     Incremental reloads measure how long items take to lay out and to insert, and insert them in chunks that are laid out
+     in about one frame but that can be inserted within this budget. Defaults to 8 ms.
+     */
+    open var incrementalUpdateFrameBudget: CFTimeInterval = 0.008
+
+    /// The current time for the flush schedulers of incremental reloads. Tests replace it to control the measured costs.
+    var incrementalUpdateClock: () -> CFTimeInterval = CFAbsoluteTimeGetCurrent
+
+    /**
+     How long `requestReload` waits for more requests before it lays out the latest one.
+     Requests that arrive within the window replace each other. Defaults to 50 ms.
+     */
+    open var reloadCoalescingInterval: TimeInterval = 0.05
+
+    /// The coalesced reloads that are waiting and laying out.
+    lazy var reloadCoalescer = ReloadCoalescer()
+
+    /**
+     The number of items whose full arrangement, with the frames of all of their sublayouts, the current arrangement keeps.
+
+     When there are more, the arrangements of the items farthest from the visible bounds are replaced by their frames,
+     which is all that the sizes of cells need. After a reload, items are evicted farthest first.
+     Afterwards, the least recently shown or restored items are evicted whenever the budget is exceeded.
+     Items near the visible bounds are never evicted.
+
+     Eviction releases the arrangement and the layout of each evicted item: `itemLayoutProvider` provides the layout again
+     when the item is restored. Evicted items are restored in the background when they are prefetched,
+     or right away if their cell is needed first. Restoring an item measures it again within the size
+     that the reload arranged it within, using `measurementCache` if it is set.
+
+     A memory warning evicts all items that are not near the visible bounds, whatever the budget.
+     If nil, or if `itemLayoutProvider` is nil, items are never evicted. Defaults to nil.
+     */
+    open var maxArrangedItemCount: Int? = nil {
+        didSet {
+            needsFullArrangementEviction = true
+            scheduleArrangementEviction()
+        }
+    }
+
+    /**
+     Returns the layout of the item at an index path of the current arrangement, like the layout provider of the last reload did.
+     It is needed to evict arrangements (see `maxArrangedItemCount`), since evicted items don't keep their layouts.
+     It is called on a background queue to restore prefetched items and on the main thread to restore items whose cells are needed first,
+     so it MUST be thread-safe.
+     It MUST NOT be set to nil while items are evicted. Defaults to nil.
+     */
+    open var itemLayoutProvider: ((IndexPath) -> Layout)? = nil
+
+    /// Whether an eviction of arrangements is scheduled on the main queue.
+    var isArrangementEvictionScheduled = false
+
+    /// Whether the current arrangement changed since the last pass over all of its items.
+    var needsFullArrangementEviction = false
+
+    /// The index paths of the items that have full arrangements, from the least to the most recently shown or restored.
+    var recentlyUsedItems = LRUCache<IndexPath, Void>(costLimit: Int.max)
+
+    /// The evicted layouts whose arrangements are being restored.
+    var restoringLayouts = Set<ObjectIdentifier>()
+
+    /// The queue that the arrangements of evicted items are restored on.
+    lazy var arrangementRestorationQueue = DispatchQueue(label: String(describing: ReloadableViewLayoutAdapter.self) + ".restoration", qos: .userInitiated)
+
     public init(reloadableView: ReloadableView) {
         self.reloadableView = reloadableView
+        super.init()
         reloadableView.registerViews(withReuseIdentifier: reuseIdentifier)
+        NotificationCenter.default.addObserver(self,
+                                               selector: #selector(handleMemoryWarning(_:)),
+                                               name: UIApplication.didReceiveMemoryWarningNotification,
+                                               object: nil)
+    }
+
+    deinit {
+        NotificationCenter.default.removeObserver(self)
+        // Coalesced reloads that are waiting or laying out can't finish without the adapter.
+        reloadCoalescer.cancelAll()
     }
 
     /**
@@ -52,6 +258,7 @@ open class ReloadableViewLayoutAdapter: NSObject, ReloadableViewUpdateManagerDel
      then it will incrementally insert cells into the reloadable view as layouts are computed
      to increase user perceived performance for large collections. Pass an empty `BatchUpdates` object
      if you wish to disable this optimization for an asynchronous reload of an empty collection.
+     If `prioritizesVisibleItems` is true, asynchronous reloads without batch updates show the visible items first instead.
 
      - parameter width: The width of the layout's arrangement. Nil means no constraint. Default is nil.
      - parameter height: The height of the layout's arrangement. Nil means no constraint. Default is nil.
@@ -68,32 +275,110 @@ open class ReloadableViewLayoutAdapter: NSObject, ReloadableViewUpdateManagerDel
         layoutProvider: @escaping () -> T,
         completion: (() -> Void)? = nil) where U.Iterator.Element == Layout, T.Iterator.Element == Section<U> {
 
+        reload(width: width, height: height, synchronous: synchronous, batchUpdates: batchUpdates,
+               showsVisibleItemsFirst: prioritizesVisibleItems, layoutProvider: layoutProvider, completion: completion)
+    }
+
+    /// Reloads like `reload(width:height:synchronous:batchUpdates:layoutProvider:completion:)`, but `showsVisibleItemsFirst` replaces `prioritizesVisibleItems`.
+    func reload<T: Collection, U>(
+        width: CGFloat?,
+        height: CGFloat?,
+        synchronous: Bool,
+        batchUpdates: BatchUpdates?,
+        showsVisibleItemsFirst: Bool,
+        layoutProvider: @escaping () -> T,
+        completion: (() -> Void)?) where U.Iterator.Element == Layout, T.Iterator.Element == Section<U> {
+
         assert(Thread.isMainThread, "reload must be called on the main thread")
 
         // All previous layouts are invalid.
+        let metrics = beginReloadMetrics(synchronous: synchronous)
+        interruptCoalescedReloads()
         backgroundLayoutQueue.cancelAllOperations()
+        let sizeConstraint = ReloadableViewLayoutAdapter.sizeConstraint(width: width, height: height)
 
-        let layoutFunc = { (layout: Layout) -> LayoutArrangement in
-            return layout.arrangement(width: width, height: height)
+        let layoutFunc = self.layoutFunc(width: width, height: height)
+        let measuredCompletion = self.completion(completion, completing: metrics)
+        var measuredLayoutProvider = layoutProvider
+        if let metrics = metrics {
+            measuredLayoutProvider = { metrics.measureLayoutProvider(layoutProvider) }
         }
 
         if synchronous {
-            reloadSynchronously(layoutProvider: layoutProvider, layoutFunc: layoutFunc, batchUpdates: batchUpdates, completion: completion)
+            reloadSynchronously(layoutProvider: measuredLayoutProvider, layoutFunc: layoutFunc, sizeConstraint: sizeConstraint, batchUpdates: batchUpdates, completion: measuredCompletion)
+        } else if showsVisibleItemsFirst && batchUpdates == nil {
+            reloadVisibleItemsFirst(width: width, height: height, layoutProvider: measuredLayoutProvider, layoutFunc: layoutFunc, completion: measuredCompletion)
         } else {
-            reloadAsynchronously(layoutProvider: layoutProvider, layoutFunc: layoutFunc, batchUpdates: batchUpdates, completion: completion)
+            reloadAsynchronously(layoutProvider: measuredLayoutProvider, layoutFunc: layoutFunc, sizeConstraint: sizeConstraint, batchUpdates: batchUpdates, completion: measuredCompletion)
         }
     }
 
+    /// Returns the function that arranges each layout of a reload. It is called on the background layout queue.
+    func layoutFunc(width: CGFloat?, height: CGFloat?) -> (Layout) -> LayoutArrangement {
+        let measurementCache = self.measurementCache
+        let cachedLayoutFunc = { (layout: Layout) -> LayoutArrangement in
+            if let carriedOver = layout as? CarriedOverLayout {
+                return carriedOver.arrangement
+            }
+            guard let measurementCache = measurementCache else {
+                return layout.arrangement(width: width, height: height)
+            }
+            return measurementCache.perform {
+                return layout.arrangement(width: width, height: height)
+            }
+        }
+        var layoutFunc = cachedLayoutFunc
+        if let profiler = profiler {
+            layoutFunc = { layout in
+                return profiler.perform {
+                    return cachedLayoutFunc(layout)
+                }
+            }
+        }
+        if let request = reloadCoalescer.starting {
+            // Counts the layouts of a coalesced reload, which are wasted if it is cancelled.
+            let uncountedLayoutFunc = layoutFunc
+            layoutFunc = { layout in
+                request.recordLayout()
+                return uncountedLayoutFunc(layout)
+            }
+        }
+        if let metrics = activeReloadMetrics {
+            let unmeasuredLayoutFunc = layoutFunc
+            layoutFunc = { layout in
+                let start = CFAbsoluteTimeGetCurrent()
+                let arrangement = unmeasuredLayoutFunc(layout)
+                metrics.recordLayout(duration: CFAbsoluteTimeGetCurrent() - start)
+                return arrangement
+            }
+        }
+        return layoutFunc
+    }
+
     private func reloadSynchronously<T: Collection, U>(
         layoutProvider: () -> T,
         layoutFunc: @escaping (Layout) -> LayoutArrangement,
+        sizeConstraint: CGSize,
         batchUpdates: BatchUpdates?,
         completion: (() -> Void)?) where U.Iterator.Element == Layout, T.Iterator.Element == Section<U> {
 
         let start = CFAbsoluteTimeGetCurrent()
-        currentArrangement = layoutProvider().map { sectionLayout in
-            return sectionLayout.map(layoutFunc)
+        if layoutItemsConcurrently {
+            currentArrangement = layoutProvider().map { sectionLayout in
+                let header = sectionLayout.header.map(layoutFunc)
+                let footer = sectionLayout.footer.map(layoutFunc)
+                var items = [LayoutArrangement]()
+                ReloadableViewLayoutAdapter.concurrentArrangements(of: Array(sectionLayout.items), layoutFunc: layoutFunc, isCancelled: { false }, batchCompleted: { batch in
+                    items.append(contentsOf: batch)
+                })
+                return Section(header: header, items: items, footer: footer)
+            }
+        } else {
+            currentArrangement = layoutProvider().map { sectionLayout in
+                return sectionLayout.map(layoutFunc)
+            }
         }
+        currentArrangementSizeConstraint = sizeConstraint
 
         let completionAndLogEnd = {
             let end = CFAbsoluteTimeGetCurrent()
@@ -101,29 +386,42 @@ open class ReloadableViewLayoutAdapter: NSObject, ReloadableViewUpdateManagerDel
             completion?()
         }
 
+        let updateStart = CFAbsoluteTimeGetCurrent()
         if let batchUpdates = batchUpdates {
             reloadableView?.perform(batchUpdates: batchUpdates, completion: completionAndLogEnd)
         } else {
             reloadableView?.reloadDataSynchronously()
             completionAndLogEnd()
         }
+        activeReloadMetrics?.recordMainThreadUpdate(duration: CFAbsoluteTimeGetCurrent() - updateStart)
     }
 
     private func reloadAsynchronously<T: Collection, U>(
         layoutProvider: @escaping () -> T,
         layoutFunc: @escaping (Layout) -> LayoutArrangement,
+        sizeConstraint: CGSize,
         batchUpdates: BatchUpdates?,
         completion: (() -> Void)?) where U.Iterator.Element == Layout, T.Iterator.Element == Section<U> {
 
         let start = CFAbsoluteTimeGetCurrent()
         let operation = BlockOperation()
+        let layoutItemsConcurrently = self.layoutItemsConcurrently
 
         // Only do incremental rendering if there is currently no data and if there are no batch updates.
         // Otherwise wait for layout to complete before updating the view.
         let incremental = currentArrangement.isEmpty && batchUpdates == nil
-        let updateManager: ReloadableViewUpdateManager = incremental ?
-            IncrementalUpdateManager(delegate: self, operation: operation) :
-            BatchUpdateManager(delegate: self, operation: operation)
+        let updateManager: ReloadableViewUpdateManager
+        let flushScheduler: IncrementalFlushScheduler?
+        if incremental {
+            let scheduler = IncrementalFlushScheduler(frameInterval: ReloadableViewLayoutAdapter.frameInterval,
+                                                      frameBudget: incrementalUpdateFrameBudget,
+                                                      clock: incrementalUpdateClock)
+            updateManager = IncrementalUpdateManager(delegate: self, operation: operation, sizeConstraint: sizeConstraint, flushScheduler: scheduler)
+            flushScheduler = scheduler
+        } else {
+            updateManager = BatchUpdateManager(delegate: self, operation: operation, sizeConstraint: sizeConstraint)
+            flushScheduler = nil
+        }
 
         operation.addExecutionBlock { [weak operation] in
 
@@ -152,19 +450,52 @@ open class ReloadableViewLayoutAdapter: NSObject, ReloadableViewUpdateManagerDel
                 var items = [LayoutArrangement]()
                 var insertedIndexPaths = [IndexPath]()
 
-                for (itemIndex, itemLayout) in sectionLayout.items.enumerated() {
-                    if operation?.isCancelled ?? true {
+                if layoutItemsConcurrently {
+                    var batchStart = flushScheduler?.clock() ?? 0
+                    let completed = ReloadableViewLayoutAdapter.concurrentArrangements(
+                        of: Array(sectionLayout.items),
+                        layoutFunc: layoutFunc,
+                        isCancelled: { operation?.isCancelled ?? true },
+                        batchCompleted: { batch in
+                            guard let flushScheduler = flushScheduler else {
+                                // Partial arrangements are only shown by incremental reloads.
+                                items.append(contentsOf: batch)
+                                return
+                            }
+                            let batchEnd = flushScheduler.clock()
+                            flushScheduler.recordLayout(itemCount: batch.count, duration: batchEnd - batchStart)
+                            batchStart = batchEnd
+
+                            let firstItemIndex = items.count
+                            items.append(contentsOf: batch)
+                            insertedIndexPaths += (firstItemIndex..<items.count).map { IndexPath(item: $0, section: sectionIndex) }
+
+                            if flushScheduler.shouldFlush() {
+                                applyPartialArrangement(header: header, items: items, footer: footer, pendingArrangement: pendingArrangement, insertedIndexPaths: insertedIndexPaths, updateManager: updateManager)
+                                insertedIndexPaths.removeAll()
+                            }
+                        })
+                    if !completed {
                         return
                     }
-
-                    items.append(layoutFunc(itemLayout))
-                    insertedIndexPaths.append(IndexPath(item: itemIndex, section: sectionIndex))
-
-                    if (itemIndex <= ReloadableViewLayoutAdapter.incrementalUpdateChunkingThreshold
-                        || itemIndex % ReloadableViewLayoutAdapter.incrementalUpdateChunkSize == 0)
-                    {
-                        applyPartialArrangement(header: header, items: items, footer: footer, pendingArrangement: pendingArrangement, insertedIndexPaths: insertedIndexPaths, updateManager: updateManager)
-                        insertedIndexPaths.removeAll()
+                } else {
+                    for (itemIndex, itemLayout) in sectionLayout.items.enumerated() {
+                        if operation?.isCancelled ?? true {
+                            return
+                        }
+
+                        guard let flushScheduler = flushScheduler else {
+                            // Partial arrangements are only shown by incremental reloads.
+                            items.append(layoutFunc(itemLayout))
+                            continue
+                        }
+                        items.append(flushScheduler.measureLayout { layoutFunc(itemLayout) })
+                        insertedIndexPaths.append(IndexPath(item: itemIndex, section: sectionIndex))
+
+                        if flushScheduler.shouldFlush() {
+                            applyPartialArrangement(header: header, items: items, footer: footer, pendingArrangement: pendingArrangement, insertedIndexPaths: insertedIndexPaths, updateManager: updateManager)
+                            insertedIndexPaths.removeAll()
+                        }
                     }
                 }
                 
@@ -185,6 +516,54 @@ open class ReloadableViewLayoutAdapter: NSObject, ReloadableViewUpdateManagerDel
         backgroundLayoutQueue.addOperation(operation)
     }
 
+    /**
+     Computes the arrangements of `layouts` concurrently and reports them in index order.
+
+     Items are laid out in batches that span all available cores. Each core lays out a contiguous chunk of a batch.
+     `batchCompleted` is called on the calling thread with the arrangements of each batch, in order.
+
+     - returns: false if layout was cancelled before all arrangements were computed.
+     */
+    @discardableResult
+    static func concurrentArrangements(
+        of layouts: [Layout],
+        layoutFunc: (Layout) -> LayoutArrangement,
+        isCancelled: () -> Bool,
+        batchCompleted: ([LayoutArrangement]) -> Void) -> Bool {
+
+        let chunkSize = concurrentLayoutChunkSize
+        let batchSize = chunkSize * max(1, ProcessInfo.processInfo.activeProcessorCount)
+        var batchStart = 0
+        while batchStart < layouts.count {
+            if isCancelled() {
+                return false
+            }
+            let batchEnd = min(batchStart + batchSize, layouts.count)
+            var arrangements = [LayoutArrangement?](repeating: nil, count: batchEnd - batchStart)
+            arrangements.withUnsafeMutableBufferPointer { (buffer: inout UnsafeMutableBufferPointer<LayoutArrangement?>) in
+                // Each iteration writes to a disjoint range of the buffer, so no synchronization is needed.
+                let buffer = buffer
+                let chunkCount = (buffer.count + chunkSize - 1) / chunkSize
+                DispatchQueue.concurrentPerform(iterations: chunkCount) { chunk in
+                    let chunkStart = chunk * chunkSize
+                    let chunkEnd = min(chunkStart + chunkSize, buffer.count)
+                    for index in chunkStart..<chunkEnd {
+                        if isCancelled() {
+                            return
+                        }
+                        buffer[index] = layoutFunc(layouts[batchStart + index])
+                    }
+                }
+            }
+            if isCancelled() {
+                return false
+            }
+            batchCompleted(arrangements.map { $0! })
+            batchStart = batchEnd
+        }
+        return true
+    }
+
     /**
      Reloads the view with a precomputed layout.
      It must be called on the main thread.
@@ -194,8 +573,11 @@ open class ReloadableViewLayoutAdapter: NSObject, ReloadableViewUpdateManagerDel
      */
     open func reload(arrangement: [Section<[LayoutArrangement]>]) {
         assert(Thread.isMainThread, "reload must be called on the main thread")
+        cancelActiveReloadMetrics()
+        interruptCoalescedReloads()
         backgroundLayoutQueue.cancelAllOperations()
         currentArrangement = arrangement
+        currentArrangementSizeConstraint = nil
         reloadableView?.reloadDataSynchronously()
     }
 }
@@ -12,6 +12,15 @@ import Foundation
 protocol ReloadableViewUpdateManagerDelegate: class {
     var reloadableView: ReloadableView? { get }
     var currentArrangement: [Section<[LayoutArrangement]>] { get set }
+
+    /// The size that the items of the current arrangement were arranged within. It is set after the final arrangement is applied.
+    var currentArrangementSizeConstraint: CGSize? { get set }
+
+    /// The metrics of the reload that is in progress, if they are collected.
+    var activeReloadMetrics: ReloadMetricsCollector? { get }
+
+    /// Called on the main thread when an update is skipped because the reloadable view was deallocated.
+    func reloadableViewWasDeallocated()
 }
 
 /// An object that manages updates for a ReloadableView and its data source.
@@ -25,10 +34,14 @@ protocol ReloadableViewUpdateManager {
     /// if the operation is cancelled or dellocated.
     var operation: Operation? { get }
 
+    /// The metrics of the reload that this update manager updates the view for, if they are collected.
+    var metrics: ReloadMetricsCollector? { get }
+
     /// Applies a partial arrangement to the delegate's reloadable view and data source.
     func apply(partialArrangement arrangement: [Section<[LayoutArrangement]>], insertedIndexPaths: [IndexPath])
 
-    /// Applies the final arrangement to the delegate's reloadable view and data source.
+    /// Applies the final arrangement to the delegate's reloadable view and data source,
+    /// together with the size that it was arranged within.
     func apply(finalArrangement arrangement: [Section<[LayoutArrangement]>], batchUpdates: BatchUpdates?, completion: (() -> Void)?)
 }
 
@@ -36,14 +49,30 @@ extension ReloadableViewUpdateManager {
 
     /// Applies the updates closure to the reloadable view on the main thread
     /// if the reloadable view has not beed deallocationed and if the operation is not cancelled.
-    func updateReloadableView(waitUntilFinished: Bool, updates: @escaping (_ reloadableView: ReloadableView) -> Void) {
+    /// The cleanup closure is called on the main thread afterwards, even if the updates closure is not.
+    func updateReloadableView(waitUntilFinished: Bool,
+                              cleanup: (() -> Void)? = nil,
+                              updates: @escaping (_ reloadableView: ReloadableView) -> Void) {
         let mainOperation = BlockOperation()
         mainOperation.addExecutionBlock {
+            defer {
+                cleanup?()
+            }
             let operationCancelled = self.operation?.isCancelled ?? true
-            guard !operationCancelled, let reloadableView = self.delegate?.reloadableView else {
+            guard !operationCancelled else {
+                return
+            }
+            guard let reloadableView = self.delegate?.reloadableView else {
+                self.delegate?.reloadableViewWasDeallocated()
                 return
             }
+            guard let metrics = self.metrics else {
+                updates(reloadableView)
+                return
+            }
+            let start = CFAbsoluteTimeGetCurrent()
             updates(reloadableView)
+            metrics.recordMainThreadUpdate(duration: CFAbsoluteTimeGetCurrent() - start)
         }
         OperationQueue.main.addOperations([mainOperation], waitUntilFinished: waitUntilFinished)
     }
@@ -53,36 +82,58 @@ extension ReloadableViewUpdateManager {
 class BaseReloadableViewUpdateManager {
     weak var delegate: ReloadableViewUpdateManagerDelegate?
     weak var operation: Operation?
+    let metrics: ReloadMetricsCollector?
+
+    /// The size that the reload arranges its items within.
+    let sizeConstraint: CGSize
 
-    init(delegate: ReloadableViewUpdateManagerDelegate, operation: Operation) {
+    init(delegate: ReloadableViewUpdateManagerDelegate, operation: Operation, sizeConstraint: CGSize) {
         self.delegate = delegate
         self.operation = operation
+        self.sizeConstraint = sizeConstraint
+        self.metrics = delegate.activeReloadMetrics
     }
 }
 
 /// Updates the `ReloadableView` incrementally as items are inserted.
 class IncrementalUpdateManager: BaseReloadableViewUpdateManager, ReloadableViewUpdateManager {
 
+    /// Decides when the reload flushes partial arrangements and learns how long inserting them takes.
+    let flushScheduler: IncrementalFlushScheduler
+
     private var pendingInsertedIndexPaths = [IndexPath]()
 
+    init(delegate: ReloadableViewUpdateManagerDelegate, operation: Operation, sizeConstraint: CGSize, flushScheduler: IncrementalFlushScheduler) {
+        self.flushScheduler = flushScheduler
+        super.init(delegate: delegate, operation: operation, sizeConstraint: sizeConstraint)
+    }
+
     func apply(partialArrangement arrangement: [Section<[LayoutArrangement]>], insertedIndexPaths: [IndexPath]) {
-        updateReloadableView(waitUntilFinished: false) { (reloadableView: ReloadableView) in
+        flushScheduler.flushWillStart()
+        var viewIsMoving = false
+        updateReloadableView(waitUntilFinished: false, cleanup: {
+            // The flush ends even if it is skipped because the reload was cancelled or the view was deallocated.
+            self.flushScheduler.flushDidEnd(viewIsMoving: viewIsMoving)
+        }, updates: { (reloadableView: ReloadableView) in
             self.pendingInsertedIndexPaths += insertedIndexPaths
 
             // Don't modify the data while the view is moving.
             // Doing so causes weird artifacts (i.e. "bouncing" breaks).
-            // We will try again on the next loop iteration or when the final arrangement is applied.
+            // We will try again on a later flush or when the final arrangement is applied.
             if reloadableView.isTracking || reloadableView.isDecelerating {
+                self.metrics?.recordDeferredUpdate()
+                viewIsMoving = true
                 return
             }
 
             self.flushPendingInserts(arrangement: arrangement, reloadableView: reloadableView)
-        }
+        })
     }
 
     func apply(finalArrangement arrangement: [Section<[LayoutArrangement]>], batchUpdates: BatchUpdates?, completion: (() -> Void)?) {
         updateReloadableView(waitUntilFinished: true) { (reloadableView: ReloadableView) in
             self.flushPendingInserts(arrangement: arrangement, reloadableView: reloadableView)
+            self.delegate?.currentArrangementSizeConstraint = self.sizeConstraint
             completion?()
         }
     }
@@ -94,6 +145,7 @@ class IncrementalUpdateManager: BaseReloadableViewUpdateManager, ReloadableViewU
             return
         }
 
+        let start = flushScheduler.clock()
         let oldArrangement = delegate.currentArrangement
         delegate.currentArrangement = arrangement
 
@@ -113,14 +165,165 @@ class IncrementalUpdateManager: BaseReloadableViewUpdateManager, ReloadableViewU
             }
             reloadableView.perform(batchUpdates: batchUpdates, completion: nil)
         }
+        flushScheduler.recordInsert(itemCount: pendingInsertedIndexPaths.count, duration: flushScheduler.clock() - start)
 
         pendingInsertedIndexPaths.removeAll(keepingCapacity: true)
     }
 }
 
+/**
+ Decides when an incremental reload flushes the items that it has laid out to the reloadable view.
+
+ Each flush inserts items on the main thread, so flushing a fixed number of items drops frames when items are expensive to insert
+ and delays content when items are expensive to lay out. The scheduler measures the average time that it takes
+ to lay out an item (on the layout queue) and to insert an item (on the main thread), and then:
+
+ - It flushes the first item as soon as it is laid out, so that content appears as early as possible.
+ - It flushes the number of items that are laid out in `frameInterval`, so that the main thread gets at most about one flush per frame,
+   but no more items than can be inserted within `frameBudget`.
+ - It doesn't flush while the previous flush is waiting for the main thread, so a busy main thread gets fewer, larger flushes.
+ - While the view is moving, flushes are deferred, so it only flushes every `movingFlushInterval` to check whether the view stopped.
+
+ `measureLayout`, `recordLayout`, `shouldFlush` and `flushWillStart` are called on the layout queue, the others on the main thread.
+ */
+final class IncrementalFlushScheduler {
+
+    /// The duration of a frame.
+    let frameInterval: CFTimeInterval
+
+    /// The longest time that inserting the items of a flush should take on the main thread.
+    let frameBudget: CFTimeInterval
+
+    /// How often deferred flushes are retried while the view is moving.
+    let movingFlushInterval: CFTimeInterval
+
+    /// The current time. Tests replace it to control the measured costs.
+    let clock: () -> CFTimeInterval
+
+    /// The weight of each new cost in the moving averages.
+    private static let smoothing = 0.25
+
+    private let lock = NSLock()
+    private var layoutCost: CFTimeInterval?
+    private var insertCost: CFTimeInterval?
+    private var unflushedItemCount = 0
+    private var hasFlushed = false
+    private var pendingFlushCount = 0
+    private var isViewMoving = false
+    private var lastFlushTime: CFTimeInterval = 0
+
+    init(frameInterval: CFTimeInterval,
+         frameBudget: CFTimeInterval,
+         movingFlushInterval: CFTimeInterval = 0.1,
+         clock: @escaping () -> CFTimeInterval = CFAbsoluteTimeGetCurrent) {
+
+        self.frameInterval = frameInterval
+        self.frameBudget = frameBudget
+        self.movingFlushInterval = movingFlushInterval
+        self.clock = clock
+    }
+
+    /// The number of items that are flushed together once the first item has been flushed.
+    var chunkSize: Int {
+        lock.lock()
+        defer {
+            lock.unlock()
+        }
+        return lockedChunkSize
+    }
+
+    private var lockedChunkSize: Int {
+        let itemsPerFrame = layoutCost.map { IncrementalFlushScheduler.count(within: frameInterval, cost: $0) } ?? 1
+        let itemsWithinBudget = insertCost.map { IncrementalFlushScheduler.count(within: frameBudget, cost: $0) } ?? Int.max
+        return max(1, min(itemsPerFrame, itemsWithinBudget))
+    }
+
+    private static func count(within duration: CFTimeInterval, cost: CFTimeInterval) -> Int {
+        guard cost > 0 else {
+            return Int.max
+        }
+        return Int(min(duration / cost, Double(Int32.max)))
+    }
+
+    /// Lays out an item with `body` and records how long it took.
+    func measureLayout<Result>(_ body: () -> Result) -> Result {
+        let start = clock()
+        let result = body()
+        recordLayout(itemCount: 1, duration: clock() - start)
+        return result
+    }
+
+    /// Records that `itemCount` items were laid out in `duration`, e.g. by a batch of concurrent layouts.
+    func recordLayout(itemCount: Int, duration: CFTimeInterval) {
+        guard itemCount > 0 else {
+            return
+        }
+        lock.lock()
+        layoutCost = IncrementalFlushScheduler.average(layoutCost, duration / Double(itemCount))
+        unflushedItemCount += itemCount
+        lock.unlock()
+    }
+
+    /// Whether the items that were laid out since the last flush should be flushed now.
+    func shouldFlush() -> Bool {
+        lock.lock()
+        defer {
+            lock.unlock()
+        }
+        guard unflushedItemCount > 0 && pendingFlushCount == 0 else {
+            return false
+        }
+        guard hasFlushed else {
+            return true
+        }
+        if isViewMoving {
+            return clock() - lastFlushTime >= movingFlushInterval
+        }
+        return unflushedItemCount >= lockedChunkSize
+    }
+
+    /// Records that a flush was sent to the main thread.
+    func flushWillStart() {
+        lock.lock()
+        hasFlushed = true
+        pendingFlushCount += 1
+        unflushedItemCount = 0
+        lastFlushTime = clock()
+        lock.unlock()
+    }
+
+    /// Records that a flush ran on the main thread, and whether it was deferred because the view is moving.
+    func flushDidEnd(viewIsMoving: Bool) {
+        lock.lock()
+        pendingFlushCount -= 1
+        isViewMoving = viewIsMoving
+        lock.unlock()
+    }
+
+    /// Records how long inserting items into the reloadable view took.
+    func recordInsert(itemCount: Int, duration: CFTimeInterval) {
+        guard itemCount > 0 else {
+            return
+        }
+        lock.lock()
+        insertCost = IncrementalFlushScheduler.average(insertCost, duration / Double(itemCount))
+        lock.unlock()
+    }
+
+    private static func average(_ average: CFTimeInterval?, _ sample: CFTimeInterval) -> CFTimeInterval {
+        guard let average = average else {
+            return sample
+        }
+        return average + (sample - average) * smoothing
+    }
+}
+
 /// Only updates the `ReloadableView` with the final arrangement.
 class BatchUpdateManager: BaseReloadableViewUpdateManager, ReloadableViewUpdateManager {
 
+    /// Called on the main thread after the final arrangement is set on the delegate, before the reloadable view is updated.
+    var didApplyFinalArrangement: (() -> Void)?
+
     func apply(partialArrangement arrangement: [Section<[LayoutArrangement]>], insertedIndexPaths: [IndexPath]) {
         // Nothing to do here. This update strategy ignores partial arrangements.
     }
@@ -136,6 +339,8 @@ class BatchUpdateManager: BaseReloadableViewUpdateManager, ReloadableViewUpdateM
 
             // Perform the update.
             delegate.currentArrangement = arrangement
+            delegate.currentArrangementSizeConstraint = self.sizeConstraint
+            self.didApplyFinalArrangement?()
             if canBatchUpdate, let batchUpdates = batchUpdates {
                 reloadableView.perform(batchUpdates: batchUpdates, completion: completion)
             } else {
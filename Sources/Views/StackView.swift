@@ -19,6 +19,9 @@ import UIKit
  Unlike UIStackView, if you position StackView with Auto Layout, you must call invalidateIntrinsicContentSize on that StackView
  whenever any of its subviews' intrinsic content sizes change (e.g. changing the text of a UILabel that is positioned by the StackView).
  Otherwise, Auto Layout won't recompute the layout of the StackView.
+
+ StackView keeps the layout of its arranged subviews until they are added or removed.
+ It measures the subviews every time it is measured or laid out, so setNeedsLayout picks up changes to their sizes.
  
  Subviews MUST implement sizeThatFits so StackView can allocate space correctly.
  If a subview uses Auto Layout, then the subview may implement sizeThatFits by calling systemLayoutSizeFittingSize.
@@ -48,6 +51,9 @@ open class StackView: UIView {
 
     private var arrangedSubviews: [UIView] = []
 
+    /// The layout of the arranged subviews. It is nil until it is needed after the arranged subviews change.
+    private var cachedStackLayout: Layout?
+
     public init(axis: Axis,
                 spacing: CGFloat = 0,
                 distribution: StackLayoutDistribution = .leading,
@@ -76,6 +82,7 @@ open class StackView: UIView {
      */
     open func addArrangedSubviews(_ subviews: [UIView]) {
         arrangedSubviews.append(contentsOf: subviews)
+        cachedStackLayout = nil
         for subview in subviews {
             addSubview(subview)
         }
@@ -91,6 +98,7 @@ open class StackView: UIView {
             subview.removeFromSuperview()
         }
         arrangedSubviews.removeAll()
+        cachedStackLayout = nil
         invalidateIntrinsicContentSize()
         setNeedsLayout()
     }
@@ -108,6 +116,15 @@ open class StackView: UIView {
     }
 
     private var stackLayout: Layout {
+        if let stackLayout = cachedStackLayout {
+            return stackLayout
+        }
+        let stackLayout = makeStackLayout()
+        cachedStackLayout = stackLayout
+        return stackLayout
+    }
+
+    private func makeStackLayout() -> Layout {
         let sublayouts = arrangedSubviews.map { view -> Layout in
             return ViewLayout(view: view)
         }
@@ -0,0 +1,130 @@
+// Copyright 2019 LinkedIn Corp.
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+
+import UIKit
+
+/**
+ A scroll view that shows a `VirtualListLayout` and only creates views for the items that are near its bounds.
+
+ As it scrolls, the items within `overscan` points of the bounds along the list's axis are arranged on the main thread
+ and their views are made. The views of the items that move out of that window are hidden and reused for the items that move into it.
+
+ The list fills the width (or height, for horizontal lists) of the scroll view.
+ When rows of estimated size are measured, the content offset is adjusted so that the first visible item doesn't move.
+ */
+open class VirtualListView: UIScrollView {
+
+    /// The list. Setting it removes the views of the items of the previous list.
+    open var layout: VirtualListLayout? {
+        didSet {
+            for view in itemViews.values {
+                view.removeFromSuperview()
+            }
+            for view in reusableItemViews {
+                view.removeFromSuperview()
+            }
+            itemViews = [:]
+            itemFrames = [:]
+            reusableItemViews = []
+            setNeedsLayout()
+        }
+    }
+
+    /// The distance in points beyond each edge of the bounds along the list's axis within which items are shown ahead of time.
+    open var overscan: CGFloat = 200 {
+        didSet {
+            setNeedsLayout()
+        }
+    }
+
+    /// The natural direction of the item layouts. See `LayoutArrangement.makeViews(in:direction:)`.
+    open var direction: UserInterfaceLayoutDirection = .leftToRight
+
+    /// The containers of the views of the items in the window, by item index.
+    private var itemViews = [Int: UIView]()
+
+    /// The frames that the items in `itemViews` were arranged at.
+    private var itemFrames = [Int: CGRect]()
+
+    /// Hidden containers that are reused for items that move into the window.
+    private var reusableItemViews = [UIView]()
+
+    /// The indexes of the items that have views.
+    open var indexesOfItemsWithViews: [Int] {
+        return itemViews.keys.sorted()
+    }
+
+    open override func layoutSubviews() {
+        super.layoutSubviews()
+        guard let layout = layout else {
+            return
+        }
+        // Item frames only depend on the cross length of the list, which is the cross length of the bounds,
+        // so the list is measured once, after the rows in the window have been measured.
+        let crossLength = AxisSize(axis: layout.axis, size: bounds.size).crossLength
+        let unmeasuredSize = AxisSize(axis: layout.axis, axisLength: 0, crossLength: crossLength).size
+
+        // Remembers where the first visible item is so that measuring rows above it doesn't move it.
+        let anchorIndex = layout.itemIndexes(in: bounds, size: unmeasuredSize).first
+        let anchorOrigin = anchorIndex.map { layout.frame(ofItem: $0, size: unmeasuredSize).origin }
+
+        let window: CGRect
+        switch layout.axis {
+        case .vertical:
+            window = bounds.insetBy(dx: 0, dy: -overscan)
+        case .horizontal:
+            window = bounds.insetBy(dx: -overscan, dy: 0)
+        }
+        let items = layout.itemFrames(in: window, size: unmeasuredSize)
+        let maxSize = AxisSize(axis: layout.axis, axisLength: .greatestFiniteMagnitude, crossLength: crossLength).size
+        let size = layout.measurement(within: maxSize).size
+        contentSize = size
+
+        var itemViews = [Int: UIView]()
+        var itemFrames = [Int: CGRect]()
+        for item in items {
+            let existingView = self.itemViews.removeValue(forKey: item.index)
+            if let view = existingView, self.itemFrames[item.index] == item.frame {
+                itemViews[item.index] = view
+                itemFrames[item.index] = item.frame
+                continue
+            }
+            let view = existingView ?? dequeueItemView()
+            view.frame = item.frame
+            layout.arrangement(ofItem: item.index, in: item.frame).makeViews(in: view, direction: direction)
+            itemViews[item.index] = view
+            itemFrames[item.index] = item.frame
+        }
+        for view in self.itemViews.values {
+            view.isHidden = true
+            reusableItemViews.append(view)
+        }
+        self.itemViews = itemViews
+        self.itemFrames = itemFrames
+
+        if let anchorIndex = anchorIndex, let anchorOrigin = anchorOrigin {
+            let origin = layout.frame(ofItem: anchorIndex, size: size).origin
+            let delta = AxisPoint(axis: layout.axis, point: origin).axisOffset - AxisPoint(axis: layout.axis, point: anchorOrigin).axisOffset
+            if delta != 0 {
+                var offset = AxisPoint(axis: layout.axis, point: contentOffset)
+                offset.axisOffset += delta
+                contentOffset = offset.point
+            }
+        }
+    }
+
+    private func dequeueItemView() -> UIView {
+        if let view = reusableItemViews.popLast() {
+            view.isHidden = false
+            return view
+        }
+        let view = UIView()
+        addSubview(view)
+        return view
+    }
+}